@@ -3,7 +3,15 @@
 
 #include "li_iterator.h"
 #include "li_type_traits.h"
+#include "li_pair.h"
+#include "li_utility.h"
+#include "li_alloc.h"
+#include "li_construct.h"
+#include "li_functional.h"
+#include "li_heap.h"
+#include "li_simd.h"
 #include "string.h"
+
 namespace LI {
     // 算法
 
@@ -45,7 +53,9 @@ namespace LI {
     // 有 trivial assignment operator
     template <class T>
     inline T* __copy_t(const T* first, const T* last, T* result, __true_type) {
-        memmove(result, first, sizeof(T) * (last - first));
+        if (first != last) { // 空区间时指针可能为空, 不能交给 memmove
+            memmove(result, first, sizeof(T) * (last - first));
+        }
         return result + (last - first);
     }
     // 有 non-trivial assignment operator
@@ -98,8 +108,8 @@ namespace LI {
     template <class BidirectionalIterator1, class BidirectionalIterator2>
     inline BidirectionalIterator2 __copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result, bidirectional_iterator_tag) {
         // 需要判断迭代器等同与否, 决定循环是否继续, 速度慢
-        for ( ; last != first; --result) {
-            *result = *(--last);
+        while (last != first) {
+            *(--result) = *(--last);
         }
         return result;
     }
@@ -111,8 +121,8 @@ namespace LI {
     template <class RandomAccessIterator, class OutputIterator, class Distance>
     inline OutputIterator __copy_d_backward(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result, Distance*) {
         // 以 n 决定 循环的执行次数, 速度快
-        for (Distance n = last - first; n > 0; --n, --result) {
-            *result = *(--last);
+        for (Distance n = last - first; n > 0; --n) {
+            *(--result) = *(--last);
         }
         return result;
     }
@@ -165,6 +175,16 @@ namespace LI {
             *first = value;
         }
     }
+    // 特殊版本 单字节类型直接调用 memset
+    inline void fill(char* first, char* last, const char& value) {
+        memset(first, static_cast<unsigned char>(value), last - first);
+    }
+    inline void fill(signed char* first, signed char* last, const signed char& value) {
+        memset(first, static_cast<unsigned char>(value), last - first);
+    }
+    inline void fill(unsigned char* first, unsigned char* last, const unsigned char& value) {
+        memset(first, value, last - first);
+    }
 
     // fill_n 算法 ----------------
     template <class ForwardIterator, class Size, class T>
@@ -176,7 +196,1824 @@ namespace LI {
     }
 
 
+    // lower_bound 算法 -----------------------------------------------
+    // 在已排序区间 [first, last) 中找到第一个 "不小于 value" 的位置
+
+    // forward_iterator 版本
+    template <class ForwardIterator, class T, class Distance>
+    ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last, const T& value, Distance*, forward_iterator_tag) {
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (*middle < value) {
+                first = middle;
+                ++first;
+                len = len - half - 1; // 右半段, 不含 middle
+            }
+            else {
+                len = half; // 左半段
+            }
+        }
+        return first;
+    }
+    // RandomAccessIterator 版本
+    template <class RandomAccessIterator, class T, class Distance>
+    RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Distance*, random_access_iterator_tag) {
+        Distance len = last - first;
+        Distance half;
+        RandomAccessIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first + half;
+            if (*middle < value) {
+                first = middle + 1;
+                len = len - half - 1;
+            }
+            else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    // 无分支版本, 用于连续存放的算术型别
+    // 每轮只根据比较结果选择 base 或 base + half (编译为条件传送 cmov), 没有难以预测的分支
+    // 区间长度每轮按固定规律缩小, 所以下一轮的两个候选中点在本轮就已知, 可以同时预取
+    template <class RandomAccessIterator, class T>
+    RandomAccessIterator __lower_bound_branchless(RandomAccessIterator first, RandomAccessIterator last, const T& value) {
+        ptrdiff_t len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            ptrdiff_t half = len >> 1;
+            ptrdiff_t next_half = (len - half) >> 1;
+            __LI_PREFETCH(first + next_half);
+            __LI_PREFETCH(first + half + next_half);
+            first = (first[half] < value) ? first + half : first;
+            len -= half;
+        }
+        return first + (*first < value);
+    }
+
+    template <class RandomAccessIterator, class T>
+    inline RandomAccessIterator __lower_bound_t(RandomAccessIterator first, RandomAccessIterator last, const T& value, __true_type) {
+        return __lower_bound_branchless(first, last, value);
+    }
+    template <class RandomAccessIterator, class T>
+    inline RandomAccessIterator __lower_bound_t(RandomAccessIterator first, RandomAccessIterator last, const T& value, __false_type) {
+        return __lower_bound(first, last, value, (ptrdiff_t*) 0, random_access_iterator_tag());
+    }
+
+    template <class ForwardIterator, class T>
+    struct __lower_bound_dispatch {
+        ForwardIterator operator()(ForwardIterator first, ForwardIterator last, const T& value) {
+            return __lower_bound(first, last, value, distance_type(first), iterator_category(first));
+        }
+    };
+    // 偏特化版本 原生指针 且 value 与元素同型别
+    template <class T>
+    struct __lower_bound_dispatch<T*, T> {
+        T* operator()(T* first, T* last, const T& value) {
+            typedef typename __is_arithmetic<T>::is_arithmetic t;
+            return __lower_bound_t(first, last, value, t());
+        }
+    };
+    template <class T>
+    struct __lower_bound_dispatch<const T*, T> {
+        const T* operator()(const T* first, const T* last, const T& value) {
+            typedef typename __is_arithmetic<T>::is_arithmetic t;
+            return __lower_bound_t(first, last, value, t());
+        }
+    };
+
+    template <class ForwardIterator, class T>
+    inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value) {
+        return __lower_bound_dispatch<ForwardIterator, T>()(first, last, value);
+    }
+
+    // 自定义比较准则的版本
+    template <class ForwardIterator, class T, class Compare, class Distance>
+    ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last, const T& value, Compare comp, Distance*, forward_iterator_tag) {
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (comp(*middle, value)) {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+            else {
+                len = half;
+            }
+        }
+        return first;
+    }
+    template <class RandomAccessIterator, class T, class Compare, class Distance>
+    RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Compare comp, Distance*, random_access_iterator_tag) {
+        Distance len = last - first;
+        Distance half;
+        RandomAccessIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first + half;
+            if (comp(*middle, value)) {
+                first = middle + 1;
+                len = len - half - 1;
+            }
+            else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    template <class ForwardIterator, class T, class Compare>
+    inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value, Compare comp) {
+        return __lower_bound(first, last, value, comp, distance_type(first), iterator_category(first));
+    }
+
+
+    // upper_bound 算法 -----------------------------------------------
+    // 在已排序区间 [first, last) 中找到第一个 "大于 value" 的位置
+
+    // forward_iterator 版本
+    template <class ForwardIterator, class T, class Distance>
+    ForwardIterator __upper_bound(ForwardIterator first, ForwardIterator last, const T& value, Distance*, forward_iterator_tag) {
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (value < *middle) {
+                len = half; // 左半段
+            }
+            else {
+                first = middle;
+                ++first;
+                len = len - half - 1; // 右半段
+            }
+        }
+        return first;
+    }
+    // RandomAccessIterator 版本
+    template <class RandomAccessIterator, class T, class Distance>
+    RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Distance*, random_access_iterator_tag) {
+        Distance len = last - first;
+        Distance half;
+        RandomAccessIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first + half;
+            if (value < *middle) {
+                len = half;
+            }
+            else {
+                first = middle + 1;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+
+    // 无分支版本, 原理同 __lower_bound_branchless
+    template <class RandomAccessIterator, class T>
+    RandomAccessIterator __upper_bound_branchless(RandomAccessIterator first, RandomAccessIterator last, const T& value) {
+        ptrdiff_t len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            ptrdiff_t half = len >> 1;
+            ptrdiff_t next_half = (len - half) >> 1;
+            __LI_PREFETCH(first + next_half);
+            __LI_PREFETCH(first + half + next_half);
+            first = (value < first[half]) ? first : first + half;
+            len -= half;
+        }
+        return first + !(value < *first);
+    }
+
+    template <class RandomAccessIterator, class T>
+    inline RandomAccessIterator __upper_bound_t(RandomAccessIterator first, RandomAccessIterator last, const T& value, __true_type) {
+        return __upper_bound_branchless(first, last, value);
+    }
+    template <class RandomAccessIterator, class T>
+    inline RandomAccessIterator __upper_bound_t(RandomAccessIterator first, RandomAccessIterator last, const T& value, __false_type) {
+        return __upper_bound(first, last, value, (ptrdiff_t*) 0, random_access_iterator_tag());
+    }
+
+    template <class ForwardIterator, class T>
+    struct __upper_bound_dispatch {
+        ForwardIterator operator()(ForwardIterator first, ForwardIterator last, const T& value) {
+            return __upper_bound(first, last, value, distance_type(first), iterator_category(first));
+        }
+    };
+    // 偏特化版本
+    template <class T>
+    struct __upper_bound_dispatch<T*, T> {
+        T* operator()(T* first, T* last, const T& value) {
+            typedef typename __is_arithmetic<T>::is_arithmetic t;
+            return __upper_bound_t(first, last, value, t());
+        }
+    };
+    template <class T>
+    struct __upper_bound_dispatch<const T*, T> {
+        const T* operator()(const T* first, const T* last, const T& value) {
+            typedef typename __is_arithmetic<T>::is_arithmetic t;
+            return __upper_bound_t(first, last, value, t());
+        }
+    };
+
+    template <class ForwardIterator, class T>
+    inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last, const T& value) {
+        return __upper_bound_dispatch<ForwardIterator, T>()(first, last, value);
+    }
+
+    // 自定义比较准则的版本
+    template <class ForwardIterator, class T, class Compare, class Distance>
+    ForwardIterator __upper_bound(ForwardIterator first, ForwardIterator last, const T& value, Compare comp, Distance*, forward_iterator_tag) {
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (comp(value, *middle)) {
+                len = half;
+            }
+            else {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+    template <class RandomAccessIterator, class T, class Compare, class Distance>
+    RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Compare comp, Distance*, random_access_iterator_tag) {
+        Distance len = last - first;
+        Distance half;
+        RandomAccessIterator middle;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first + half;
+            if (comp(value, *middle)) {
+                len = half;
+            }
+            else {
+                first = middle + 1;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+
+    template <class ForwardIterator, class T, class Compare>
+    inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last, const T& value, Compare comp) {
+        return __upper_bound(first, last, value, comp, distance_type(first), iterator_category(first));
+    }
+
+
+    // equal_range 算法 -----------------------------------------------
+    // 返回 [lower_bound, upper_bound), 即所有与 value 相等的元素构成的区间
+    // 先用二分法找到一个相等的元素 middle, 再分别在左右两边找上下界
+    template <class ForwardIterator, class T>
+    pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first, ForwardIterator last, const T& value) {
+        typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle, left, right;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (*middle < value) {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+            else if (value < *middle) {
+                len = half;
+            }
+            else { // 找到相等的元素
+                left = LI::lower_bound(first, middle, value);
+                LI::advance(first, len);
+                right = LI::upper_bound(++middle, first, value);
+                return pair<ForwardIterator, ForwardIterator>(left, right);
+            }
+        }
+        return pair<ForwardIterator, ForwardIterator>(first, first); // 没有相等的元素
+    }
+
+    template <class ForwardIterator, class T, class Compare>
+    pair<ForwardIterator, ForwardIterator> equal_range(ForwardIterator first, ForwardIterator last, const T& value, Compare comp) {
+        typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+        Distance len = LI::distance(first, last);
+        Distance half;
+        ForwardIterator middle, left, right;
+        while (len > 0) {
+            half = len >> 1;
+            middle = first;
+            LI::advance(middle, half);
+            if (comp(*middle, value)) {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+            else if (comp(value, *middle)) {
+                len = half;
+            }
+            else {
+                left = LI::lower_bound(first, middle, value, comp);
+                LI::advance(first, len);
+                right = LI::upper_bound(++middle, first, value, comp);
+                return pair<ForwardIterator, ForwardIterator>(left, right);
+            }
+        }
+        return pair<ForwardIterator, ForwardIterator>(first, first);
+    }
+
+
+    // binary_search 算法 -----------------------------------------------
+    template <class ForwardIterator, class T>
+    inline bool binary_search(ForwardIterator first, ForwardIterator last, const T& value) {
+        ForwardIterator i = LI::lower_bound(first, last, value);
+        return i != last && !(value < *i);
+    }
+
+    template <class ForwardIterator, class T, class Compare>
+    inline bool binary_search(ForwardIterator first, ForwardIterator last, const T& value, Compare comp) {
+        ForwardIterator i = LI::lower_bound(first, last, value, comp);
+        return i != last && !comp(value, *i);
+    }
+
+
+    // interpolation_search 算法 -----------------------------------------
+    // 插值查找, 返回值与 lower_bound 相同
+    // 适用于分布均匀的整数键: 按 value 在 [*lo, *hi] 中的比例估计位置, 期望 O(log log n) 次探测
+    // 分布不均匀时估计可能很差, 所以最多插值若干轮, 剩下的区间交给二分查找
+    template <class RandomAccessIterator, class T>
+    RandomAccessIterator interpolation_search(RandomAccessIterator first, RandomAccessIterator last, const T& value) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+        if (first == last || !(*first < value)) {
+            return first;
+        }
+        if (*(last - 1) < value) {
+            return last;
+        }
+        // 不变式: *lo < value <= *hi, 答案位于 (lo, hi]
+        RandomAccessIterator lo = first;
+        RandomAccessIterator hi = last - 1;
+        for (int round = 0; round < 16 && hi - lo > 8; ++round) {
+            double lo_key = double(*lo);
+            double hi_key = double(*hi);
+            if (!(lo_key < hi_key)) {
+                break; // 两个 64 位的键值转换为 double 后可能相等, 不能再插值, 交给二分查找
+            }
+            Distance pos = Distance((double(value) - lo_key) / (hi_key - lo_key) * double(hi - lo));
+            // 保证 middle 严格位于 (lo, hi) 之间, 每轮区间至少缩小 1
+            if (pos < 1) {
+                pos = 1;
+            }
+            else if (pos > hi - lo - 1) {
+                pos = hi - lo - 1;
+            }
+            RandomAccessIterator middle = lo + pos;
+            if (*middle < value) {
+                lo = middle;
+            }
+            else {
+                hi = middle;
+            }
+        }
+        return LI::lower_bound(lo + 1, hi, value);
+    }
+
+
+    // find 算法 -----------------------------------------------
+    // 返回第一个等于 value 的位置, 没有则返回 last
+
+    // InputIterator 版本
+    template <class InputIterator, class T>
+    inline InputIterator __find(InputIterator first, InputIterator last, const T& value, input_iterator_tag) {
+        while (first != last && !(*first == value)) {
+            ++first;
+        }
+        return first;
+    }
+    // RandomAccessIterator 版本
+    // 循环展开 4 次, 减少循环条件的判断次数
+    template <class RandomAccessIterator, class T>
+    RandomAccessIterator __find(RandomAccessIterator first, RandomAccessIterator last, const T& value, random_access_iterator_tag) {
+        typename iterator_traits<RandomAccessIterator>::difference_type trip_count = (last - first) >> 2;
+        for ( ; trip_count > 0; --trip_count) {
+            if (*first == value) return first;
+            ++first;
+            if (*first == value) return first;
+            ++first;
+            if (*first == value) return first;
+            ++first;
+            if (*first == value) return first;
+            ++first;
+        }
+        // 剩余 0 ~ 3 个元素
+        switch (last - first) {
+        case 3:
+            if (*first == value) return first;
+            ++first;
+        case 2:
+            if (*first == value) return first;
+            ++first;
+        case 1:
+            if (*first == value) return first;
+            ++first;
+        case 0:
+        default:
+            return last;
+        }
+    }
+
+    // 连续存放且可以向量化的型别, 调用 SIMD 内核
+    template <class Ptr, class T>
+    inline Ptr __find_t(Ptr first, Ptr last, const T& value, __true_type) {
+        return first + (__simd_find(first, last, value) - first);
+    }
+    template <class Ptr, class T>
+    inline Ptr __find_t(Ptr first, Ptr last, const T& value, __false_type) {
+        return __find(first, last, value, random_access_iterator_tag());
+    }
+
+    template <class InputIterator, class T>
+    struct __find_dispatch {
+        InputIterator operator()(InputIterator first, InputIterator last, const T& value) {
+            return __find(first, last, value, iterator_category(first));
+        }
+    };
+    // 偏特化版本
+    template <class T>
+    struct __find_dispatch<T*, T> {
+        T* operator()(T* first, T* last, const T& value) {
+            typedef typename __simd_traits<T>::has_simd_equal t;
+            return __find_t(first, last, value, t());
+        }
+    };
+    template <class T>
+    struct __find_dispatch<const T*, T> {
+        const T* operator()(const T* first, const T* last, const T& value) {
+            typedef typename __simd_traits<T>::has_simd_equal t;
+            return __find_t(first, last, value, t());
+        }
+    };
+
+    template <class InputIterator, class T>
+    inline InputIterator find(InputIterator first, InputIterator last, const T& value) {
+        return __find_dispatch<InputIterator, T>()(first, last, value);
+    }
+
+
+    // find_if 算法 -----------------------------------------------
+    // 谓词是任意的可调用对象, 无法向量化, 随机访问版本同样循环展开 4 次
+    template <class InputIterator, class Predicate>
+    inline InputIterator __find_if(InputIterator first, InputIterator last, Predicate pred, input_iterator_tag) {
+        while (first != last && !pred(*first)) {
+            ++first;
+        }
+        return first;
+    }
+    template <class RandomAccessIterator, class Predicate>
+    RandomAccessIterator __find_if(RandomAccessIterator first, RandomAccessIterator last, Predicate pred, random_access_iterator_tag) {
+        typename iterator_traits<RandomAccessIterator>::difference_type trip_count = (last - first) >> 2;
+        for ( ; trip_count > 0; --trip_count) {
+            if (pred(*first)) return first;
+            ++first;
+            if (pred(*first)) return first;
+            ++first;
+            if (pred(*first)) return first;
+            ++first;
+            if (pred(*first)) return first;
+            ++first;
+        }
+        switch (last - first) {
+        case 3:
+            if (pred(*first)) return first;
+            ++first;
+        case 2:
+            if (pred(*first)) return first;
+            ++first;
+        case 1:
+            if (pred(*first)) return first;
+            ++first;
+        case 0:
+        default:
+            return last;
+        }
+    }
+
+    template <class InputIterator, class Predicate>
+    inline InputIterator find_if(InputIterator first, InputIterator last, Predicate pred) {
+        return __find_if(first, last, pred, iterator_category(first));
+    }
+
+
+    // count 算法 -----------------------------------------------
+    // 统计等于 value 的元素个数
+    template <class InputIterator, class T>
+    typename iterator_traits<InputIterator>::difference_type
+    __count(InputIterator first, InputIterator last, const T& value) {
+        typename iterator_traits<InputIterator>::difference_type n = 0;
+        for ( ; first != last; ++first) {
+            if (*first == value) ++n;
+        }
+        return n;
+    }
+
+    template <class InputIterator, class T>
+    struct __count_dispatch {
+        typename iterator_traits<InputIterator>::difference_type
+        operator()(InputIterator first, InputIterator last, const T& value) {
+            return __count(first, last, value);
+        }
+    };
+
+    template <class T>
+    inline ptrdiff_t __count_t(const T* first, const T* last, const T& value, __true_type) {
+        return __simd_count(first, last, value);
+    }
+    template <class T>
+    inline ptrdiff_t __count_t(const T* first, const T* last, const T& value, __false_type) {
+        return __count(first, last, value);
+    }
+
+    // 偏特化版本
+    template <class T>
+    struct __count_dispatch<T*, T> {
+        ptrdiff_t operator()(const T* first, const T* last, const T& value) {
+            typedef typename __simd_traits<T>::has_simd_equal t;
+            return __count_t(first, last, value, t());
+        }
+    };
+    template <class T>
+    struct __count_dispatch<const T*, T> {
+        ptrdiff_t operator()(const T* first, const T* last, const T& value) {
+            typedef typename __simd_traits<T>::has_simd_equal t;
+            return __count_t(first, last, value, t());
+        }
+    };
+
+    template <class InputIterator, class T>
+    inline typename iterator_traits<InputIterator>::difference_type
+    count(InputIterator first, InputIterator last, const T& value) {
+        return __count_dispatch<InputIterator, T>()(first, last, value);
+    }
+
+    // count_if 算法
+    template <class InputIterator, class Predicate>
+    typename iterator_traits<InputIterator>::difference_type
+    count_if(InputIterator first, InputIterator last, Predicate pred) {
+        typename iterator_traits<InputIterator>::difference_type n = 0;
+        for ( ; first != last; ++first) {
+            if (pred(*first)) ++n;
+        }
+        return n;
+    }
+
+
+    // min_element / max_element / minmax_element 算法 ---------------------------
+
+    template <class ForwardIterator>
+    ForwardIterator __min_element(ForwardIterator first, ForwardIterator last) {
+        if (first == last) return first;
+        ForwardIterator result = first;
+        while (++first != last) {
+            if (*first < *result) result = first;
+        }
+        return result;
+    }
+    template <class ForwardIterator>
+    ForwardIterator __max_element(ForwardIterator first, ForwardIterator last) {
+        if (first == last) return first;
+        ForwardIterator result = first;
+        while (++first != last) {
+            if (*result < *first) result = first;
+        }
+        return result;
+    }
+    // 返回 (第一个最小值, 最后一个最大值)
+    template <class ForwardIterator>
+    pair<ForwardIterator, ForwardIterator> __minmax_element(ForwardIterator first, ForwardIterator last) {
+        pair<ForwardIterator, ForwardIterator> result(first, first);
+        if (first == last) return result;
+        while (++first != last) {
+            if (*first < *result.first) result.first = first;
+            if (!(*first < *result.second)) result.second = first;
+        }
+        return result;
+    }
+
+    // SIMD 版本: 先一次扫描求出最值, 再用 find 找到其位置
+    // T* 参数只用于推导元素型别 (Ptr 可能是 const T*)
+    template <class Ptr, class T>
+    inline Ptr __min_element_t(Ptr first, Ptr last, T*, __true_type) {
+        if (first == last) return last;
+        T min_value, max_value;
+        __simd_minmax(first, last, min_value, max_value);
+        return first + (__simd_find(first, last, min_value) - first);
+    }
+    template <class Ptr, class T>
+    inline Ptr __min_element_t(Ptr first, Ptr last, T*, __false_type) {
+        return __min_element(first, last);
+    }
+    template <class Ptr, class T>
+    inline Ptr __max_element_t(Ptr first, Ptr last, T*, __true_type) {
+        if (first == last) return last;
+        T min_value, max_value;
+        __simd_minmax(first, last, min_value, max_value);
+        return first + (__simd_find(first, last, max_value) - first);
+    }
+    template <class Ptr, class T>
+    inline Ptr __max_element_t(Ptr first, Ptr last, T*, __false_type) {
+        return __max_element(first, last);
+    }
+    template <class Ptr, class T>
+    inline pair<Ptr, Ptr> __minmax_element_t(Ptr first, Ptr last, T*, __true_type) {
+        if (first == last) return pair<Ptr, Ptr>(first, first);
+        T min_value, max_value;
+        __simd_minmax(first, last, min_value, max_value);
+        return pair<Ptr, Ptr>(first + (__simd_find(first, last, min_value) - first),
+                              first + (__simd_find_last(first, last, max_value) - first));
+    }
+    template <class Ptr, class T>
+    inline pair<Ptr, Ptr> __minmax_element_t(Ptr first, Ptr last, T*, __false_type) {
+        return __minmax_element(first, last);
+    }
+
+    template <class ForwardIterator>
+    struct __min_max_dispatch {
+        ForwardIterator min(ForwardIterator first, ForwardIterator last) { return __min_element(first, last); }
+        ForwardIterator max(ForwardIterator first, ForwardIterator last) { return __max_element(first, last); }
+        pair<ForwardIterator, ForwardIterator> minmax(ForwardIterator first, ForwardIterator last) {
+            return __minmax_element(first, last);
+        }
+    };
+    // 偏特化版本 原生指针
+    template <class T>
+    struct __min_max_dispatch<T*> {
+        typedef typename __simd_traits<T>::has_simd_order t;
+        T* min(T* first, T* last) { return __min_element_t(first, last, (T*) 0, t()); }
+        T* max(T* first, T* last) { return __max_element_t(first, last, (T*) 0, t()); }
+        pair<T*, T*> minmax(T* first, T* last) { return __minmax_element_t(first, last, (T*) 0, t()); }
+    };
+    template <class T>
+    struct __min_max_dispatch<const T*> {
+        typedef typename __simd_traits<T>::has_simd_order t;
+        const T* min(const T* first, const T* last) { return __min_element_t(first, last, (T*) 0, t()); }
+        const T* max(const T* first, const T* last) { return __max_element_t(first, last, (T*) 0, t()); }
+        pair<const T*, const T*> minmax(const T* first, const T* last) {
+            return __minmax_element_t(first, last, (T*) 0, t());
+        }
+    };
+
+    template <class ForwardIterator>
+    inline ForwardIterator min_element(ForwardIterator first, ForwardIterator last) {
+        return __min_max_dispatch<ForwardIterator>().min(first, last);
+    }
+    template <class ForwardIterator>
+    inline ForwardIterator max_element(ForwardIterator first, ForwardIterator last) {
+        return __min_max_dispatch<ForwardIterator>().max(first, last);
+    }
+    template <class ForwardIterator>
+    inline pair<ForwardIterator, ForwardIterator> minmax_element(ForwardIterator first, ForwardIterator last) {
+        return __min_max_dispatch<ForwardIterator>().minmax(first, last);
+    }
+
+    // 自定义比较准则的版本
+    template <class ForwardIterator, class Compare>
+    ForwardIterator min_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+        if (first == last) return first;
+        ForwardIterator result = first;
+        while (++first != last) {
+            if (comp(*first, *result)) result = first;
+        }
+        return result;
+    }
+    template <class ForwardIterator, class Compare>
+    ForwardIterator max_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+        if (first == last) return first;
+        ForwardIterator result = first;
+        while (++first != last) {
+            if (comp(*result, *first)) result = first;
+        }
+        return result;
+    }
+    template <class ForwardIterator, class Compare>
+    pair<ForwardIterator, ForwardIterator> minmax_element(ForwardIterator first, ForwardIterator last, Compare comp) {
+        pair<ForwardIterator, ForwardIterator> result(first, first);
+        if (first == last) return result;
+        while (++first != last) {
+            if (comp(*first, *result.first)) result.first = first;
+            if (!comp(*first, *result.second)) result.second = first;
+        }
+        return result;
+    }
+
+
+    // accumulate 算法 -----------------------------------------------
+    // 返回 init + *first + *(first + 1) + ...
+    template <class InputIterator, class T>
+    T __accumulate(InputIterator first, InputIterator last, T init) {
+        for ( ; first != last; ++first) {
+            init = init + *first;
+        }
+        return init;
+    }
+
+    template <class InputIterator, class T>
+    struct __accumulate_dispatch {
+        T operator()(InputIterator first, InputIterator last, T init) {
+            return __accumulate(first, last, init);
+        }
+    };
+
+    template <class T>
+    inline T __accumulate_t(const T* first, const T* last, T init, __true_type) {
+        return __simd_sum(first, last, init);
+    }
+    template <class T>
+    inline T __accumulate_t(const T* first, const T* last, T init, __false_type) {
+        return __accumulate(first, last, init);
+    }
+
+    // 偏特化版本
+    template <class T>
+    struct __accumulate_dispatch<T*, T> {
+        T operator()(const T* first, const T* last, T init) {
+            typedef typename __simd_traits<T>::has_simd_sum t;
+            return __accumulate_t(first, last, init, t());
+        }
+    };
+    template <class T>
+    struct __accumulate_dispatch<const T*, T> {
+        T operator()(const T* first, const T* last, T init) {
+            typedef typename __simd_traits<T>::has_simd_sum t;
+            return __accumulate_t(first, last, init, t());
+        }
+    };
+
+    template <class InputIterator, class T>
+    inline T accumulate(InputIterator first, InputIterator last, T init) {
+        return __accumulate_dispatch<InputIterator, T>()(first, last, init);
+    }
+
+    template <class InputIterator, class T, class BinaryOperation>
+    T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation binary_op) {
+        for ( ; first != last; ++first) {
+            init = binary_op(init, *first);
+        }
+        return init;
+    }
+
+
+    // iter_swap -----------------------------------------------
+    template <class ForwardIterator1, class ForwardIterator2, class T>
+    inline void __iter_swap(ForwardIterator1 a, ForwardIterator2 b, T*) {
+        T tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+
+    template <class ForwardIterator1, class ForwardIterator2>
+    inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b) {
+        LI::__iter_swap(a, b, value_type(a));
+    }
+
+
+    // partial_sort 算法 -----------------------------------------------
+    // 使 [first, middle) 为整个区间中最小的 middle - first 个元素, 且递增排列
+    // 以 [first, middle) 维护一个 max-heap, 剩余元素比堆顶小就替换堆顶
+
+    template <class RandomAccessIterator, class T>
+    void __heap_select(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, T*) {
+        LI::make_heap(first, middle);
+        for (RandomAccessIterator i = middle; i < last; ++i) {
+            if (*i < *first) {
+                LI::__pop_heap(first, middle, i, T(*i), distance_type(first));
+            }
+        }
+    }
+
+    template <class RandomAccessIterator>
+    inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last) {
+        LI::__heap_select(first, middle, last, value_type(first));
+        LI::sort_heap(first, middle);
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class T, class Compare>
+    void __heap_select(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, T*, Compare comp) {
+        LI::make_heap(first, middle, comp);
+        for (RandomAccessIterator i = middle; i < last; ++i) {
+            if (comp(*i, *first)) {
+                LI::__pop_heap(first, middle, i, T(*i), comp, distance_type(first));
+            }
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void partial_sort(RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last, Compare comp) {
+        LI::__heap_select(first, middle, last, value_type(first), comp);
+        LI::sort_heap(first, middle, comp);
+    }
+
+
+    // partial_sort_copy 算法 -----------------------------------------------
+    // 把 [first, last) 中最小的 N 个元素递增地复制到 [result_first, result_first + N)
+    // N = min(last - first, result_last - result_first)
+
+    template <class InputIterator, class RandomAccessIterator, class Distance, class T>
+    RandomAccessIterator __partial_sort_copy(InputIterator first, InputIterator last,
+                                             RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                             Distance*, T*) {
+        if (result_first == result_last) return result_last;
+        RandomAccessIterator result_real_last = result_first;
+        // 先填满目的区间
+        while (first != last && result_real_last != result_last) {
+            *result_real_last = *first;
+            ++result_real_last;
+            ++first;
+        }
+        LI::make_heap(result_first, result_real_last);
+        while (first != last) {
+            if (*first < *result_first) {
+                LI::__adjust_heap(result_first, Distance(0), Distance(result_real_last - result_first), T(*first));
+            }
+            ++first;
+        }
+        LI::sort_heap(result_first, result_real_last);
+        return result_real_last;
+    }
+
+    template <class InputIterator, class RandomAccessIterator>
+    inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                                  RandomAccessIterator result_first, RandomAccessIterator result_last) {
+        return LI::__partial_sort_copy(first, last, result_first, result_last, distance_type(result_first), value_type(first));
+    }
+
+    // 自定义比较准则的版本
+    template <class InputIterator, class RandomAccessIterator, class Compare, class Distance, class T>
+    RandomAccessIterator __partial_sort_copy(InputIterator first, InputIterator last,
+                                             RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                             Compare comp, Distance*, T*) {
+        if (result_first == result_last) return result_last;
+        RandomAccessIterator result_real_last = result_first;
+        while (first != last && result_real_last != result_last) {
+            *result_real_last = *first;
+            ++result_real_last;
+            ++first;
+        }
+        LI::make_heap(result_first, result_real_last, comp);
+        while (first != last) {
+            if (comp(*first, *result_first)) {
+                LI::__adjust_heap(result_first, Distance(0), Distance(result_real_last - result_first), T(*first), comp);
+            }
+            ++first;
+        }
+        LI::sort_heap(result_first, result_real_last, comp);
+        return result_real_last;
+    }
+
+    template <class InputIterator, class RandomAccessIterator, class Compare>
+    inline RandomAccessIterator partial_sort_copy(InputIterator first, InputIterator last,
+                                                  RandomAccessIterator result_first, RandomAccessIterator result_last,
+                                                  Compare comp) {
+        return LI::__partial_sort_copy(first, last, result_first, result_last, comp, distance_type(result_first), value_type(first));
+    }
+
+
+    // partition 算法 -----------------------------------------------
+    // 使满足 pred 的元素都位于不满足的元素之前, 返回第一个不满足 pred 的位置
+    // 不保证元素的相对次序
+
+    // ForwardIterator 版本: 单向扫描
+    template <class ForwardIterator, class Predicate>
+    ForwardIterator __partition(ForwardIterator first, ForwardIterator last, Predicate pred, forward_iterator_tag) {
+        while (first != last && pred(*first)) {
+            ++first;
+        }
+        if (first == last) return first;
+        for (ForwardIterator next = first; ++next != last; ) {
+            if (pred(*next)) {
+                LI::iter_swap(first, next);
+                ++first;
+            }
+        }
+        return first;
+    }
+
+    // BidirectionalIterator 版本: 头尾两个指针相向移动, 交换次数更少
+    template <class BidirectionalIterator, class Predicate>
+    BidirectionalIterator __partition(BidirectionalIterator first, BidirectionalIterator last, Predicate pred, bidirectional_iterator_tag) {
+        while (true) {
+            while (true) {
+                if (first == last) return first;
+                else if (pred(*first)) ++first; // 头指针所指元素不需要移动
+                else break;
+            }
+            --last;
+            while (true) {
+                if (first == last) return first;
+                else if (!pred(*last)) --last; // 尾指针所指元素不需要移动
+                else break;
+            }
+            LI::iter_swap(first, last);
+            ++first;
+        }
+    }
+
+    template <class ForwardIterator, class Predicate>
+    inline ForwardIterator partition(ForwardIterator first, ForwardIterator last, Predicate pred) {
+        return LI::__partition(first, last, pred, iterator_category(first));
+    }
+
+
+    // stable_partition 算法 -----------------------------------------------
+    // 与 partition 相同, 但保持两组元素各自的相对次序
+    // 满足 pred 的元素原地前移, 不满足的先放入临时缓冲区, 最后再复制回来
+    template <class ForwardIterator, class Predicate, class T, class Distance>
+    ForwardIterator __stable_partition(ForwardIterator first, ForwardIterator last, Predicate pred, T*, Distance*) {
+        typedef simple_alloc<T, alloc> buffer_allocator;
+        Distance len = LI::distance(first, last);
+        if (len == 0) return first;
+        T* buffer = buffer_allocator::allocate(len);
+        T* buffer_end = buffer;
+        ForwardIterator result = first;
+        try {
+            for ( ; first != last; ++first) {
+                if (pred(*first)) {
+                    *result = *first;
+                    ++result;
+                }
+                else {
+                    LI::construct(buffer_end, *first);
+                    ++buffer_end;
+                }
+            }
+            LI::copy(buffer, buffer_end, result);
+        }
+        catch(...) {
+            LI::destroy(buffer, buffer_end);
+            buffer_allocator::deallocate(buffer, len);
+            throw;
+        }
+        LI::destroy(buffer, buffer_end);
+        buffer_allocator::deallocate(buffer, len);
+        return result;
+    }
+
+    template <class ForwardIterator, class Predicate>
+    inline ForwardIterator stable_partition(ForwardIterator first, ForwardIterator last, Predicate pred) {
+        return LI::__stable_partition(first, last, pred, value_type(first), distance_type(first));
+    }
+
+
+    // insertion sort ----------------------------------------------
+    // 小区间上最快的排序, 供 nth_element 等算法收尾
+
+    // 已知 [.., last) 中一定有不大于 value 的元素, 因此不必检查边界
+    template <class RandomAccessIterator, class T>
+    void __unguarded_linear_insert(RandomAccessIterator last, T value) {
+        RandomAccessIterator next = last;
+        --next;
+        while (value < *next) {
+            *last = *next;
+            last = next;
+            --next;
+        }
+        *last = value;
+    }
+
+    template <class RandomAccessIterator, class T>
+    inline void __linear_insert(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        T value = *last;
+        if (value < *first) { // 比最小值还小, 整体后移一格
+            LI::copy_backward(first, last, last + 1);
+            *first = value;
+        }
+        else {
+            LI::__unguarded_linear_insert(last, value);
+        }
+    }
+
+    template <class RandomAccessIterator>
+    void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
+        if (first == last) return;
+        for (RandomAccessIterator i = first + 1; i != last; ++i) {
+            LI::__linear_insert(first, i, value_type(first));
+        }
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class T, class Compare>
+    void __unguarded_linear_insert(RandomAccessIterator last, T value, Compare comp) {
+        RandomAccessIterator next = last;
+        --next;
+        while (comp(value, *next)) {
+            *last = *next;
+            last = next;
+            --next;
+        }
+        *last = value;
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    inline void __linear_insert(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        T value = *last;
+        if (comp(value, *first)) {
+            LI::copy_backward(first, last, last + 1);
+            *first = value;
+        }
+        else {
+            LI::__unguarded_linear_insert(last, value, comp);
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        if (first == last) return;
+        for (RandomAccessIterator i = first + 1; i != last; ++i) {
+            LI::__linear_insert(first, i, value_type(first), comp);
+        }
+    }
+
+
+    // nth_element 算法 -----------------------------------------------
+    // 重排 [first, last), 使 nth 处的元素与完整排序后该位置的元素相同,
+    // 且 [first, nth) 中的元素都不大于它, [nth + 1, last) 中的元素都不小于它
+    // 采用 introselect: 三点取中的快速选择, 递归层数超过 2 * log2(n) 后改用 heap select,
+    // 保证最坏情况 O(n log n), 平均 O(n)
+
+    // 区间长度不超过此值时改用插入排序
+    const int __stl_threshold = 16;
+
+    // 求 floor(log2(n)), 用于控制递归深度
+    template <class Size>
+    inline Size __lg(Size n) {
+        Size k;
+        for (k = 0; n > 1; n >>= 1) ++k;
+        return k;
+    }
+
+    // 三点取中
+    template <class T>
+    inline const T& __median(const T& a, const T& b, const T& c) {
+        if (a < b) {
+            if (b < c) return b;      // a < b < c
+            else if (a < c) return c; // a < c <= b
+            else return a;            // c <= a < b
+        }
+        else if (a < c) return a;     // b <= a < c
+        else if (b < c) return c;     // b < c <= a
+        else return b;                // c <= b <= a
+    }
+
+    template <class T, class Compare>
+    inline const T& __median(const T& a, const T& b, const T& c, Compare comp) {
+        if (comp(a, b)) {
+            if (comp(b, c)) return b;
+            else if (comp(a, c)) return c;
+            else return a;
+        }
+        else if (comp(a, c)) return a;
+        else if (comp(b, c)) return c;
+        else return b;
+    }
+
+    // Hoare 分割, 返回第二段的起点
+    // pivot 是区间中某个元素的值, 两端的内层循环一定会停下, 因此不必检查边界
+    template <class RandomAccessIterator, class T>
+    RandomAccessIterator __unguarded_partition(RandomAccessIterator first, RandomAccessIterator last, T pivot) {
+        while (true) {
+            while (*first < pivot) ++first;
+            --last;
+            while (pivot < *last) --last;
+            if (!(first < last)) return first;
+            LI::iter_swap(first, last);
+            ++first;
+        }
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator __unguarded_partition(RandomAccessIterator first, RandomAccessIterator last, T pivot, Compare comp) {
+        while (true) {
+            while (comp(*first, pivot)) ++first;
+            --last;
+            while (comp(pivot, *last)) --last;
+            if (!(first < last)) return first;
+            LI::iter_swap(first, last);
+            ++first;
+        }
+    }
+
+    template <class RandomAccessIterator, class T, class Size>
+    void __introselect(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last, T*, Size depth_limit) {
+        while (last - first > __stl_threshold) {
+            if (depth_limit == 0) {
+                // 分割效果太差, 改用 heap select: 最小的 nth - first + 1 个元素组成 max-heap, 堆顶即为所求
+                LI::__heap_select(first, nth + 1, last, (T*) 0);
+                LI::iter_swap(first, nth);
+                return;
+            }
+            --depth_limit;
+            RandomAccessIterator cut = LI::__unguarded_partition(first, last,
+                T(LI::__median(*first, *(first + (last - first) / 2), *(last - 1))));
+            if (cut <= nth) first = cut; // 只需处理 nth 所在的一段
+            else last = cut;
+        }
+        LI::__insertion_sort(first, last);
+    }
+
+    template <class RandomAccessIterator, class T, class Size, class Compare>
+    void __introselect(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last, T*, Size depth_limit, Compare comp) {
+        while (last - first > __stl_threshold) {
+            if (depth_limit == 0) {
+                LI::__heap_select(first, nth + 1, last, (T*) 0, comp);
+                LI::iter_swap(first, nth);
+                return;
+            }
+            --depth_limit;
+            RandomAccessIterator cut = LI::__unguarded_partition(first, last,
+                T(LI::__median(*first, *(first + (last - first) / 2), *(last - 1), comp)), comp);
+            if (cut <= nth) first = cut;
+            else last = cut;
+        }
+        LI::__insertion_sort(first, last, comp);
+    }
+
+    // 算术型别的分割: 无分支的 Lomuto 分割
+    // 每一步都无条件交换, 再根据比较结果 (0 或 1) 移动边界, 编译为 cmov / setcc,
+    // 随机数据上不会有分支预测失败; 结束时 [first, lo) < pivot, [lo, last) >= pivot
+    template <class T>
+    T* __partition_branchless(T* first, T* last, T pivot) {
+        T* lo = first;
+        for ( ; first != last; ++first) {
+            T value = *first;
+            *first = *lo;
+            *lo = value;
+            lo += (value < pivot);
+        }
+        return lo;
+    }
+
+    // 同上, 但以 value <= pivot 为准, 用于把等于 pivot 的元素集中起来
+    template <class T>
+    T* __partition_branchless_equal(T* first, T* last, T pivot) {
+        T* lo = first;
+        for ( ; first != last; ++first) {
+            T value = *first;
+            *first = *lo;
+            *lo = value;
+            lo += !(pivot < value);
+        }
+        return lo;
+    }
+
+    template <class T, class Size>
+    void __introselect_branchless(T* first, T* nth, T* last, Size depth_limit) {
+        while (last - first > __stl_threshold) {
+            if (depth_limit == 0) {
+                LI::__heap_select(first, nth + 1, last, (T*) 0);
+                LI::iter_swap(first, nth);
+                return;
+            }
+            --depth_limit;
+            T pivot = LI::__median(*first, *(first + (last - first) / 2), *(last - 1));
+            T* cut = LI::__partition_branchless(first, last, pivot);
+            if (nth < cut) {
+                last = cut;
+                continue;
+            }
+            // nth 落在 >= pivot 的一段, 再把等于 pivot 的元素分出来;
+            // pivot 来自区间本身, 这一段至少有一个元素, 因此每轮必有进展
+            T* cut_equal = LI::__partition_branchless_equal(cut, last, pivot);
+            if (nth < cut_equal) return; // nth 处就是 pivot
+            first = cut_equal;
+        }
+        LI::__insertion_sort(first, last);
+    }
+
+    template <class T>
+    inline void __nth_element_t(T* first, T* nth, T* last, __true_type) {
+        LI::__introselect_branchless(first, nth, last, LI::__lg(last - first) * 2);
+    }
+    template <class T>
+    inline void __nth_element_t(T* first, T* nth, T* last, __false_type) {
+        LI::__introselect(first, nth, last, (T*) 0, LI::__lg(last - first) * 2);
+    }
+
+    template <class RandomAccessIterator>
+    struct __nth_element_dispatch {
+        void operator()(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last) {
+            LI::__introselect(first, nth, last, value_type(first), LI::__lg(last - first) * 2);
+        }
+    };
+    // 偏特化版本 原生指针, 算术型别走无分支版本
+    template <class T>
+    struct __nth_element_dispatch<T*> {
+        void operator()(T* first, T* nth, T* last) {
+            typedef typename __is_arithmetic<T>::is_arithmetic t;
+            LI::__nth_element_t(first, nth, last, t());
+        }
+    };
+
+    template <class RandomAccessIterator>
+    inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last) {
+        if (first == last || nth == last) return;
+        __nth_element_dispatch<RandomAccessIterator>()(first, nth, last);
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth, RandomAccessIterator last, Compare comp) {
+        if (first == last || nth == last) return;
+        LI::__introselect(first, nth, last, value_type(first), LI::__lg(last - first) * 2, comp);
+    }
+
+
+    // sort 算法 -----------------------------------------------
+    // introsort: 三点取中的快速排序, 递归层数超过 2 * log2(n) 后对该段改用 heap sort, 保证最坏 O(n log n);
+    // 长度不超过 __stl_threshold 的小段先不处理, 最后整体做一趟插入排序
+
+    template <class RandomAccessIterator, class T, class Size>
+    void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last, T*, Size depth_limit) {
+        while (last - first > __stl_threshold) {
+            if (depth_limit == 0) {
+                LI::partial_sort(first, last, last); // 分割效果太差, 改用 heap sort
+                return;
+            }
+            --depth_limit;
+            RandomAccessIterator cut = LI::__unguarded_partition(first, last,
+                T(LI::__median(*first, *(first + (last - first) / 2), *(last - 1))));
+            LI::__introsort_loop(cut, last, (T*) 0, depth_limit); // 递归处理右段, 循环处理左段
+            last = cut;
+        }
+    }
+
+    template <class RandomAccessIterator, class T>
+    void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        for (RandomAccessIterator i = first; i != last; ++i) {
+            LI::__unguarded_linear_insert(i, T(*i));
+        }
+    }
+
+    // 经过 __introsort_loop 后, 最小的元素一定在前 __stl_threshold 个之中,
+    // 因此之后的元素插入时不必检查边界
+    template <class RandomAccessIterator>
+    void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last) {
+        if (last - first > __stl_threshold) {
+            LI::__insertion_sort(first, first + __stl_threshold);
+            LI::__unguarded_insertion_sort(first + __stl_threshold, last, value_type(first));
+        }
+        else {
+            LI::__insertion_sort(first, last);
+        }
+    }
+
+    template <class RandomAccessIterator>
+    inline void sort(RandomAccessIterator first, RandomAccessIterator last) {
+        if (first == last) return;
+        LI::__introsort_loop(first, last, value_type(first), LI::__lg(last - first) * 2);
+        LI::__final_insertion_sort(first, last);
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class T, class Size, class Compare>
+    void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last, T*, Size depth_limit, Compare comp) {
+        while (last - first > __stl_threshold) {
+            if (depth_limit == 0) {
+                LI::partial_sort(first, last, last, comp);
+                return;
+            }
+            --depth_limit;
+            RandomAccessIterator cut = LI::__unguarded_partition(first, last,
+                T(LI::__median(*first, *(first + (last - first) / 2), *(last - 1), comp)), comp);
+            LI::__introsort_loop(cut, last, (T*) 0, depth_limit, comp);
+            last = cut;
+        }
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    void __unguarded_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        for (RandomAccessIterator i = first; i != last; ++i) {
+            LI::__unguarded_linear_insert(i, T(*i), comp);
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        if (last - first > __stl_threshold) {
+            LI::__insertion_sort(first, first + __stl_threshold, comp);
+            LI::__unguarded_insertion_sort(first + __stl_threshold, last, value_type(first), comp);
+        }
+        else {
+            LI::__insertion_sort(first, last, comp);
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        if (first == last) return;
+        LI::__introsort_loop(first, last, value_type(first), LI::__lg(last - first) * 2, comp);
+        LI::__final_insertion_sort(first, last, comp);
+    }
+
+
+    // 有序区间的合并与集合运算 ------------------------------------------------
+    // 两个区间都是随机访问迭代器, 且一个区间的长度不到另一个的 1/16 时,
+    // 对短区间的每个元素在长区间中做 galloping (指数) 搜索, 整段跳过/复制长区间,
+    // 复杂度从 O(m + n) 降为 O(m log(n / m))
+    // 不带比较准则的版本以 less<value_type> 转调自定义比较准则的版本
+
+    const int __gallop_ratio = 16;
+
+    // 从 first 开始以 1, 2, 4, ... 的步长向后探测, 再在最后一段中二分
+    // 目标在区间前部时只需 O(log d) 次比较, d 为目标与 first 的距离
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator __gallop_lower_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+        if (first == last || !comp(*first, value)) return first;
+        Distance len = last - first;
+        Distance bound = 1;
+        while (bound < len && comp(*(first + bound), value)) { // *(first + bound / 2) < value
+            bound <<= 1;
+        }
+        return LI::lower_bound(first + (bound >> 1) + 1, first + (bound < len ? bound : len), value, comp);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    RandomAccessIterator __gallop_upper_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value, Compare comp) {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+        if (first == last || comp(value, *first)) return first;
+        Distance len = last - first;
+        Distance bound = 1;
+        while (bound < len && !comp(value, *(first + bound))) {
+            bound <<= 1;
+        }
+        return LI::upper_bound(first + (bound >> 1) + 1, first + (bound < len ? bound : len), value, comp);
+    }
+
+    // 长度悬殊时返回 true
+    template <class Distance>
+    inline bool __should_gallop(Distance len1, Distance len2) {
+        return len1 >= len2 * __gallop_ratio || len2 >= len1 * __gallop_ratio;
+    }
+
+
+    // merge 算法 -----------------------------------------------
+    // 稳定: 相等的元素, 第一个区间的排在前面
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    OutputIterator __merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                           OutputIterator result, Compare comp, input_iterator_tag, input_iterator_tag) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+            }
+            ++result;
+        }
+        return LI::copy(first2, last2, LI::copy(first1, last1, result));
+    }
+
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class OutputIterator, class Compare>
+    OutputIterator __merge(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                           OutputIterator result, Compare comp, random_access_iterator_tag, random_access_iterator_tag) {
+        if (!LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::__merge(first1, last1, first2, last2, result, comp, input_iterator_tag(), input_iterator_tag());
+        }
+        if (last2 - first2 < last1 - first1) {
+            // 第二个区间短: 先复制第一个区间中不大于 *first2 的一段
+            for ( ; first2 != last2; ++first2) {
+                RandomAccessIterator1 mid = LI::__gallop_upper_bound(first1, last1, *first2, comp);
+                result = LI::copy(first1, mid, result);
+                first1 = mid;
+                *result = *first2;
+                ++result;
+            }
+        }
+        else {
+            // 第一个区间短: 先复制第二个区间中小于 *first1 的一段
+            for ( ; first1 != last1; ++first1) {
+                RandomAccessIterator2 mid = LI::__gallop_lower_bound(first2, last2, *first1, comp);
+                result = LI::copy(first2, mid, result);
+                first2 = mid;
+                *result = *first1;
+                ++result;
+            }
+        }
+        return LI::copy(first2, last2, LI::copy(first1, last1, result));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    inline OutputIterator merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                OutputIterator result, Compare comp) {
+        return LI::__merge(first1, last1, first2, last2, result, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    inline OutputIterator merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                OutputIterator result) {
+        return LI::merge(first1, last1, first2, last2, result, less<typename iterator_traits<InputIterator1>::value_type>());
+    }
+
+
+    // inplace_merge 算法 -----------------------------------------------
+    // 把相连的两个有序区间 [first, middle) 和 [middle, last) 合并为一个有序区间, 稳定
+    // 把较短的一段放入临时缓冲区, 再 向前 (或 向后) 合并回原区间
+
+    // 从尾端向前合并, 相等的元素第二个区间的先输出 (排在后面)
+    template <class BidirectionalIterator1, class BidirectionalIterator2, class BidirectionalIterator3, class Compare>
+    BidirectionalIterator3 __merge_backward(BidirectionalIterator1 first1, BidirectionalIterator1 last1,
+                                            BidirectionalIterator2 first2, BidirectionalIterator2 last2,
+                                            BidirectionalIterator3 result, Compare comp) {
+        if (first1 == last1) return LI::copy_backward(first2, last2, result);
+        if (first2 == last2) return LI::copy_backward(first1, last1, result);
+        --last1;
+        --last2;
+        while (true) {
+            if (comp(*last2, *last1)) {
+                *(--result) = *last1;
+                if (first1 == last1) return LI::copy_backward(first2, ++last2, result);
+                --last1;
+            }
+            else {
+                *(--result) = *last2;
+                if (first2 == last2) return LI::copy_backward(first1, ++last1, result);
+                --last2;
+            }
+        }
+    }
+
+    template <class BidirectionalIterator, class Compare, class T, class Distance>
+    void __inplace_merge(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last,
+                         Compare comp, T*, Distance*) {
+        typedef simple_alloc<T, alloc> buffer_allocator;
+        if (first == middle || middle == last) return;
+        // 去掉两端已经就位的元素: [first, upper_bound(*middle)) 与 [lower_bound(*(middle - 1)), last)
+        BidirectionalIterator before_middle = middle;
+        --before_middle;
+        if (!comp(*middle, *before_middle)) return; // 已经有序
+        first = LI::upper_bound(first, middle, *middle, comp);
+        last = LI::lower_bound(middle, last, *before_middle, comp);
+        Distance len1 = LI::distance(first, middle);
+        Distance len2 = LI::distance(middle, last);
+        Distance len = len1 <= len2 ? len1 : len2;
+        T* buffer = buffer_allocator::allocate(len);
+        T* buffer_end = buffer;
+        try {
+            if (len1 <= len2) {
+                for (BidirectionalIterator i = first; i != middle; ++i, ++buffer_end) {
+                    LI::construct(buffer_end, *i);
+                }
+                LI::merge(buffer, buffer_end, middle, last, first, comp);
+            }
+            else {
+                for (BidirectionalIterator i = middle; i != last; ++i, ++buffer_end) {
+                    LI::construct(buffer_end, *i);
+                }
+                LI::__merge_backward(first, middle, buffer, buffer_end, last, comp);
+            }
+        }
+        catch(...) {
+            LI::destroy(buffer, buffer_end);
+            buffer_allocator::deallocate(buffer, len);
+            throw;
+        }
+        LI::destroy(buffer, buffer_end);
+        buffer_allocator::deallocate(buffer, len);
+    }
+
+    template <class BidirectionalIterator, class Compare>
+    inline void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last, Compare comp) {
+        LI::__inplace_merge(first, middle, last, comp, value_type(first), distance_type(first));
+    }
+
+    template <class BidirectionalIterator>
+    inline void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle, BidirectionalIterator last) {
+        LI::inplace_merge(first, middle, last, less<typename iterator_traits<BidirectionalIterator>::value_type>());
+    }
+
+
+    // set_union 算法 -----------------------------------------------
+    // 某值在两个区间中分别出现 m 和 n 次, 结果中出现 max(m, n) 次, 相等时取第一个区间的元素
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_union(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator result, Compare comp, input_iterator_tag, input_iterator_tag) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                *result = *first1;
+                ++first1;
+            }
+            else if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++first2;
+            }
+            ++result;
+        }
+        return LI::copy(first2, last2, LI::copy(first1, last1, result));
+    }
+
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_union(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                               OutputIterator result, Compare comp, random_access_iterator_tag, random_access_iterator_tag) {
+        if (!LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::__set_union(first1, last1, first2, last2, result, comp, input_iterator_tag(), input_iterator_tag());
+        }
+        if (last2 - first2 < last1 - first1) {
+            for ( ; first2 != last2; ++first2) {
+                RandomAccessIterator1 mid = LI::__gallop_lower_bound(first1, last1, *first2, comp);
+                result = LI::copy(first1, mid, result);
+                first1 = mid;
+                if (first1 != last1 && !comp(*first2, *first1)) { // 相等, 取第一个区间的元素
+                    *result = *first1;
+                    ++first1;
+                }
+                else {
+                    *result = *first2;
+                }
+                ++result;
+            }
+        }
+        else {
+            for ( ; first1 != last1; ++first1) {
+                RandomAccessIterator2 mid = LI::__gallop_lower_bound(first2, last2, *first1, comp);
+                result = LI::copy(first2, mid, result);
+                first2 = mid;
+                if (first2 != last2 && !comp(*first1, *first2)) ++first2; // 相等, 跳过第二个区间的元素
+                *result = *first1;
+                ++result;
+            }
+        }
+        return LI::copy(first2, last2, LI::copy(first1, last1, result));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    inline OutputIterator set_union(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                    OutputIterator result, Compare comp) {
+        return LI::__set_union(first1, last1, first2, last2, result, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    inline OutputIterator set_union(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                    OutputIterator result) {
+        return LI::set_union(first1, last1, first2, last2, result, less<typename iterator_traits<InputIterator1>::value_type>());
+    }
+
+
+    // set_intersection 算法 -----------------------------------------------
+    // 某值在两个区间中分别出现 m 和 n 次, 结果中出现 min(m, n) 次, 取第一个区间的元素
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_intersection(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                      OutputIterator result, Compare comp, input_iterator_tag, input_iterator_tag) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                ++first1;
+            }
+            else if (comp(*first2, *first1)) {
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++first2;
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_intersection(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                                      OutputIterator result, Compare comp, random_access_iterator_tag, random_access_iterator_tag) {
+        if (!LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::__set_intersection(first1, last1, first2, last2, result, comp, input_iterator_tag(), input_iterator_tag());
+        }
+        if (last2 - first2 < last1 - first1) {
+            for ( ; first2 != last2; ++first2) {
+                first1 = LI::__gallop_lower_bound(first1, last1, *first2, comp);
+                if (first1 == last1) break;
+                if (!comp(*first2, *first1)) {
+                    *result = *first1;
+                    ++result;
+                    ++first1;
+                }
+            }
+        }
+        else {
+            for ( ; first1 != last1; ++first1) {
+                first2 = LI::__gallop_lower_bound(first2, last2, *first1, comp);
+                if (first2 == last2) break;
+                if (!comp(*first1, *first2)) {
+                    *result = *first1;
+                    ++result;
+                    ++first2;
+                }
+            }
+        }
+        return result;
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    inline OutputIterator set_intersection(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                           OutputIterator result, Compare comp) {
+        return LI::__set_intersection(first1, last1, first2, last2, result, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    inline OutputIterator set_intersection(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                           OutputIterator result) {
+        return LI::set_intersection(first1, last1, first2, last2, result, less<typename iterator_traits<InputIterator1>::value_type>());
+    }
+
+
+    // set_intersection_unique 算法 -----------------------------------------------
+    // 要求两个区间都严格递增 (没有重复元素), 结果与 set_intersection 相同
+    // 连续存放的 unsigned int 在长度相近时使用 SIMD 内核 (逐块 all-pairs 比较)
+    // 一般的 set_intersection 有重复元素时每个元素只能匹配一次, 无法按块比较
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    struct __set_intersection_unique_dispatch {
+        OutputIterator operator()(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                  OutputIterator result) {
+            return LI::set_intersection(first1, last1, first2, last2, result);
+        }
+    };
+
+    inline unsigned int* __set_intersection_unique_u32(const unsigned int* first1, const unsigned int* last1,
+                                                       const unsigned int* first2, const unsigned int* last2,
+                                                       unsigned int* result) {
+        if (LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::set_intersection(first1, last1, first2, last2, result);
+        }
+        return LI::__simd_intersect_unique(first1, last1, first2, last2, result);
+    }
+
+    // 偏特化版本
+    template <>
+    struct __set_intersection_unique_dispatch<unsigned int*, unsigned int*, unsigned int*> {
+        unsigned int* operator()(unsigned int* first1, unsigned int* last1, unsigned int* first2, unsigned int* last2,
+                                 unsigned int* result) {
+            return __set_intersection_unique_u32(first1, last1, first2, last2, result);
+        }
+    };
+    template <>
+    struct __set_intersection_unique_dispatch<const unsigned int*, const unsigned int*, unsigned int*> {
+        unsigned int* operator()(const unsigned int* first1, const unsigned int* last1, const unsigned int* first2, const unsigned int* last2,
+                                 unsigned int* result) {
+            return __set_intersection_unique_u32(first1, last1, first2, last2, result);
+        }
+    };
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    inline OutputIterator set_intersection_unique(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                                  OutputIterator result) {
+        return __set_intersection_unique_dispatch<InputIterator1, InputIterator2, OutputIterator>()(first1, last1, first2, last2, result);
+    }
+
+
+    // set_difference 算法 -----------------------------------------------
+    // 某值在两个区间中分别出现 m 和 n 次, 结果中出现 max(m - n, 0) 次, 取第一个区间的元素
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                    OutputIterator result, Compare comp, input_iterator_tag, input_iterator_tag) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                *result = *first1;
+                ++first1;
+                ++result;
+            }
+            else if (comp(*first2, *first1)) {
+                ++first2;
+            }
+            else {
+                ++first1;
+                ++first2;
+            }
+        }
+        return LI::copy(first1, last1, result);
+    }
+
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class OutputIterator, class Compare>
+    OutputIterator __set_difference(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                                    OutputIterator result, Compare comp, random_access_iterator_tag, random_access_iterator_tag) {
+        if (!LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::__set_difference(first1, last1, first2, last2, result, comp, input_iterator_tag(), input_iterator_tag());
+        }
+        if (last2 - first2 < last1 - first1) {
+            // 第二个区间短: 整段复制第一个区间, 只去掉与 *first2 相等的一个元素
+            for ( ; first2 != last2; ++first2) {
+                RandomAccessIterator1 mid = LI::__gallop_lower_bound(first1, last1, *first2, comp);
+                result = LI::copy(first1, mid, result);
+                first1 = mid;
+                if (first1 == last1) break;
+                if (!comp(*first2, *first1)) ++first1;
+            }
+        }
+        else {
+            for ( ; first1 != last1; ++first1) {
+                first2 = LI::__gallop_lower_bound(first2, last2, *first1, comp);
+                if (first2 == last2) break;
+                if (!comp(*first1, *first2)) {
+                    ++first2; // 相等, 抵消
+                }
+                else {
+                    *result = *first1;
+                    ++result;
+                }
+            }
+        }
+        return LI::copy(first1, last1, result);
+    }
 
+    template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+    inline OutputIterator set_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                         OutputIterator result, Compare comp) {
+        return LI::__set_difference(first1, last1, first2, last2, result, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIterator1, class InputIterator2, class OutputIterator>
+    inline OutputIterator set_difference(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                                         OutputIterator result) {
+        return LI::set_difference(first1, last1, first2, last2, result, less<typename iterator_traits<InputIterator1>::value_type>());
+    }
+
+
+    // includes 算法 -----------------------------------------------
+    // 判断 [first2, last2) 是否为 [first1, last1) 的子集 (计重复次数)
+
+    template <class InputIterator1, class InputIterator2, class Compare>
+    bool __includes(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                    Compare comp, input_iterator_tag, input_iterator_tag) {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                return false;
+            }
+            else if (comp(*first1, *first2)) {
+                ++first1;
+            }
+            else {
+                ++first1;
+                ++first2;
+            }
+        }
+        return first2 == last2;
+    }
+
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class Compare>
+    bool __includes(RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+                    Compare comp, random_access_iterator_tag, random_access_iterator_tag) {
+        if (last1 - first1 < last2 - first2) return false; // 子集不可能更长
+        if (!LI::__should_gallop(last1 - first1, last2 - first2)) {
+            return LI::__includes(first1, last1, first2, last2, comp, input_iterator_tag(), input_iterator_tag());
+        }
+        for ( ; first2 != last2; ++first2) {
+            first1 = LI::__gallop_lower_bound(first1, last1, *first2, comp);
+            if (first1 == last1 || comp(*first2, *first1)) return false;
+            ++first1;
+        }
+        return true;
+    }
+
+    template <class InputIterator1, class InputIterator2, class Compare>
+    inline bool includes(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, Compare comp) {
+        return LI::__includes(first1, last1, first2, last2, comp, iterator_category(first1), iterator_category(first2));
+    }
+
+    template <class InputIterator1, class InputIterator2>
+    inline bool includes(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) {
+        return LI::includes(first1, last1, first2, last2, less<typename iterator_traits<InputIterator1>::value_type>());
+    }
 
 }
 
@@ -3,6 +3,7 @@
 
 #include <new>
 #include <malloc.h>
+#include "li_lock.h"
 
 namespace LI {
     // 负责内存的 配置和释放
@@ -29,6 +30,17 @@ namespace LI {
         static void deallocate(void* p, size_t) {
             free(p); // 第一级配置器直接用free
         }
+        // 释放一串以首字为链接的区块 [first ... last], 逐个 free
+        static void deallocate_chain(void* first, void* last, size_t) {
+            for (;;) {
+                void* next = *(void**)first; // 先取出下一块, 再释放
+                free(first);
+                if (first == last) {
+                    break;
+                }
+                first = next;
+            }
+        }
 
         static void* reallocate(void* p, size_t /*old_sze*/, size_t new_sz) {
             void* result = realloc(p, new_sz); // 第一级配置器直接用 realloc()
@@ -128,11 +140,24 @@ namespace LI {
         static char* end_free; // 内存池结束位置. 只在chunk_alloc()中变化
         static size_t heap_size;
 
+        // threads 为 true 时 free lists 与内存池由所有线程共用, 以一把自旋锁保护
+        static __spin_lock pool_lock;
+        // 作用域内加锁, threads 为 false 时什么也不做 (同 SGI STL 的 _Lock)
+        struct lock {
+            lock() { if (threads) pool_lock.lock(); }
+            ~lock() { if (threads) pool_lock.unlock(); }
+        };
+
     public:
         // 申请内存
         static void* allocate(size_t n);
         // 释放内存
         static void deallocate(void* p, size_t n);
+        // 批量释放一串大小均为 n 的区块, 区块以首字串联, 由 first 到 last
+        static void deallocate_chain(void* first, void* last, size_t n);
+        // 一次取出至多 nobjs 个大小为 n (n <= 128) 的区块, 以首字串联, 最后一块的链接为 0
+        // nobjs 返回实际取出的个数 (至少 1); 只加一次锁, 供每个线程的缓存批量补充
+        static void* allocate_chain(size_t n, int& nobjs);
         static void* reallocate(void* p, size_t old_sz, size_t new_sz);
     };
 
@@ -143,6 +168,8 @@ namespace LI {
     char* __default_alloc_template<threads, inst>::end_free = 0;
     template<bool threads, int inst>
     size_t __default_alloc_template<threads, inst>::heap_size = 0;
+    template<bool threads, int inst>
+    __spin_lock __default_alloc_template<threads, inst>::pool_lock;
 
     template<bool threads, int inst>
     typename __default_alloc_template<threads, inst>::obj* volatile 
@@ -158,6 +185,7 @@ namespace LI {
         if (n > (size_t) __MAX_BYTES) {
             return (malloc_alloc::allocate(n));
         }
+        lock lock_instance;
         // 寻找16个free lists中适当的一个
         my_free_list = free_list + FREELIST_INDEX(n);
         result = *my_free_list;
@@ -181,6 +209,7 @@ namespace LI {
             malloc_alloc::deallocate(p, n);
             return;
         }
+        lock lock_instance;
         // 寻找相应的free list
         my_free_list = free_list + FREELIST_INDEX(n);
         // 回收
@@ -188,6 +217,49 @@ namespace LI {
         *my_free_list = q;
     }
 
+    // 区块的首字本身就是 free_list_link, 整串一次接到 free list 头部, O(1)
+    template<bool threads, int inst>
+    void __default_alloc_template<threads, inst>::deallocate_chain(void* first, void* last, size_t n) {
+        obj* volatile * my_free_list;
+
+        // 大于128就逐块交给第一级配置器
+        if (n > 128) {
+            malloc_alloc::deallocate_chain(first, last, n);
+            return;
+        }
+        lock lock_instance;
+        my_free_list = free_list + FREELIST_INDEX(n);
+        ((obj*)last)->free_list_link = *my_free_list;
+        *my_free_list = (obj*)first;
+    }
+
+    template<bool threads, int inst>
+    void* __default_alloc_template<threads, inst>::allocate_chain(size_t n, int& nobjs) {
+        lock lock_instance;
+        obj* volatile * my_free_list = free_list + FREELIST_INDEX(n);
+        obj* result = *my_free_list;
+        if (result != 0) {
+            // free list 中有区块, 取出其中至多 nobjs 个
+            obj* last = result;
+            int got = 1;
+            while (got < nobjs && last->free_list_link != 0) {
+                last = last->free_list_link;
+                ++got;
+            }
+            *my_free_list = last->free_list_link;
+            last->free_list_link = 0;
+            nobjs = got;
+            return result;
+        }
+        // 直接从内存池切出一批并串联起来
+        size_t size = ROUND_UP(n);
+        char* chunk = chunk_alloc(size, nobjs);
+        for (int i = 0; i < nobjs; ++i) {
+            ((obj*)(chunk + i * size))->free_list_link = (i + 1 < nobjs) ? (obj*)(chunk + (i + 1) * size) : 0;
+        }
+        return chunk;
+    }
+
     // n 为 8 的倍数
     template<bool threads, int inst>
     void* __default_alloc_template<threads, inst>::refill(size_t n) {
@@ -288,6 +360,8 @@ namespace LI {
 
     // 别名
     typedef __default_alloc_template<false, 0> alloc;
+    // 多线程共用的内存池, 每次配置和释放都加锁
+    typedef __default_alloc_template<true, 0> threads_alloc;
 
     // 对外接口 默认使用第一配置器和第二配置器结合
     // Alloc 定为 alloc 即可. 
@@ -309,6 +383,10 @@ namespace LI {
         static void deallocate(T* p) {
             Alloc::deallocate(p, sizeof(T)); // 只释放当前指针的内存
         }
+        // 释放一串以首字相连的对象 first -> ... -> last
+        static void deallocate_chain(T* first, T* last) {
+            Alloc::deallocate_chain(first, last, sizeof(T));
+        }
     };
 
 }
@@ -0,0 +1,937 @@
+#ifndef LI_BTREE_H_
+#define LI_BTREE_H_
+
+#include "li_iterator.h"
+#include "li_alloc.h"
+#include "li_construct.h"
+#include "li_type_traits.h"
+#include "li_pair.h"
+#include "li_utility.h"
+#include "li_functional.h"
+#include "li_simd.h"
+#include "li_rbtree.hpp"
+#include <string.h>
+
+// B+ 树的设计与实现
+// 1. 元素只存放在叶节点中, 叶节点按键值顺序以双向链表相连, 迭代器是 (叶节点, 下标)
+// 2. 内部节点存放 n 个分隔键值和 n + 1 个子节点: 第 i 个子树的键值 < keys[i] <= 第 i + 1 个子树的键值
+//    分隔键值是插入时复制的, 元素删除后分隔键值可以留着, 只要仍然满足上面的次序即可
+// 3. 每个节点按缓存行的整数倍 (约 512 字节) 安排容量, 键值在节点中连续存放, 节点内的查找
+//    对 int / unsigned int 配合 less 时用 SIMD 比较, 其他型别二分查找
+// 4. 叶节点另外保存一份键值 (keys) 与元素 (values) 分开, 查找时只扫描 keys
+// 5. 插入时节点满了就分裂, 删除时节点不足半满就向兄弟节点借一个 或 与兄弟节点合并
+//    在最右 (最左) 端插入时不平分, 原节点保持全满, 顺序插入时节点几乎都是满的
+//
+// 与 rb_tree 不同, 插入和删除会在节点之间搬动元素, 所有迭代器随之失效
+// 键值型别需要可以复制 (分隔键值), 搬动元素时使用移动构造
+
+namespace LI {
+
+    // 节点的目标大小 (字节)
+    const int __btree_target_node_size = 512;
+    // 树的最大高度: 每个内部节点至少有 2 个子节点
+    const int __btree_max_height = 64;
+
+    struct __btree_node_base {
+        __btree_node_base* parent;
+        unsigned short position; // 在父节点 children 中的下标
+        unsigned short count; // 键值个数
+        bool leaf;
+    };
+
+    // 节点容量: 一个节点大约 __btree_target_node_size 字节, 至少 4 个
+    template <class Key, class Value>
+    struct __btree_params {
+        enum {
+            __leaf_slots = (__btree_target_node_size - 3 * sizeof(void*)) / (sizeof(Key) + sizeof(Value)),
+            __internal_slots = (__btree_target_node_size - 2 * sizeof(void*)) / (sizeof(Key) + sizeof(void*)),
+            leaf_capacity = __leaf_slots < 4 ? 4 : __leaf_slots,
+            internal_capacity = __internal_slots < 4 ? 4 : __internal_slots
+        };
+    };
+
+    // 叶节点: 键值与元素各自连续存放, 只构造 [0, count) 中的对象
+    template <class Key, class Value, int N>
+    struct __btree_leaf_node : public __btree_node_base {
+        __btree_leaf_node* prev;
+        __btree_leaf_node* next;
+        alignas(Key) unsigned char key_buf[sizeof(Key) * N];
+        alignas(Value) unsigned char value_buf[sizeof(Value) * N];
+        Key* keys() { return reinterpret_cast<Key*>(key_buf); }
+        Value* values() { return reinterpret_cast<Value*>(value_buf); }
+    };
+
+    // 内部节点: n 个分隔键值, n + 1 个子节点
+    template <class Key, int N>
+    struct __btree_internal_node : public __btree_node_base {
+        alignas(Key) unsigned char key_buf[sizeof(Key) * N];
+        __btree_node_base* children[N + 1];
+        Key* keys() { return reinterpret_cast<Key*>(key_buf); }
+    };
+
+    // 把 [first, last) 的对象搬到 result 开始的未初始化空间, 原位置的对象随之析构
+    // 区间可以重叠; POD 型别直接 memmove
+    template <class T>
+    inline void __btree_relocate(T* first, T* last, T* result, __true_type) {
+        memmove(result, first, (last - first) * sizeof(T));
+    }
+    template <class T>
+    inline void __btree_relocate(T* first, T* last, T* result, __false_type) {
+        if (result < first) {
+            for ( ; first != last; ++first, ++result) {
+                construct(result, LI::move(*first));
+                destroy(first);
+            }
+        }
+        else {
+            result += last - first;
+            while (last != first) {
+                --last;
+                --result;
+                construct(result, LI::move(*last));
+                destroy(last);
+            }
+        }
+    }
+    template <class T>
+    inline void __btree_relocate(T* first, T* last, T* result) {
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        __btree_relocate(first, last, result, is_POD());
+    }
+
+    // 节点内查找: 第一个不小于 x 的键值的下标, 二分查找
+    template <class Key, class K, class Compare>
+    inline int __btree_binary_lower(const Key* keys, int n, const K& x, const Compare& comp) {
+        int first = 0;
+        while (n > 0) {
+            int half = n >> 1;
+            if (comp(keys[first + half], x)) {
+                first += half + 1;
+                n -= half + 1;
+            }
+            else {
+                n = half;
+            }
+        }
+        return first;
+    }
+
+    template <class Key, class Compare>
+    struct __btree_search {
+        template <class K>
+        static int lower(const Key* keys, int n, const K& x, const Compare& comp) {
+            return __btree_binary_lower(keys, n, x, comp);
+        }
+    };
+    // less 比较时, 能用 SIMD 的型别数一数有几个键值小于 x (节点内有序, 个数即为下标)
+    template <class Key>
+    struct __btree_search<Key, less<Key> > {
+        static int lower(const Key* keys, int n, const Key& x, const less<Key>& comp) {
+            typedef typename __simd_traits<Key>::has_simd_order has_simd;
+            return __lower(keys, n, x, comp, has_simd());
+        }
+        static int __lower(const Key* keys, int n, const Key& x, const less<Key>&, __true_type) {
+            return int(__simd_count_less(keys, keys + n, x));
+        }
+        static int __lower(const Key* keys, int n, const Key& x, const less<Key>& comp, __false_type) {
+            return __btree_binary_lower(keys, n, x, comp);
+        }
+    };
+
+
+    // B+ 树的迭代器 ---------------------------------------------------------
+    // 指向 (叶节点, 下标); end() 是最右叶节点的 count 位置, 空树时为 (nullptr, 0)
+    template <class Value, class Ref, class Ptr, class Leaf>
+    struct __btree_iterator {
+        typedef __btree_iterator<Value, Value&, Value*, Leaf> iterator;
+        typedef __btree_iterator<Value, const Value&, const Value*, Leaf> const_iterator;
+        typedef __btree_iterator<Value, Ref, Ptr, Leaf> self;
+
+        typedef bidirectional_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef ptrdiff_t difference_type;
+
+        Leaf* node;
+        int position;
+
+        __btree_iterator() : node(nullptr), position(0) { }
+        __btree_iterator(Leaf* x, int i) : node(x), position(i) { }
+        __btree_iterator(const iterator& it) : node(it.node), position(it.position) { }
+
+        reference operator*() const { return node->values()[position]; }
+        pointer operator->() const { return &(operator*()); }
+
+        self& operator++() {
+            if (++position == node->count && node->next != nullptr) { // 走到下一个叶节点
+                node = node->next;
+                position = 0;
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        self& operator--() {
+            if (position == 0) {
+                node = node->prev;
+                position = node->count - 1;
+            }
+            else {
+                --position;
+            }
+            return *this;
+        }
+        self operator--(int) {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+    };
+
+    template <class Value, class Ref1, class Ptr1, class Ref2, class Ptr2, class Leaf>
+    inline bool operator==(const __btree_iterator<Value, Ref1, Ptr1, Leaf>& x, const __btree_iterator<Value, Ref2, Ptr2, Leaf>& y) {
+        return x.node == y.node && x.position == y.position;
+    }
+    template <class Value, class Ref1, class Ptr1, class Ref2, class Ptr2, class Leaf>
+    inline bool operator!=(const __btree_iterator<Value, Ref1, Ptr1, Leaf>& x, const __btree_iterator<Value, Ref2, Ptr2, Leaf>& y) {
+        return !(x == y);
+    }
+
+
+    // B+ 树 --------------------------------------------------------------------
+    // 只实现键值不重复的版本 (btree_map 使用)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc>
+    class btree {
+    public:
+        typedef Key key_type;
+        typedef Value value_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        enum {
+            leaf_capacity = __btree_params<Key, Value>::leaf_capacity,
+            internal_capacity = __btree_params<Key, Value>::internal_capacity
+        };
+
+    protected:
+        typedef __btree_node_base* base_ptr;
+        typedef __btree_leaf_node<Key, Value, leaf_capacity> leaf_node;
+        typedef __btree_internal_node<Key, internal_capacity> internal_node;
+        typedef simple_alloc<leaf_node, Alloc> leaf_allocator;
+        typedef simple_alloc<internal_node, Alloc> internal_allocator;
+        typedef __btree_search<Key, Compare> search;
+
+        // 不足半满时需要调整
+        enum {
+            leaf_min = leaf_capacity / 2,
+            internal_min = internal_capacity / 2
+        };
+
+    public:
+        typedef __btree_iterator<value_type, reference, pointer, leaf_node> iterator;
+        typedef __btree_iterator<value_type, const_reference, const_pointer, leaf_node> const_iterator;
+
+    protected:
+        base_ptr root;
+        leaf_node* leftmost; // 最左 (最小) 的叶节点
+        leaf_node* rightmost; // 最右 (最大) 的叶节点
+        size_type node_count; // 元素个数
+        Compare key_compare;
+
+        // 分裂时需要的新节点, 在改动树之前一次申请好, 申请失败时树保持不变
+        struct __spare_nodes {
+            leaf_node* leaf;
+            internal_node* internal[__btree_max_height];
+            int n;
+        };
+
+        static leaf_node* new_leaf() {
+            leaf_node* x = leaf_allocator::allocate();
+            x->parent = nullptr;
+            x->position = 0;
+            x->count = 0;
+            x->leaf = true;
+            x->prev = x->next = nullptr;
+            return x;
+        }
+        static void init_internal(internal_node* x) {
+            x->parent = nullptr;
+            x->position = 0;
+            x->count = 0;
+            x->leaf = false;
+        }
+        static const key_type& key(const value_type& v) { return KeyOfValue()(v); }
+
+        // 把 children[first, count] 的父节点与下标重新设好
+        static void fix_children(internal_node* x, int first) {
+            for (int i = first; i <= x->count; ++i) {
+                x->children[i]->parent = x;
+                x->children[i]->position = (unsigned short) i;
+            }
+        }
+
+        template <class K>
+        leaf_node* __find_leaf(const K& k) const;
+        template <class K>
+        iterator __lower_bound(const K& k) const;
+        template <class K>
+        iterator __find(const K& k) const {
+            iterator j = __lower_bound(k);
+            return (j == __end() || key_compare(k, key(*j))) ? __end() : j;
+        }
+        iterator __end() const { return iterator(rightmost, rightmost ? rightmost->count : 0); }
+        void __reserve(leaf_node* x, __spare_nodes& spare);
+        void __release(__spare_nodes& spare);
+        iterator __split_leaf(leaf_node* x, int position, const key_type& k, __spare_nodes& spare);
+        void __insert_parent(base_ptr left, const key_type& k, base_ptr right, __spare_nodes& spare);
+        template <class... Args>
+        iterator __insert_at(leaf_node* x, int position, const key_type& k, Args&&... args);
+        void __rebalance_leaf(leaf_node* x);
+        void __rebalance_internal(internal_node* x);
+        void __remove_child(internal_node* parent, int i); // 删除 keys[i] 和 children[i + 1]
+        void __destroy_subtree(base_ptr x);
+        void __copy_from(const btree<Key, Value, KeyOfValue, Compare, Alloc>& x);
+        void __reset() {
+            root = nullptr;
+            leftmost = rightmost = nullptr;
+            node_count = 0;
+        }
+
+    public:
+        btree(const Compare& comp = Compare()) : root(nullptr), leftmost(nullptr), rightmost(nullptr),
+                                                 node_count(0), key_compare(comp) { }
+        btree(const btree<Key, Value, KeyOfValue, Compare, Alloc>& x)
+            : root(nullptr), leftmost(nullptr), rightmost(nullptr), node_count(0), key_compare(x.key_compare) {
+            __copy_from(x);
+        }
+        btree(btree<Key, Value, KeyOfValue, Compare, Alloc>&& x)
+            : root(x.root), leftmost(x.leftmost), rightmost(x.rightmost), node_count(x.node_count), key_compare(x.key_compare) {
+            x.__reset();
+        }
+        ~btree() {
+            clear();
+        }
+        btree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(const btree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
+            if (this != &x) {
+                btree<Key, Value, KeyOfValue, Compare, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        btree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(btree<Key, Value, KeyOfValue, Compare, Alloc>&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(btree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
+            LI::swap(root, x.root);
+            LI::swap(leftmost, x.leftmost);
+            LI::swap(rightmost, x.rightmost);
+            LI::swap(node_count, x.node_count);
+            LI::swap(key_compare, x.key_compare);
+        }
+
+        Compare key_comp() const { return key_compare; }
+        iterator begin() { return iterator(leftmost, 0); }
+        iterator end() { return __end(); }
+        const_iterator begin() const { return const_iterator(leftmost, 0); }
+        const_iterator end() const { return __end(); }
+        bool empty() const { return node_count == 0; }
+        size_type size() const { return node_count; }
+        size_type max_size() const { return size_type(-1); }
+
+        void clear() {
+            if (root != nullptr) {
+                __destroy_subtree(root);
+                __reset();
+            }
+        }
+
+        // 插入 ------------------------------------------------------
+        pair<iterator, bool> insert_unique(const value_type& v) {
+            return try_emplace_unique(key(v), v);
+        }
+        pair<iterator, bool> insert_unique(value_type&& v) {
+            return try_emplace_unique(key(v), LI::move(v));
+        }
+        iterator insert_unique(iterator position, const value_type& v) {
+            return try_emplace_hint_unique(position, key(v), v);
+        }
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for ( ; first != last; ++first) {
+                insert_unique(end(), *first); // 已排序的输入直接追加到最右端
+            }
+        }
+        // 先构造元素再查找位置, 键值重复时元素被丢弃
+        template <class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args) {
+            value_type v(LI::forward<Args>(args)...);
+            return try_emplace_unique(key(v), LI::move(v));
+        }
+        template <class... Args>
+        iterator emplace_hint_unique(iterator position, Args&&... args) {
+            value_type v(LI::forward<Args>(args)...);
+            return try_emplace_hint_unique(position, key(v), LI::move(v));
+        }
+        // 键值 k 不存在时才以 args 构造元素
+        template <class... Args>
+        pair<iterator, bool> try_emplace_unique(const key_type& k, Args&&... args);
+        // 提示位置正确 (紧接在 k 之后) 时不需要从根下降
+        template <class... Args>
+        iterator try_emplace_hint_unique(iterator position, const key_type& k, Args&&... args);
+
+        // 删除 ------------------------------------------------------
+        // 返回被删元素的下一个元素
+        iterator erase(iterator position);
+        size_type erase(const key_type& k) {
+            iterator i = __find(k);
+            if (i == end()) return 0;
+            erase(i);
+            return 1;
+        }
+        void erase(iterator first, iterator last);
+
+        // 查找 ------------------------------------------------------
+        iterator find(const key_type& k) { return __find(k); }
+        const_iterator find(const key_type& k) const { return __find(k); }
+        size_type count(const key_type& k) const { return __find(k) == end() ? 0 : 1; }
+        iterator lower_bound(const key_type& k) { return __lower_bound(k); }
+        const_iterator lower_bound(const key_type& k) const { return __lower_bound(k); }
+        iterator upper_bound(const key_type& k) {
+            iterator j = __lower_bound(k);
+            if (j != end() && !key_compare(k, key(*j))) ++j;
+            return j;
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return const_cast<btree*>(this)->upper_bound(k);
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+
+        // 异构查找, 条件与 rb_tree 相同
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& k) { return __find(k); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type find(const K& k) const { return __find(k); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& k) const {
+            return __find(k) == __end() ? 0 : 1;
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& k) {
+            iterator i = __find(k);
+            if (i == end()) return 0;
+            erase(i);
+            return 1;
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& k) { return __lower_bound(k); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type lower_bound(const K& k) const { return __lower_bound(k); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& k) {
+            iterator j = __lower_bound(k);
+            if (j != end() && !key_compare(k, key(*j))) ++j;
+            return j;
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type upper_bound(const K& k) const {
+            return const_cast<btree*>(this)->upper_bound(k);
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<const_iterator, const_iterator> >::type equal_range(const K& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+
+        // 内存占用 (字节), 包括全部节点
+        size_type memory_usage() const { return __memory_usage(root); }
+
+    protected:
+        size_type __memory_usage(base_ptr x) const {
+            if (x == nullptr) return 0;
+            if (x->leaf) return sizeof(leaf_node);
+            internal_node* y = static_cast<internal_node*>(x);
+            size_type n = sizeof(internal_node);
+            for (int i = 0; i <= y->count; ++i) {
+                n += __memory_usage(y->children[i]);
+            }
+            return n;
+        }
+    };
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    inline void swap(btree<Key, Value, KeyOfValue, Compare, Alloc>& x, btree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+
+    // 从根下降到 k 所在的叶节点; 分隔键值等于 k 时走右边, 因此 k 若存在一定在这个叶节点中
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::leaf_node*
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::__find_leaf(const K& k) const {
+        base_ptr x = root;
+        if (x == nullptr) return nullptr;
+        while (!x->leaf) {
+            internal_node* y = static_cast<internal_node*>(x);
+            int i = search::lower(y->keys(), y->count, k, key_compare);
+            if (i < y->count && !key_compare(k, y->keys()[i])) ++i; // 分隔键值互不相同
+            x = y->children[i];
+            __LI_PREFETCH(x);
+        }
+        return static_cast<leaf_node*>(x);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::__lower_bound(const K& k) const {
+        leaf_node* x = __find_leaf(k);
+        if (x == nullptr) return iterator();
+        int i = search::lower(x->keys(), x->count, k, key_compare);
+        if (i == x->count && x->next != nullptr) { // 在下一个叶节点的开头
+            return iterator(x->next, 0);
+        }
+        return iterator(x, i);
+    }
+
+    // 从叶节点 x 往上数出分裂需要的节点个数, 全部申请好
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__reserve(leaf_node* x, __spare_nodes& spare) {
+        // 一路向上的满节点各需一个新节点, 都满时 (或 x 就是根) 再加一个新根
+        int need = 0;
+        base_ptr p = x->parent;
+        while (p != nullptr && p->count == internal_capacity) {
+            ++need;
+            p = p->parent;
+        }
+        if (p == nullptr) ++need;
+
+        spare.n = 0;
+        spare.leaf = leaf_allocator::allocate();
+        try {
+            for ( ; spare.n < need; ++spare.n) {
+                spare.internal[spare.n] = internal_allocator::allocate();
+            }
+        }
+        catch(...) {
+            __release(spare);
+            throw;
+        }
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__release(__spare_nodes& spare) {
+        if (spare.leaf) leaf_allocator::deallocate(spare.leaf);
+        while (spare.n > 0) {
+            internal_allocator::deallocate(spare.internal[--spare.n]);
+        }
+    }
+
+    // 分裂满的叶节点 x, 返回插入位置 position 在分裂后所在的 (叶节点, 下标)
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::__split_leaf(leaf_node* x, int position, const key_type& k,
+                                                               __spare_nodes& spare) {
+        leaf_node* y = spare.leaf;
+        spare.leaf = nullptr;
+        y->parent = nullptr;
+        y->position = 0;
+        y->count = 0;
+        y->leaf = true;
+        // 接在 x 之后
+        y->prev = x;
+        y->next = x->next;
+        if (x->next) x->next->prev = y;
+        else rightmost = y;
+        x->next = y;
+
+        int split;
+        if (position == leaf_capacity && y->next == nullptr) {
+            split = leaf_capacity; // 追加到最右端, x 保持全满
+        }
+        else if (position == 0 && x->prev == nullptr) {
+            split = 0; // 插入到最左端, 原有的元素全部移到 y
+        }
+        else {
+            split = (leaf_capacity + 1) / 2;
+        }
+        int n = x->count - split;
+        __btree_relocate(x->keys() + split, x->keys() + x->count, y->keys());
+        __btree_relocate(x->values() + split, x->values() + x->count, y->values());
+        x->count = (unsigned short) split;
+        y->count = (unsigned short) n;
+
+        iterator result;
+        if (position < split || (position == split && split != leaf_capacity)) {
+            result = iterator(x, position);
+        }
+        else {
+            result = iterator(y, position - split);
+        }
+        // y 的第一个键值作为分隔键值 (新元素将成为 y 的第一个元素时就是 k)
+        const key_type& separator = (result.node == y && result.position == 0) ? k : y->keys()[0];
+        __insert_parent(x, separator, y, spare);
+        return result;
+    }
+
+    // 在 left 之后插入分隔键值 k 和新的兄弟节点 right, 父节点满了就继续分裂
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_parent(base_ptr left, const key_type& k, base_ptr right,
+                                                                       __spare_nodes& spare) {
+        internal_node* p = static_cast<internal_node*>(left->parent);
+        if (p == nullptr) { // left 是根, 长出一个新根
+            internal_node* r = spare.internal[--spare.n];
+            init_internal(r);
+            construct(r->keys(), k);
+            r->count = 1;
+            r->children[0] = left;
+            r->children[1] = right;
+            fix_children(r, 0);
+            root = r;
+            return;
+        }
+        int i = left->position; // k 插入到 keys[i], right 成为 children[i + 1]
+        internal_node* target = p;
+        if (p->count == internal_capacity) {
+            // 先把 p 分成两半, keys[mid] 上升到祖父节点
+            internal_node* q = spare.internal[--spare.n];
+            init_internal(q);
+            int mid = internal_capacity / 2;
+            int n = p->count - mid - 1;
+            __btree_relocate(p->keys() + mid + 1, p->keys() + p->count, q->keys());
+            memcpy(q->children, p->children + mid + 1, (n + 1) * sizeof(base_ptr));
+            q->count = (unsigned short) n;
+            fix_children(q, 0);
+            key_type up(LI::move(p->keys()[mid]));
+            destroy(p->keys() + mid);
+            p->count = (unsigned short) mid;
+            if (i > mid) {
+                target = q;
+                i -= mid + 1;
+            }
+            __insert_parent(p, up, q, spare); // 之后 target 一定有空位
+        }
+        __btree_relocate(target->keys() + i, target->keys() + target->count, target->keys() + i + 1);
+        construct(target->keys() + i, k);
+        memmove(target->children + i + 2, target->children + i + 1, (target->count - i) * sizeof(base_ptr));
+        target->children[i + 1] = right;
+        ++target->count;
+        fix_children(target, i + 1);
+    }
+
+    // 在叶节点 x 的 position 处以 args 构造元素, k 是其键值
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_at(leaf_node* x, int position, const key_type& k, Args&&... args) {
+        if (x == nullptr) { // 空树
+            x = new_leaf();
+            root = leftmost = rightmost = x;
+        }
+        else if (x->count == leaf_capacity) {
+            __spare_nodes spare;
+            __reserve(x, spare);
+            iterator pos = __split_leaf(x, position, k, spare);
+            __release(spare);
+            x = pos.node;
+            position = pos.position;
+        }
+        // 腾出 position 处的位置; 元素构造失败时再合上, 树的结构仍然有效
+        __btree_relocate(x->keys() + position, x->keys() + x->count, x->keys() + position + 1);
+        __btree_relocate(x->values() + position, x->values() + x->count, x->values() + position + 1);
+        try {
+            construct(x->keys() + position, k); // 先复制键值: args 可能会把 k 移走
+            try {
+                construct(x->values() + position, LI::forward<Args>(args)...);
+            }
+            catch(...) {
+                destroy(x->keys() + position);
+                throw;
+            }
+        }
+        catch(...) {
+            __btree_relocate(x->keys() + position + 1, x->keys() + x->count + 1, x->keys() + position);
+            __btree_relocate(x->values() + position + 1, x->values() + x->count + 1, x->values() + position);
+            if (node_count == 0) { // 空树时新建的叶节点
+                leaf_allocator::deallocate(x);
+                __reset();
+            }
+            else if (x->count == 0) { // 分裂出的空叶节点, 与兄弟节点合并掉
+                __rebalance_leaf(x);
+            }
+            throw;
+        }
+        ++x->count;
+        ++node_count;
+        return iterator(x, position);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    pair<typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool>
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::try_emplace_unique(const key_type& k, Args&&... args) {
+        leaf_node* x = __find_leaf(k);
+        int i = 0;
+        if (x != nullptr) {
+            i = search::lower(x->keys(), x->count, k, key_compare);
+            if (i < x->count && !key_compare(k, x->keys()[i])) { // 已存在
+                return pair<iterator, bool>(iterator(x, i), false);
+            }
+        }
+        return pair<iterator, bool>(__insert_at(x, i, k, LI::forward<Args>(args)...), true);
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::try_emplace_hint_unique(iterator position, const key_type& k, Args&&... args) {
+        if (position == end()) {
+            // 比最大的键值还大, 追加到最右端
+            if (node_count > 0 && key_compare(rightmost->keys()[rightmost->count - 1], k)) {
+                return __insert_at(rightmost, rightmost->count, k, LI::forward<Args>(args)...);
+            }
+        }
+        else if (position.position > 0) {
+            // 提示位置与前一个元素在同一个叶节点中, 且 k 恰好介于两者之间
+            leaf_node* x = position.node;
+            if (key_compare(x->keys()[position.position - 1], k) && key_compare(k, x->keys()[position.position])) {
+                return __insert_at(x, position.position, k, LI::forward<Args>(args)...);
+            }
+        }
+        return try_emplace_unique(k, LI::forward<Args>(args)...).first;
+    }
+
+    // 删除父节点的 keys[i] 和 children[i + 1] (children[i + 1] 已并入 children[i])
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__remove_child(internal_node* p, int i) {
+        destroy(p->keys() + i);
+        __btree_relocate(p->keys() + i + 1, p->keys() + p->count, p->keys() + i);
+        memmove(p->children + i + 1, p->children + i + 2, (p->count - i - 1) * sizeof(base_ptr));
+        --p->count;
+        fix_children(p, i + 1);
+        if (p == root) {
+            if (p->count == 0) { // 根只剩一个子节点, 树变矮
+                root = p->children[0];
+                root->parent = nullptr;
+                root->position = 0;
+                internal_allocator::deallocate(p);
+            }
+        }
+        else if (p->count < internal_min) {
+            __rebalance_internal(p);
+        }
+    }
+
+    // 叶节点 x 不足半满: 能与兄弟节点合并就合并, 否则向兄弟节点借一个元素
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__rebalance_leaf(leaf_node* x) {
+        internal_node* p = static_cast<internal_node*>(x->parent);
+        int i = x->position;
+        leaf_node* left = i > 0 ? static_cast<leaf_node*>(p->children[i - 1]) : nullptr;
+        leaf_node* right = i < p->count ? static_cast<leaf_node*>(p->children[i + 1]) : nullptr;
+
+        if (left && left->count + x->count <= leaf_capacity) { // x 并入 left
+            __btree_relocate(x->keys(), x->keys() + x->count, left->keys() + left->count);
+            __btree_relocate(x->values(), x->values() + x->count, left->values() + left->count);
+            left->count += x->count;
+            left->next = x->next;
+            if (x->next) x->next->prev = left;
+            else rightmost = left;
+            leaf_allocator::deallocate(x);
+            __remove_child(p, i - 1);
+        }
+        else if (right && x->count + right->count <= leaf_capacity) { // right 并入 x
+            __btree_relocate(right->keys(), right->keys() + right->count, x->keys() + x->count);
+            __btree_relocate(right->values(), right->values() + right->count, x->values() + x->count);
+            x->count += right->count;
+            x->next = right->next;
+            if (right->next) right->next->prev = x;
+            else rightmost = x;
+            leaf_allocator::deallocate(right);
+            __remove_child(p, i);
+        }
+        else if (left) { // 借 left 的最后一个
+            __btree_relocate(x->keys(), x->keys() + x->count, x->keys() + 1);
+            __btree_relocate(x->values(), x->values() + x->count, x->values() + 1);
+            --left->count;
+            __btree_relocate(left->keys() + left->count, left->keys() + left->count + 1, x->keys());
+            __btree_relocate(left->values() + left->count, left->values() + left->count + 1, x->values());
+            ++x->count;
+            p->keys()[i - 1] = x->keys()[0];
+        }
+        else if (right) { // 借 right 的第一个
+            __btree_relocate(right->keys(), right->keys() + 1, x->keys() + x->count);
+            __btree_relocate(right->values(), right->values() + 1, x->values() + x->count);
+            ++x->count;
+            __btree_relocate(right->keys() + 1, right->keys() + right->count, right->keys());
+            __btree_relocate(right->values() + 1, right->values() + right->count, right->values());
+            --right->count;
+            p->keys()[i] = right->keys()[0];
+        }
+    }
+
+    // 内部节点 x 不足半满, 做法与叶节点相同, 只是分隔键值要经过父节点转一圈
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__rebalance_internal(internal_node* x) {
+        internal_node* p = static_cast<internal_node*>(x->parent);
+        int i = x->position;
+        internal_node* left = i > 0 ? static_cast<internal_node*>(p->children[i - 1]) : nullptr;
+        internal_node* right = i < p->count ? static_cast<internal_node*>(p->children[i + 1]) : nullptr;
+
+        if (left && left->count + 1 + x->count <= internal_capacity) { // left + 分隔键值 + x
+            construct(left->keys() + left->count, p->keys()[i - 1]);
+            __btree_relocate(x->keys(), x->keys() + x->count, left->keys() + left->count + 1);
+            memcpy(left->children + left->count + 1, x->children, (x->count + 1) * sizeof(base_ptr));
+            int first = left->count + 1;
+            left->count += 1 + x->count;
+            fix_children(left, first);
+            internal_allocator::deallocate(x);
+            __remove_child(p, i - 1);
+        }
+        else if (right && x->count + 1 + right->count <= internal_capacity) { // x + 分隔键值 + right
+            construct(x->keys() + x->count, p->keys()[i]);
+            __btree_relocate(right->keys(), right->keys() + right->count, x->keys() + x->count + 1);
+            memcpy(x->children + x->count + 1, right->children, (right->count + 1) * sizeof(base_ptr));
+            int first = x->count + 1;
+            x->count += 1 + right->count;
+            fix_children(x, first);
+            internal_allocator::deallocate(right);
+            __remove_child(p, i);
+        }
+        else if (left) { // 父节点的分隔键值下移到 x 的开头, left 的最后一个键值上移
+            __btree_relocate(x->keys(), x->keys() + x->count, x->keys() + 1);
+            construct(x->keys(), p->keys()[i - 1]);
+            memmove(x->children + 1, x->children, (x->count + 1) * sizeof(base_ptr));
+            x->children[0] = left->children[left->count];
+            ++x->count;
+            fix_children(x, 0);
+            p->keys()[i - 1] = left->keys()[left->count - 1];
+            destroy(left->keys() + left->count - 1);
+            --left->count;
+        }
+        else if (right) { // 父节点的分隔键值下移到 x 的末尾, right 的第一个键值上移
+            construct(x->keys() + x->count, p->keys()[i]);
+            x->children[x->count + 1] = right->children[0];
+            ++x->count;
+            fix_children(x, x->count);
+            p->keys()[i] = right->keys()[0];
+            destroy(right->keys());
+            __btree_relocate(right->keys() + 1, right->keys() + right->count, right->keys());
+            memmove(right->children, right->children + 1, right->count * sizeof(base_ptr));
+            --right->count;
+            fix_children(right, 0);
+        }
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename btree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    btree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator position) {
+        leaf_node* x = position.node;
+        int i = position.position;
+        bool underflow = x != root && x->count - 1 < leaf_min;
+        // 需要调整时元素会在节点间移动, 先记下后继的键值, 调整之后再找回来
+        bool has_next = i + 1 < x->count || x->next != nullptr;
+        alignas(key_type) unsigned char next_buf[sizeof(key_type)];
+        key_type* next_key = reinterpret_cast<key_type*>(next_buf);
+        if (underflow && has_next) {
+            construct(next_key, i + 1 < x->count ? x->keys()[i + 1] : x->next->keys()[0]);
+        }
+
+        destroy(x->keys() + i);
+        destroy(x->values() + i);
+        __btree_relocate(x->keys() + i + 1, x->keys() + x->count, x->keys() + i);
+        __btree_relocate(x->values() + i + 1, x->values() + x->count, x->values() + i);
+        --x->count;
+        --node_count;
+
+        if (x == root) {
+            if (x->count == 0) {
+                leaf_allocator::deallocate(x);
+                __reset();
+                return end();
+            }
+            return (i == x->count) ? end() : iterator(x, i);
+        }
+        if (!underflow) {
+            if (i == x->count && x->next != nullptr) return iterator(x->next, 0);
+            return iterator(x, i);
+        }
+        __rebalance_leaf(x);
+        if (!has_next) return end();
+        iterator result = __lower_bound(*next_key);
+        destroy(next_key);
+        return result;
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator first, iterator last) {
+        if (first == begin() && last == end()) {
+            clear();
+            return;
+        }
+        // 每次删除后迭代器会失效, 以个数控制
+        size_type n = 0;
+        for (iterator i = first; i != last; ++i) {
+            ++n;
+        }
+        while (n--) {
+            first = erase(first);
+        }
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__destroy_subtree(base_ptr x) {
+        if (x->leaf) {
+            leaf_node* y = static_cast<leaf_node*>(x);
+            destroy(y->keys(), y->keys() + y->count);
+            destroy(y->values(), y->values() + y->count);
+            leaf_allocator::deallocate(y);
+        }
+        else {
+            internal_node* y = static_cast<internal_node*>(x);
+            for (int i = 0; i <= y->count; ++i) {
+                __destroy_subtree(y->children[i]);
+            }
+            destroy(y->keys(), y->keys() + y->count);
+            internal_allocator::deallocate(y);
+        }
+    }
+
+    // 逐个追加到最右端, 得到的叶节点都是满的
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void btree<Key, Value, KeyOfValue, Compare, Alloc>::__copy_from(const btree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
+        try {
+            for (const_iterator i = x.begin(); i != x.end(); ++i) {
+                __insert_at(rightmost, rightmost ? rightmost->count : 0, key(*i), *i);
+            }
+        }
+        catch(...) {
+            clear();
+            throw;
+        }
+    }
+
+}
+
+
+#endif
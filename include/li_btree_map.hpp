@@ -0,0 +1,228 @@
+#ifndef LI_BTREE_MAP_H_
+#define LI_BTREE_MAP_H_
+
+#include "li_btree.hpp"
+#include "li_frozen_map.hpp"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+
+
+// btree_map: 接口与 map 相同, 底层以 B+ 树代替红黑树
+// 一个节点存放几十个元素, 树的高度只有红黑树的几分之一, 查找时访问的缓存行少得多,
+// 也省去了每个元素三个指针加颜色的开销
+// 代价是插入和删除会使所有迭代器失效 (map 只会使被删元素的迭代器失效), 因此 erase 返回下一个元素;
+// 也没有节点把手 (extract / merge), 元素并不单独占有节点
+namespace LI {
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class btree_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+
+        class value_compare : public binary_function<value_type, value_type, bool> {
+        public:
+            friend class btree_map<Key, T, Compare, Alloc>;
+            bool operator()(const value_type& x, const value_type& y) const {
+                return comp(x.first, y.first);
+            }
+        protected:
+            Compare comp;
+            value_compare(Compare c) : comp(c) { }
+        };
+
+    private:
+        typedef btree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+        rep_type t; // B+ 树对象
+
+    public:
+        typedef typename rep_type::pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        typedef typename rep_type::iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+
+        btree_map() : t(Compare()) { }
+        explicit btree_map(const Compare& comp) : t(comp) { }
+        // 以区间构造, 已排序的输入每次都追加到最右端
+        template <class InputIterator>
+        btree_map(InputIterator first, InputIterator last) : t(Compare()) {
+            t.insert_unique(first, last);
+        }
+        // 调用者保证区间按键值严格递增, 逐个追加, 叶节点都是满的
+        template <class InputIterator>
+        btree_map(InputIterator first, InputIterator last, sorted_unique_tag) : t(Compare()) {
+            for ( ; first != last; ++first) {
+                t.insert_unique(t.end(), *first);
+            }
+        }
+
+        btree_map(const btree_map<Key, T, Compare, Alloc>& x) : t(x.t) { }
+        btree_map(btree_map<Key, T, Compare, Alloc>&& x) : t(LI::move(x.t)) { }
+
+        ~btree_map() { }
+
+        btree_map<Key, T, Compare, Alloc>& operator=(const btree_map<Key, T, Compare, Alloc>& x) {
+            t = x.t;
+            return *this;
+        }
+        btree_map<Key, T, Compare, Alloc>& operator=(btree_map<Key, T, Compare, Alloc>&& x) {
+            t = LI::move(x.t);
+            return *this;
+        }
+        void swap(btree_map<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return value_compare(t.key_comp()); }
+        iterator begin() { return t.begin(); }
+        iterator end() { return t.end(); }
+        const_iterator begin() const { return t.begin(); }
+        const_iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+        T& operator[] (const key_type& k) {
+            return (*try_emplace(k).first).second;
+        }
+        T& operator[] (key_type&& k) {
+            return (*try_emplace(LI::move(k)).first).second;
+        }
+
+        // 原地构造 ---------------------------------------------
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return t.emplace_unique(LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            return t.emplace_hint_unique(position, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+            return t.try_emplace_unique(k, __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+            return t.try_emplace_unique(k, __piecewise_construct_t(), LI::move(k), LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator try_emplace(iterator position, const key_type& k, Args&&... args) {
+            return t.try_emplace_hint_unique(position, k, __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator try_emplace(iterator position, key_type&& k, Args&&... args) {
+            return t.try_emplace_hint_unique(position, k, __piecewise_construct_t(), LI::move(k), LI::forward<Args>(args)...);
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(k, LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(LI::move(k), LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        template <class M>
+        iterator insert_or_assign(iterator position, const key_type& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, k, LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
+        }
+        template <class M>
+        iterator insert_or_assign(iterator position, key_type&& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, LI::move(k), LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
+        }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            return t.insert_unique(x);
+        }
+        pair<iterator, bool> insert(value_type&& x) {
+            return t.insert_unique(LI::move(x));
+        }
+        // 提示位置是 end() 且 x 大于所有键值, 或 x 恰好应插在提示位置之前 (同一叶节点内) 时不需要查找
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_unique(position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            t.insert_unique(first, last);
+        }
+        // 删除后原有的迭代器都失效, 返回被删元素的下一个元素
+        iterator erase(iterator position) { return t.erase(position); }
+        size_type erase(const key_type& k) { return t.erase(k); }
+        void erase(iterator first, iterator last) { t.erase(first, last); }
+        void clear() { t.clear(); }
+        iterator find(const key_type& x) { return t.find(x); }
+        const_iterator find(const key_type& x) const { return t.find(x); }
+
+        // 区间查找
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+        const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        // 异构查找: Compare 带有 is_transparent (如 less<void>) 时接受任何能与 Key 比较的型别
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& x) { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type find(const K& x) const { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& x) const { return t.count(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& x) { return t.erase(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& x) { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type lower_bound(const K& x) const { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& x) { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type upper_bound(const K& x) const { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& x) { return t.equal_range(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<const_iterator, const_iterator> >::type equal_range(const K& x) const { return t.equal_range(x); }
+
+        // 生成只读快照, O(n)
+        frozen_map<Key, T, Compare, Alloc> freeze() const {
+            return frozen_map<Key, T, Compare, Alloc>(begin(), end(), sorted_unique_tag(), key_comp());
+        }
+
+        // 全部节点占用的内存 (字节)
+        size_type memory_usage() const { return t.memory_usage(); }
+    };
+
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(btree_map<Key, T, Compare, Alloc>& x, btree_map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,438 @@
+#ifndef LI_CONCURRENT_MAP_H_
+#define LI_CONCURRENT_MAP_H_
+
+#include "li_rbtree.hpp"
+#include "li_map.hpp"
+#include "li_vector.hpp"
+#include "li_heap.h"
+#include "li_algorithm.h"
+#include "li_lock.h"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+
+
+// concurrent_map: 多个线程共用的有序 map
+// 键值分到 Shards 棵互相独立的红黑树 (分片) 中, 每个分片有自己的读写锁:
+// 读者之间不互斥, 写者只锁住一个分片, 不同分片上的读写互不影响
+// 分片的方式由 Partition 决定:
+//   hash_partition  按键值的哈希值分片, 点查找和修改分散得最均匀; 按次序遍历时要同时锁住所有分片, 归并各分片
+//   range_partition 按键值的区间分片, 前一个分片的键值都小于后一个分片; 区间遍历只锁住涉及的分片
+// 元素不以迭代器或引用交给调用者 (离开锁之后可能已被删除): 查找时复制出实值, 或在锁内调用函数对象;
+// 函数对象在锁内执行, 不能再修改同一个 concurrent_map
+// 节点默认由 threads_alloc 配置, 不同分片的写者在配置节点时仍会短暂地互斥
+namespace LI {
+
+    // 按哈希值分片
+    template <class Key, class HashFcn = hash<Key> >
+    struct hash_partition {
+        typedef __false_type ordered; // 分片的次序与键值的次序无关
+        HashFcn hash;
+        hash_partition(const HashFcn& hf = HashFcn()) : hash(hf) { }
+        size_t operator()(const Key& k, size_t n) const { return hash(k) % n; }
+    };
+
+    // 按区间分片: bounds 是递增的分界键值, 小于 bounds[0] 的在第 0 个分片,
+    // 不小于 bounds[i - 1] 且小于 bounds[i] 的在第 i 个分片; 分界键值应为 Shards - 1 个, 多出的部分并入最后一个分片
+    // Compare 须与 concurrent_map 的 Compare 一致
+    template <class Key, class Compare = less<Key> >
+    struct range_partition {
+        typedef __true_type ordered; // 第 i 个分片的键值都小于第 i + 1 个分片
+        vector<Key, threads_alloc> bounds;
+        Compare comp;
+        range_partition() { }
+        template <class InputIterator>
+        range_partition(InputIterator first, InputIterator last, const Compare& c = Compare()) : comp(c) {
+            for ( ; first != last; ++first) {
+                bounds.push_back(*first);
+            }
+        }
+        size_t operator()(const Key& k, size_t n) const {
+            size_t i = LI::upper_bound(bounds.begin(), bounds.end(), k, comp) - bounds.begin();
+            return i < n ? i : n - 1;
+        }
+    };
+
+    template <class Key, class T, size_t Shards = 16, class Partition = hash_partition<Key>,
+              class Compare = less<Key>, class Alloc = threads_alloc>
+    class concurrent_map {
+        static_assert(Shards > 0, "concurrent_map needs at least one shard");
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        typedef Partition partitioner;
+        typedef size_t size_type;
+        typedef map<Key, T, Compare, Alloc> snapshot_type;
+
+    private:
+        typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+        typedef typename rep_type::iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef __lock_guard<__rw_spin_lock> write_guard;
+        typedef __shared_lock_guard<__rw_spin_lock> read_guard;
+
+        // 每个分片之后留出一个缓存行, 相邻分片的锁不会落在同一缓存行上
+        struct shard {
+            mutable __rw_spin_lock lock;
+            rep_type tree;
+            char pad[64];
+        };
+
+        Partition part;
+        shard shards[Shards];
+
+        size_type shard_index(const key_type& k) const { return part(k, Shards); }
+
+        // 按分片的编号依次对 [first, last) 加读锁, 所有多分片的操作都按同一次序加锁, 不会死锁
+        class read_range_guard {
+        private:
+            const shard* first;
+            const shard* last;
+        public:
+            read_range_guard(const shard* f, const shard* l) : first(f), last(l) {
+                for (const shard* s = first; s != last; ++s) {
+                    s->lock.lock_shared();
+                }
+            }
+            ~read_range_guard() {
+                for (const shard* s = first; s != last; ++s) {
+                    s->lock.unlock_shared();
+                }
+            }
+            read_range_guard(const read_range_guard&) = delete;
+            read_range_guard& operator=(const read_range_guard&) = delete;
+        };
+
+        // 把 n 个元素按分片分组 (计数排序): 第 i 个分片的元素是 order[start[i] .. start[i + 1])
+        template <class E, class KeyOfE>
+        void __group(const E* elems, size_type n, KeyOfE key_of, const E** order, size_type* start) const;
+
+        // 以堆归并各分片时比较两个分片当前位置的键值, 堆顶是键值最小的分片
+        struct __merge_compare {
+            const const_iterator* cur;
+            key_compare comp;
+            bool operator()(size_type a, size_type b) const { return comp((*cur[b]).first, (*cur[a]).first); }
+        };
+        // 按键值递增访问分片 [lo, hi) 中 [*first, *last) 的元素 (指针为空表示不限), 调用者已加锁
+        template <class F>
+        void __visit_ordered(size_type lo, size_type hi, const key_type* first, const key_type* last, F& f, __true_type) const;
+        template <class F>
+        void __visit_ordered(size_type lo, size_type hi, const key_type* first, const key_type* last, F& f, __false_type) const;
+        // 区间 [first, last] 涉及的分片
+        pair<size_type, size_type> __shards_of(const key_type& first, const key_type& last, __true_type) const {
+            return pair<size_type, size_type>(shard_index(first), shard_index(last) + 1);
+        }
+        pair<size_type, size_type> __shards_of(const key_type&, const key_type&, __false_type) const {
+            return pair<size_type, size_type>(0, Shards);
+        }
+
+    public:
+        explicit concurrent_map(const Partition& p = Partition()) : part(p) { }
+        ~concurrent_map() { }
+        concurrent_map(const concurrent_map&) = delete;
+        concurrent_map& operator=(const concurrent_map&) = delete;
+
+        key_compare key_comp() const { return shards[0].tree.key_comp(); }
+        const partitioner& partition() const { return part; }
+        static size_type shard_count() { return Shards; }
+
+        // 各分片的元素个数之和; 逐个分片加读锁, 其他线程同时修改时只是近似值
+        size_type size() const {
+            size_type n = 0;
+            for (size_type i = 0; i < Shards; ++i) {
+                read_guard guard(shards[i].lock);
+                n += shards[i].tree.size();
+            }
+            return n;
+        }
+        bool empty() const {
+            for (size_type i = 0; i < Shards; ++i) {
+                read_guard guard(shards[i].lock);
+                if (!shards[i].tree.empty()) return false;
+            }
+            return true;
+        }
+        // 逐个分片清空
+        void clear() {
+            for (size_type i = 0; i < Shards; ++i) {
+                write_guard guard(shards[i].lock);
+                shards[i].tree.clear();
+            }
+        }
+
+        // 单个键值的操作: 只锁住键值所在的分片 ------------------------------
+        // 插入成功时返回 true, 键值已存在时不改变原有的元素
+        bool insert(const value_type& x) {
+            shard& s = shards[shard_index(x.first)];
+            write_guard guard(s.lock);
+            return s.tree.insert_unique(x).second;
+        }
+        bool insert(value_type&& x) {
+            shard& s = shards[shard_index(x.first)];
+            write_guard guard(s.lock);
+            return s.tree.try_emplace_unique(x.first, LI::move(x)).second;
+        }
+        template <class... Args>
+        bool try_emplace(const key_type& k, Args&&... args) {
+            shard& s = shards[shard_index(k)];
+            write_guard guard(s.lock);
+            return s.tree.try_emplace_unique(k, __piecewise_construct_t(), k, LI::forward<Args>(args)...).second;
+        }
+        // 键值已存在时改写实值; 返回是否新插入
+        template <class M>
+        bool insert_or_assign(const key_type& k, M&& obj) {
+            shard& s = shards[shard_index(k)];
+            write_guard guard(s.lock);
+            pair<iterator, bool> r = s.tree.try_emplace_unique(k, __piecewise_construct_t(), k, LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r.second;
+        }
+        size_type erase(const key_type& k) {
+            shard& s = shards[shard_index(k)];
+            write_guard guard(s.lock);
+            return s.tree.erase(k);
+        }
+
+        // 找到时把实值复制到 result
+        bool find(const key_type& k, mapped_type& result) const {
+            const shard& s = shards[shard_index(k)];
+            read_guard guard(s.lock);
+            const_iterator i = s.tree.find(k);
+            if (i == s.tree.end()) return false;
+            result = (*i).second;
+            return true;
+        }
+        size_type count(const key_type& k) const {
+            const shard& s = shards[shard_index(k)];
+            read_guard guard(s.lock);
+            return s.tree.find(k) != s.tree.end();
+        }
+        // 找到时在读锁内调用 f(const value_type&), 不复制实值
+        template <class F>
+        bool visit(const key_type& k, F f) const {
+            const shard& s = shards[shard_index(k)];
+            read_guard guard(s.lock);
+            const_iterator i = s.tree.find(k);
+            if (i == s.tree.end()) return false;
+            f(*i);
+            return true;
+        }
+        // 找到时在写锁内调用 f(mapped_type&), 读出和改写之间不会有其他写者
+        template <class F>
+        bool update(const key_type& k, F f) {
+            shard& s = shards[shard_index(k)];
+            write_guard guard(s.lock);
+            iterator i = s.tree.find(k);
+            if (i == s.tree.end()) return false;
+            f((*i).second);
+            return true;
+        }
+
+        // 批量操作: 先按分片分组, 每个分片只加一次锁 ------------------------------
+        // 同一分片的操作在一次加锁中完成, 不同分片之间不是同一时刻的结果
+        // 查找 n 个键值, 组内以交替下降的批量查找重叠各次查找的缓存未命中;
+        // 找到的 keys[i] 的实值复制到 values[i], found[i] 表示是否找到, 返回找到的个数
+        size_type find_batch(const key_type* keys, size_type n, mapped_type* values, bool* found) const;
+        // 插入 n 个元素, 返回新插入的个数
+        size_type insert_batch(const value_type* values, size_type n);
+        // 删除 n 个键值, 返回删除的个数
+        size_type erase_batch(const key_type* keys, size_type n);
+
+        // 遍历 ------------------------------------------------------------
+        // 逐个分片遍历, 只在遍历某个分片时对其加读锁: 每个分片是同一时刻的内容, 分片之间不是
+        // range_partition 时按键值递增, hash_partition 时没有整体的次序
+        template <class F>
+        F for_each(F f) const {
+            for (size_type i = 0; i < Shards; ++i) {
+                read_guard guard(shards[i].lock);
+                for (const_iterator j = shards[i].tree.begin(); j != shards[i].tree.end(); ++j) {
+                    f(*j);
+                }
+            }
+            return f;
+        }
+        // 一致的遍历: 同时对所有分片加读锁, 按键值递增访问同一时刻的全部元素; 遍历期间所有写者都要等待
+        template <class F>
+        F for_each_consistent(F f) const {
+            read_range_guard guard(shards, shards + Shards);
+            __visit_ordered(0, Shards, nullptr, nullptr, f, typename Partition::ordered());
+            return f;
+        }
+        // 按键值递增访问 [first, last) 中的元素, 涉及的分片同时加读锁, 区间内是同一时刻的内容
+        template <class F>
+        F for_each_range(const key_type& first, const key_type& last, F f) const {
+            if (!key_comp()(first, last)) return f;
+            pair<size_type, size_type> r = __shards_of(first, last, typename Partition::ordered());
+            read_range_guard guard(shards + r.first, shards + r.second);
+            __visit_ordered(r.first, r.second, &first, &last, f, typename Partition::ordered());
+            return f;
+        }
+        // 同一时刻全部元素的副本
+        snapshot_type snapshot() const;
+    };
+
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    template <class E, class KeyOfE>
+    void concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::__group(const E* elems, size_type n, KeyOfE key_of,
+                                                                            const E** order, size_type* start) const {
+        vector<size_type, Alloc> id(n, 0);
+        for (size_type i = 0; i <= Shards; ++i) {
+            start[i] = 0;
+        }
+        for (size_type j = 0; j < n; ++j) {
+            id[j] = shard_index(key_of(elems[j]));
+            ++start[id[j] + 1];
+        }
+        for (size_type i = 0; i < Shards; ++i) {
+            start[i + 1] += start[i];
+        }
+        size_type pos[Shards];
+        for (size_type i = 0; i < Shards; ++i) {
+            pos[i] = start[i];
+        }
+        for (size_type j = 0; j < n; ++j) {
+            order[pos[id[j]]++] = elems + j;
+        }
+    }
+
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    typename concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::size_type
+    concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::find_batch(const key_type* keys, size_type n,
+                                                                          mapped_type* values, bool* found) const {
+        if (n == 0) return 0;
+        vector<const key_type*, Alloc> order(n, nullptr);
+        vector<const_iterator, Alloc> result(n, const_iterator());
+        size_type start[Shards + 1];
+        __group(keys, n, identity<key_type>(), &order[0], start);
+
+        size_type hits = 0;
+        for (size_type i = 0; i < Shards; ++i) {
+            if (start[i] == start[i + 1]) continue;
+            const shard& s = shards[i];
+            read_guard guard(s.lock);
+            s.tree.find_batch_indirect(keys, &order[start[i]], start[i + 1] - start[i], &result[0]);
+            // 实值要在锁内复制
+            for (size_type j = start[i]; j < start[i + 1]; ++j) {
+                size_type k = order[j] - keys;
+                found[k] = result[k] != s.tree.end();
+                if (found[k]) {
+                    values[k] = (*result[k]).second;
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    }
+
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    typename concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::size_type
+    concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::insert_batch(const value_type* values, size_type n) {
+        if (n == 0) return 0;
+        vector<const value_type*, Alloc> order(n, nullptr);
+        size_type start[Shards + 1];
+        __group(values, n, select1st<value_type>(), &order[0], start);
+
+        size_type inserted = 0;
+        for (size_type i = 0; i < Shards; ++i) {
+            if (start[i] == start[i + 1]) continue;
+            write_guard guard(shards[i].lock);
+            for (size_type j = start[i]; j < start[i + 1]; ++j) {
+                inserted += shards[i].tree.insert_unique(*order[j]).second;
+            }
+        }
+        return inserted;
+    }
+
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    typename concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::size_type
+    concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::erase_batch(const key_type* keys, size_type n) {
+        if (n == 0) return 0;
+        vector<const key_type*, Alloc> order(n, nullptr);
+        size_type start[Shards + 1];
+        __group(keys, n, identity<key_type>(), &order[0], start);
+
+        size_type erased = 0;
+        for (size_type i = 0; i < Shards; ++i) {
+            if (start[i] == start[i + 1]) continue;
+            write_guard guard(shards[i].lock);
+            for (size_type j = start[i]; j < start[i + 1]; ++j) {
+                erased += shards[i].tree.erase(*order[j]);
+            }
+        }
+        return erased;
+    }
+
+    // 分片的次序就是键值的次序: 依次访问
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    template <class F>
+    void concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::__visit_ordered(size_type lo, size_type hi,
+                                                                                    const key_type* first, const key_type* last,
+                                                                                    F& f, __true_type) const {
+        for (size_type i = lo; i < hi; ++i) {
+            const rep_type& t = shards[i].tree;
+            const_iterator j = first ? t.lower_bound(*first) : t.begin();
+            const_iterator e = last ? t.lower_bound(*last) : t.end();
+            for ( ; j != e; ++j) {
+                f(*j);
+            }
+        }
+    }
+
+    // 分片之间没有次序: 以堆归并, 堆中是各分片的编号, 按各分片当前位置的键值排列, 每个元素 O(log Shards)
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    template <class F>
+    void concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::__visit_ordered(size_type lo, size_type hi,
+                                                                                    const key_type* first, const key_type* last,
+                                                                                    F& f, __false_type) const {
+        const_iterator cur[Shards];
+        const_iterator end[Shards];
+        size_type heap[Shards];
+        size_type n = 0;
+        for (size_type i = lo; i < hi; ++i) {
+            const rep_type& t = shards[i].tree;
+            cur[i] = first ? t.lower_bound(*first) : t.begin();
+            end[i] = last ? t.lower_bound(*last) : t.end();
+            if (cur[i] != end[i]) {
+                heap[n++] = i;
+            }
+        }
+        __merge_compare comp = { cur, key_comp() };
+        LI::make_heap(heap, heap + n, comp);
+        while (n > 0) {
+            LI::pop_heap(heap, heap + n, comp);
+            size_type i = heap[n - 1];
+            f(*cur[i]);
+            if (++cur[i] != end[i]) {
+                LI::push_heap(heap, heap + n, comp);
+            }
+            else {
+                --n;
+            }
+        }
+    }
+
+    // 一致遍历的结果按键值递增, 每次都插在末尾, 均摊 O(1)
+    template <class Map>
+    struct __concurrent_map_append {
+        Map* m;
+        void operator()(const typename Map::value_type& x) const { m->insert(m->end(), x); }
+    };
+
+    template <class Key, class T, size_t Shards, class Partition, class Compare, class Alloc>
+    typename concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::snapshot_type
+    concurrent_map<Key, T, Shards, Partition, Compare, Alloc>::snapshot() const {
+        snapshot_type m;
+        __concurrent_map_append<snapshot_type> append = { &m };
+        for_each_consistent(append);
+        return m;
+    }
+
+}
+
+
+#endif
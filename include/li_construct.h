@@ -3,6 +3,7 @@
 
 #include <new.h> // 定位 new 表示式
 #include "li_type_traits.h"
+#include "li_utility.h"
 namespace LI {
     // 负责 构造和析构对象
     
@@ -11,6 +12,12 @@ namespace LI {
         new(p) T1(value); // 以 value 为参数在 p 地址上构造 T1对象
     }
 
+    // 任意个参数原样转交给 T1 的构造函数, 不产生临时对象
+    template <class T1, class... Args>
+    inline void construct(T1* p, Args&&... args) {
+        new(p) T1(LI::forward<Args>(args)...);
+    }
+
     // destroy 的第一版本，接受一个指针
     template <class T>
     inline void destroy(T* pointer) {
@@ -181,16 +181,16 @@ namespace LI {
         map_pointer cur;
         try {
             for (cur = start.node; cur < finish.node; ++cur) {
-                uninitialized_fill(*cur, *cur + buffer_size(), value);
+                LI::uninitialized_fill(*cur, *cur + buffer_size(), value);
             }
             // 最后一个节点稍有不同
-            uninitialized_fill(finish.first, finish.cur, value);
+            LI::uninitialized_fill(finish.first, finish.cur, value);
         }
         catch(...) {
             map_pointer cur_cerr;
             for (cur_cerr = start.node; cur_cerr < cur; ++cur_cerr) {
                 // 析构对象
-                destroy(*cur_cerr, *cur + buffer_size());
+                LI::destroy(*cur_cerr, *cur + buffer_size());
                 // 释放空间
                 data_allocator::deallocate(*cur_cerr, buffer_size());
             }
@@ -221,13 +221,13 @@ namespace LI {
 
     template<class T, class Alloc, size_t BufSize>
     deque<T, Alloc, BufSize>::deque() : start(), finish(), map(0), map_size(0) {
-        fill_initialize(0, 0);
+        create_map_and_nodes(0); // 没有元素要初始化, 不能以 0 构造一个临时元素
     }
 
     template<class T, class Alloc, size_t BufSize>
     deque<T, Alloc, BufSize>::~deque() {
         // 析构每个对象
-        destroy(start, finish);
+        LI::destroy(start, finish);
         // 释放每个缓冲区内存 必定存在一个缓冲区
         for (map_pointer cur = start.node; cur <= finish.node; ++cur) {
             deallocate_node(*cur);
@@ -248,10 +248,10 @@ namespace LI {
             // 不用重新配置, 只用重新设定 start 的位置
             new_nstart = map + (map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0); // 如果是前面添加, 那么new_nstart往后再退一格
             if (new_nstart < start.node) {
-                copy(start.node, finish.node + 1, new_nstart);
+                LI::copy(start.node, finish.node + 1, new_nstart);
             }
             else {
-                copy_backward(start.node, finish.node + 1, new_nstart + old_num_nodes);
+                LI::copy_backward(start.node, finish.node + 1, new_nstart + old_num_nodes);
             }
         }
         else {
@@ -262,7 +262,7 @@ namespace LI {
             // 设定新的 start
             new_nstart = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
             // copy 原来的内容
-            copy(start.node, finish.node + 1, new_nstart);
+            LI::copy(start.node, finish.node + 1, new_nstart);
             // 释放原来的 map
             map_allocator::deallocate(map, map_size);
             // 设定新的 map 和 map_size
@@ -354,7 +354,7 @@ namespace LI {
     void deque<T, Alloc, BufSize>::pop_back() {
         if (finish.cur != finish.first) {
             --finish.cur;
-            destroy(finish.cur); // 析构最后一个元素
+            LI::destroy(finish.cur); // 析构最后一个元素
         }
         else {
             pop_back_aux(); // 最后缓冲区没有元素
@@ -366,14 +366,14 @@ namespace LI {
         deallocate_node(finish.first); // 释放最后一个缓冲区
         finish.set_node(finish.node - 1); // 调整 finish 的状态
         finish.cur = finish.last - 1; // 指向最后一个元素
-        destroy(finish.cur); // 释放最后一个元素
+        LI::destroy(finish.cur); // 释放最后一个元素
     }
 
     template<class T, class Alloc, size_t BufSize>
     void deque<T, Alloc, BufSize>::pop_front() {
         if (start.cur != start.last - 1) {
             // 第一缓冲区有两个或更多元素
-            destroy(start.cur); // 析构对象
+            LI::destroy(start.cur); // 析构对象
             ++start.cur; // 调整指针
         }
         else {
@@ -383,7 +383,7 @@ namespace LI {
 
     template<class T, class Alloc, size_t BufSize>
     void deque<T, Alloc, BufSize>::pop_front_aux() {
-        destroy(start.cur); // 析构第一个元素
+        LI::destroy(start.cur); // 析构第一个元素
         deallocate_node(start.first); // 释放第一个缓冲区
         start.set_node(start.node + 1); // 设置 start 状态
         start.cur = start.first; // 下一个缓冲区的第一个元素
@@ -394,19 +394,19 @@ namespace LI {
         // deque 的最初状态是 最少也有一个缓冲区
         // 以下处理除了头尾的区间
         for (map_pointer node = start.node + 1; node < finish.node; ++node) {
-            destroy(*node, *node + buffer_size()); // 析构对象
+            LI::destroy(*node, *node + buffer_size()); // 析构对象
             deallocate_node(*node); // 释放内存
         }
         if (start.node != finish.node) {
             // 头尾都有一个缓冲区
-            destroy(start.cur, start.last); // 析构头缓冲区
-            destroy(finish.first, finish.cur); // 析构尾缓冲区
+            LI::destroy(start.cur, start.last); // 析构头缓冲区
+            LI::destroy(finish.first, finish.cur); // 析构尾缓冲区
             // 释放尾缓冲区 保留头缓冲区
             deallocate_node(*(finish.node));
         }
         else {
             // 只有一个缓冲区
-            destroy (start.cur, finish.cur); // 析构全部元素
+            LI::destroy (start.cur, finish.cur); // 析构全部元素
             // 不释放内存
         }
         finish = start; // 调整状态
@@ -419,12 +419,12 @@ namespace LI {
         difference_type index = position - start; // 清除点前的元素个数
         if (index < (size() >> 1)) {
             // 如果清除点之前的元素较少
-            copy_backward(start, position, next); // 因为迭代器定义了相应的运算符, 所以可以直接用 copy 算法
+            LI::copy_backward(start, position, next); // 因为迭代器定义了相应的运算符, 所以可以直接用 copy 算法
             pop_front(); // 去掉前面一个
         }
         else {
             // 清除点后的元素较少
-            copy(next, finish, position);
+            LI::copy(next, finish, position);
             pop_back(); // 去掉最后一个
         }
         return start + index; // 不能返回 next
@@ -441,9 +441,9 @@ namespace LI {
             difference_type elems_before = first - start; // 前端的长短
             if (elems_before < (size() - n) / 2) {
                 // 前方元素比较少
-                copy_backward(start, first, last); // 向后移动元素
+                LI::copy_backward(start, first, last); // 向后移动元素
                 iterator new_start = start + n; // 标记新起点
-                destroy(start, new_start); // 析构前段元素
+                LI::destroy(start, new_start); // 析构前段元素
                 // 释放冗余的缓冲区
                 for (map_pointer cur = start.node; cur < new_start.node; ++cur) {
                     deallocate_node(*cur);
@@ -452,9 +452,9 @@ namespace LI {
             }
             else {
                 // 后方元素较少
-                copy(last, finish, first); // 向前移动元素
+                LI::copy(last, finish, first); // 向前移动元素
                 iterator new_finish = finish - n; // 标记新尾点
-                destroy(new_finish, finish); // 析构后段元素
+                LI::destroy(new_finish, finish); // 析构后段元素
                 // 释放冗余的缓冲区
                 for (map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur) {
                     deallocate_node(*cur);
@@ -497,7 +497,7 @@ namespace LI {
             position = start + index; // 更新插入位置 position
             iterator pos1 = position;
             ++pos1; // pos1 就相当于原来的 position
-            copy(front2, pos1, front1); // 元素移动
+            LI::copy(front2, pos1, front1); // 元素移动
         }
         else {
             // 后面的元素较少
@@ -507,7 +507,7 @@ namespace LI {
             iterator back2 = back1;
             --back2; // 用递减是因为 2 个迭代器都要用
             position = start + index; // 确保最后的 position 是正确的插入位置
-            copy_backward(position, back2, back1); // 元素移动
+            LI::copy_backward(position, back2, back1); // 元素移动
         }
         *position = x_copy; // 在插入点插入新值
         return position;
@@ -2,6 +2,7 @@
 #define LI_DEQUE_ITERATOR_H_
 
 #include "li_iterator.h"
+#include "li_algorithm.h"
 
 // deque 容器的迭代器类型
 // 用连续数组存放指向每段缓冲区的指针, 实现形式上的连续
@@ -149,6 +150,155 @@ namespace LI {
     };
 
 
+    // 以下为针对 deque 迭代器的分段算法 -----------------------------------------
+    // deque 迭代器每次 ++ / -- 都要判断是否走到缓冲区边缘, 逐个元素处理很慢
+    // 分段版本每次取出一段连续的缓冲区 [cur, last), 交给原生指针版本处理 (trivial 型别直接 memmove)
+
+    // deque -> deque
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    __deque_iterator<T, T&, T*, BufSiz>
+    __copy_segmented(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last,
+                     __deque_iterator<T, T&, T*, BufSiz> result) {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            // 本次能处理的长度: 源缓冲区剩余, 目的缓冲区剩余, 总剩余 三者取最小
+            ptrdiff_t len = first.last - first.cur;
+            if (result.last - result.cur < len) len = result.last - result.cur;
+            if (n < len) len = n;
+            LI::copy(first.cur, first.cur + len, result.cur);
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // deque -> 原生指针
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    T* __copy_segmented(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last, T* result) {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t len = first.last - first.cur;
+            if (n < len) len = n;
+            result = LI::copy(first.cur, first.cur + len, result);
+            first += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // 原生指针 -> deque
+    template <class T, class Ptr, size_t BufSiz>
+    __deque_iterator<T, T&, T*, BufSiz>
+    __copy_segmented(Ptr first, Ptr last, __deque_iterator<T, T&, T*, BufSiz> result) {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t len = result.last - result.cur;
+            if (n < len) len = n;
+            LI::copy(first, first + len, result.cur);
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // copy 的偏特化版本, 在 copy() 分派时选中
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    struct __copy_dispatch<__deque_iterator<T, Ref, Ptr, BufSiz>, __deque_iterator<T, T&, T*, BufSiz> > {
+        typedef __deque_iterator<T, Ref, Ptr, BufSiz> InputIterator;
+        typedef __deque_iterator<T, T&, T*, BufSiz> OutputIterator;
+        OutputIterator operator()(InputIterator first, InputIterator last, OutputIterator result) {
+            return __copy_segmented(first, last, result);
+        }
+    };
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    struct __copy_dispatch<__deque_iterator<T, Ref, Ptr, BufSiz>, T*> {
+        typedef __deque_iterator<T, Ref, Ptr, BufSiz> InputIterator;
+        T* operator()(InputIterator first, InputIterator last, T* result) {
+            return __copy_segmented(first, last, result);
+        }
+    };
+    template <class T, size_t BufSiz>
+    struct __copy_dispatch<T*, __deque_iterator<T, T&, T*, BufSiz> > {
+        typedef __deque_iterator<T, T&, T*, BufSiz> OutputIterator;
+        OutputIterator operator()(T* first, T* last, OutputIterator result) {
+            return __copy_segmented(first, last, result);
+        }
+    };
+    template <class T, size_t BufSiz>
+    struct __copy_dispatch<const T*, __deque_iterator<T, T&, T*, BufSiz> > {
+        typedef __deque_iterator<T, T&, T*, BufSiz> OutputIterator;
+        OutputIterator operator()(const T* first, const T* last, OutputIterator result) {
+            return __copy_segmented(first, last, result);
+        }
+    };
+
+    // copy_backward 的分段版本: 从尾端往前, 每次处理一段连续的缓冲区
+    // 注意 cur == first 时, 该段实际位于前一个缓冲区的尾部
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    __deque_iterator<T, T&, T*, BufSiz>
+    __copy_backward_segmented(__deque_iterator<T, Ref, Ptr, BufSiz> first, __deque_iterator<T, Ref, Ptr, BufSiz> last,
+                              __deque_iterator<T, T&, T*, BufSiz> result) {
+        const ptrdiff_t buf_size = ptrdiff_t(__deque_iterator<T, Ref, Ptr, BufSiz>::buffer_size());
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            ptrdiff_t llen = last.cur - last.first;
+            Ptr lend = last.cur;
+            if (llen == 0) {
+                llen = buf_size;
+                lend = *(last.node - 1) + buf_size;
+            }
+            ptrdiff_t rlen = result.cur - result.first;
+            T* rend = result.cur;
+            if (rlen == 0) {
+                rlen = buf_size;
+                rend = *(result.node - 1) + buf_size;
+            }
+            ptrdiff_t len = llen < rlen ? llen : rlen;
+            if (n < len) len = n;
+            LI::copy_backward(lend - len, lend, rend);
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    template <class T, class Ref, class Ptr, size_t BufSiz>
+    struct __copy_backward_dispatch<__deque_iterator<T, Ref, Ptr, BufSiz>, __deque_iterator<T, T&, T*, BufSiz> > {
+        typedef __deque_iterator<T, Ref, Ptr, BufSiz> BidirectionalIterator1;
+        typedef __deque_iterator<T, T&, T*, BufSiz> BidirectionalIterator2;
+        BidirectionalIterator2 operator()(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result) {
+            return __copy_backward_segmented(first, last, result);
+        }
+    };
+
+    // fill 的分段版本: 头尾两段单独处理, 中间的缓冲区整段填充
+    template <class T, size_t BufSiz>
+    void fill(__deque_iterator<T, T&, T*, BufSiz> first, __deque_iterator<T, T&, T*, BufSiz> last, const T& value) {
+        if (first.node == last.node) {
+            LI::fill(first.cur, last.cur, value);
+            return;
+        }
+        const size_t buf_size = __deque_iterator<T, T&, T*, BufSiz>::buffer_size();
+        LI::fill(first.cur, first.last, value);
+        for (T** node = first.node + 1; node < last.node; ++node) {
+            LI::fill(*node, *node + buf_size, value);
+        }
+        LI::fill(last.first, last.cur, value);
+    }
+
+    template <class T, size_t BufSiz, class Size>
+    __deque_iterator<T, T&, T*, BufSiz> fill_n(__deque_iterator<T, T&, T*, BufSiz> first, Size n, const T& value) {
+        if (n <= 0) {
+            return first;
+        }
+        __deque_iterator<T, T&, T*, BufSiz> last = first + ptrdiff_t(n);
+        LI::fill(first, last, value);
+        return last;
+    }
+
 }
 
 #endif
\ No newline at end of file
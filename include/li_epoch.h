@@ -0,0 +1,225 @@
+#ifndef LI_EPOCH_H_
+#define LI_EPOCH_H_
+
+#include <atomic>
+#include <stdint.h>
+#include "li_lock.h"
+
+// 基于纪元的内存回收 (epoch-based reclamation), 供无锁容器使用
+// 从无锁容器中摘下的节点可能仍在被其他线程读取, 不能立即释放:
+// 1. 线程访问容器时处于临界区 (epoch_guard) 中, 进入时记下全局纪元, 离开时标记为不活跃
+// 2. 摘下的节点交给 __ebr_retire, 按摘下之后读到的全局纪元 e 放入本线程的袋子
+// 3. 所有活跃的线程都已记下当前纪元时, 全局纪元才能加一; 纪元到达 e + 2 时,
+//    摘下之前进入临界区的线程都已离开, 袋子中的节点可以释放
+// 节点以 __ebr_node 为基类, 袋子就是节点串成的链表, 回收时不需要另外配置内存
+// 线程退出时还不能释放的节点交给全局的孤儿袋子, 由其他线程在纪元足够时释放
+namespace LI {
+
+    struct __ebr_node {
+        __ebr_node* retire_next;
+        void (*reclaim)(__ebr_node*); // 析构并释放节点
+    };
+
+    // 同一纪元摘下的节点
+    struct __ebr_bag {
+        __ebr_node* head;
+        uint64_t epoch;
+        size_t count;
+
+        void push(__ebr_node* x) {
+            x->retire_next = head;
+            head = x;
+            ++count;
+        }
+        void free_all() {
+            __ebr_node* x = head;
+            head = 0;
+            count = 0;
+            while (x != 0) {
+                __ebr_node* next = x->retire_next;
+                x->reclaim(x);
+                x = next;
+            }
+        }
+    };
+
+    // 每个线程一份, 挂在全局链表上, 永不释放; 线程退出后可由新的线程重用
+    struct __ebr_record {
+        std::atomic<uint64_t> state; // 活跃时为 (纪元 << 1) | 1, 否则为 0
+        std::atomic<bool> in_use;
+        __ebr_record* next;
+        // 以下只由所属的线程访问
+        unsigned int nesting; // 临界区可以嵌套
+        unsigned int retired; // 上次尝试推进纪元之后摘下的节点数
+        __ebr_bag bags[3];
+    };
+
+    template <bool Dummy>
+    struct __ebr_domain {
+        enum { ADVANCE_INTERVAL = 64 }; // 每摘下这么多个节点尝试推进一次纪元
+
+        static std::atomic<uint64_t> global_epoch;
+        static std::atomic<__ebr_record*> records;
+        static __spin_lock orphan_lock;
+        static __ebr_bag orphan; // 已退出的线程留下的节点, epoch 为其中最晚的纪元
+        static std::atomic<bool> has_orphan; // 不加锁时先检查这个标志
+
+        static __ebr_record* acquire();
+        static void release(__ebr_record* r);
+        static bool try_advance();
+        static void collect(__ebr_record* r, uint64_t g);
+    };
+
+    template <bool Dummy>
+    std::atomic<uint64_t> __ebr_domain<Dummy>::global_epoch(0);
+    template <bool Dummy>
+    std::atomic<__ebr_record*> __ebr_domain<Dummy>::records(nullptr);
+    template <bool Dummy>
+    __spin_lock __ebr_domain<Dummy>::orphan_lock;
+    template <bool Dummy>
+    __ebr_bag __ebr_domain<Dummy>::orphan = { 0, 0, 0 };
+    template <bool Dummy>
+    std::atomic<bool> __ebr_domain<Dummy>::has_orphan(false);
+
+    // 取得一个空闲的记录, 没有时新建一个并挂到链表头部
+    template <bool Dummy>
+    __ebr_record* __ebr_domain<Dummy>::acquire() {
+        for (__ebr_record* r = records.load(std::memory_order_acquire); r != 0; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        __ebr_record* r = new __ebr_record;
+        r->state.store(0, std::memory_order_relaxed);
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->nesting = 0;
+        r->retired = 0;
+        for (int i = 0; i < 3; ++i) {
+            r->bags[i].head = 0;
+            r->bags[i].epoch = 0;
+            r->bags[i].count = 0;
+        }
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) { }
+        return r;
+    }
+
+    // 线程退出: 已经可以释放的袋子直接释放, 其余并入孤儿袋子
+    template <bool Dummy>
+    void __ebr_domain<Dummy>::release(__ebr_record* r) {
+        uint64_t g = global_epoch.load(std::memory_order_seq_cst);
+        for (int i = 0; i < 3; ++i) {
+            __ebr_bag& b = r->bags[i];
+            if (b.count == 0) continue;
+            if (b.epoch + 2 <= g) {
+                b.free_all();
+                continue;
+            }
+            __lock_guard<__spin_lock> guard(orphan_lock);
+            __ebr_node* last = b.head;
+            while (last->retire_next != 0) last = last->retire_next;
+            last->retire_next = orphan.head;
+            orphan.head = b.head;
+            orphan.count += b.count;
+            if (b.epoch > orphan.epoch) orphan.epoch = b.epoch;
+            has_orphan.store(true, std::memory_order_relaxed);
+            b.head = 0;
+            b.count = 0;
+        }
+        r->nesting = 0;
+        r->retired = 0;
+        r->state.store(0, std::memory_order_release);
+        r->in_use.store(false, std::memory_order_release);
+    }
+
+    // 所有活跃的线程都已记下当前纪元时, 纪元加一
+    template <bool Dummy>
+    bool __ebr_domain<Dummy>::try_advance() {
+        uint64_t g = global_epoch.load(std::memory_order_seq_cst);
+        for (__ebr_record* r = records.load(std::memory_order_acquire); r != 0; r = r->next) {
+            uint64_t s = r->state.load(std::memory_order_seq_cst);
+            if ((s & 1) && (s >> 1) != g) return false;
+        }
+        return global_epoch.compare_exchange_strong(g, g + 1, std::memory_order_seq_cst);
+    }
+
+    // 释放纪元不晚于 g - 2 的袋子
+    template <bool Dummy>
+    void __ebr_domain<Dummy>::collect(__ebr_record* r, uint64_t g) {
+        for (int i = 0; i < 3; ++i) {
+            if (r->bags[i].count != 0 && r->bags[i].epoch + 2 <= g) {
+                r->bags[i].free_all();
+            }
+        }
+        if (has_orphan.load(std::memory_order_relaxed) && orphan_lock.try_lock()) {
+            __ebr_bag b = { 0, 0, 0 };
+            if (orphan.count != 0 && orphan.epoch + 2 <= g) {
+                b = orphan;
+                orphan.head = 0;
+                orphan.count = 0;
+                has_orphan.store(false, std::memory_order_relaxed);
+            }
+            orphan_lock.unlock();
+            b.free_all();
+        }
+    }
+
+    // 本线程的记录, 线程退出时交还
+    struct __ebr_thread {
+        __ebr_record* rec;
+        __ebr_thread() : rec(__ebr_domain<true>::acquire()) { }
+        ~__ebr_thread() { __ebr_domain<true>::release(rec); }
+    };
+    inline __ebr_record* __ebr_local() {
+        static thread_local __ebr_thread t;
+        return t.rec;
+    }
+
+    inline void __ebr_enter() {
+        __ebr_record* r = __ebr_local();
+        if (r->nesting++ == 0) {
+            uint64_t g = __ebr_domain<true>::global_epoch.load(std::memory_order_relaxed);
+            r->state.store((g << 1) | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            __ebr_domain<true>::collect(r, g);
+        }
+    }
+    inline void __ebr_leave() {
+        __ebr_record* r = __ebr_local();
+        if (--r->nesting == 0) {
+            r->state.store(0, std::memory_order_release);
+        }
+    }
+
+    // 节点已从容器中摘下 (之后进入临界区的线程都不可能再访问到它), 须在临界区内调用
+    inline void __ebr_retire(__ebr_node* x, void (*reclaim)(__ebr_node*)) {
+        __ebr_record* r = __ebr_local();
+        uint64_t g = __ebr_domain<true>::global_epoch.load(std::memory_order_seq_cst);
+        x->reclaim = reclaim;
+        __ebr_bag& b = r->bags[g % 3];
+        if (b.count != 0 && b.epoch != g) {
+            b.free_all(); // 纪元单调增加, 这是纪元不晚于 g - 3 的旧袋子
+        }
+        b.epoch = g;
+        b.push(x);
+        if (++r->retired >= (unsigned int) __ebr_domain<true>::ADVANCE_INTERVAL) {
+            r->retired = 0;
+            __ebr_domain<true>::try_advance();
+            __ebr_domain<true>::collect(r, __ebr_domain<true>::global_epoch.load(std::memory_order_seq_cst));
+        }
+    }
+
+    // 临界区: 其间读到的无锁容器的节点和迭代器都不会被释放
+    class epoch_guard {
+    public:
+        epoch_guard() { __ebr_enter(); }
+        ~epoch_guard() { __ebr_leave(); }
+        epoch_guard(const epoch_guard&) = delete;
+        epoch_guard& operator=(const epoch_guard&) = delete;
+    };
+
+}
+
+#endif
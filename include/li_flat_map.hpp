@@ -0,0 +1,699 @@
+#ifndef LI_FLAT_MAP_H_
+#define LI_FLAT_MAP_H_
+
+#include "li_vector.hpp"
+#include "li_algorithm.h"
+#include "li_iterator.h"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+#include "li_utility.h"
+
+// flat_map 与 flat_set: 以有序的 vector 代替红黑树
+// 1. flat_map 的键值与实值分别存放在两个 vector 中, 查找时只在键值数组上二分, 访问的内存少且连续
+// 2. 元素不单独配置节点, 几个到上千个元素的小 map 省去了每个元素一次的内存配置
+// 3. 单个元素的插入和删除要搬动其后的元素, O(n); 区间插入先把新元素追加到尾端,
+//    排序后与原有元素一次合并, O(n + m log m)
+//    单个元素的插入不放入缓冲区延后合并: insert / try_emplace 要立即返回指向新元素的迭代器,
+//    而且 find 等 const 操作不能先去合并缓冲区; 元素不多时搬动的开销很小.
+//    要一次插入大量无序的元素时, 先收集起来再调用区间 insert, 由它完成批量合并
+// 4. 迭代器是下标式的, 插入和删除会使迭代器失效
+namespace LI {
+
+    // 以下标排序追加到尾端的键值: 键值相等时先追加的在前, 保证重复键值中先出现的留下
+    template <class Key, class Compare>
+    struct __flat_index_compare {
+        const Key* keys;
+        Compare comp;
+        __flat_index_compare(const Key* k, const Compare& c) : keys(k), comp(c) { }
+        bool operator()(size_t x, size_t y) const {
+            if (comp(keys[x], keys[y])) return true;
+            if (comp(keys[y], keys[x])) return false;
+            return x < y;
+        }
+    };
+
+    // 有序键值数组上的二分查找
+    template <class Key, class Compare>
+    struct __flat_search {
+        static const Key* lower(const Key* first, const Key* last, const Key& k, const Compare& comp) {
+            return LI::lower_bound(first, last, k, comp);
+        }
+    };
+    // less 比较时用无分支的写法 (同 __lower_bound_branchless);
+    // 小数组整个在缓存中, 不做预取, 预取指令在这里只是额外的开销
+    template <class Key>
+    struct __flat_search<Key, less<Key> > {
+        static const Key* lower(const Key* first, const Key* last, const Key& k, const less<Key>&) {
+            ptrdiff_t len = last - first;
+            if (len == 0) {
+                return first;
+            }
+            while (len > 1) {
+                ptrdiff_t half = len >> 1;
+                first = (first[half] < k) ? first + half : first;
+                len -= half;
+            }
+            return first + (*first < k);
+        }
+    };
+
+    // 把 keys[n0, n) 的下标排好序写到 order 中; 追加的部分本身严格递增且都大于原有的最大键值时返回 false,
+    // 此时不必合并
+    template <class Key, class Compare>
+    bool __flat_sort_tail(const Key* keys, size_t n0, size_t n, const Compare& comp, size_t* order) {
+        bool sorted = n0 == 0 || comp(keys[n0 - 1], keys[n0]);
+        for (size_t i = n0; i < n; ++i) {
+            order[i - n0] = i;
+            if (i > n0 && !comp(keys[i - 1], keys[i])) sorted = false;
+        }
+        if (sorted) return false;
+        LI::sort(order, order + (n - n0), __flat_index_compare<Key, Compare>(keys, comp));
+        return true;
+    }
+
+
+    // flat_map 的迭代器 ---------------------------------------------------------
+    // 键值与实值不在一起存放, 解引用得到的是两个引用组成的代理对象, it->first / it->second 照常使用
+    template <class Key, class V>
+    struct __flat_map_reference {
+        const Key& first;
+        V& second;
+        __flat_map_reference(const Key& k, V& v) : first(k), second(v) { }
+        __flat_map_reference* operator->() { return this; } // 支持迭代器的 operator->
+    };
+
+    // V 为 T 时是 iterator, 为 const T 时是 const_iterator
+    template <class Key, class T, class V>
+    struct __flat_map_iterator {
+        typedef __flat_map_iterator<Key, T, T> iterator;
+        typedef __flat_map_iterator<Key, T, V> self;
+
+        typedef random_access_iterator_tag iterator_category;
+        typedef pair<const Key, T> value_type;
+        typedef __flat_map_reference<Key, V> reference;
+        typedef __flat_map_reference<Key, V> pointer;
+        typedef ptrdiff_t difference_type;
+
+        const Key* key;
+        V* value;
+
+        __flat_map_iterator() : key(nullptr), value(nullptr) { }
+        __flat_map_iterator(const Key* k, V* v) : key(k), value(v) { }
+        __flat_map_iterator(const iterator& it) : key(it.key), value(it.value) { }
+
+        reference operator*() const { return reference(*key, *value); }
+        pointer operator->() const { return operator*(); }
+        reference operator[](difference_type n) const { return reference(key[n], value[n]); }
+
+        self& operator++() { ++key; ++value; return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        self& operator--() { --key; --value; return *this; }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+        self& operator+=(difference_type n) { key += n; value += n; return *this; }
+        self& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+        self operator+(difference_type n) const { return self(key + n, value + n); }
+        self operator-(difference_type n) const { return self(key - n, value - n); }
+    };
+
+    template <class Key, class T, class V1, class V2>
+    inline ptrdiff_t operator-(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return x.key - y.key;
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator==(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return x.key == y.key;
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator!=(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return x.key != y.key;
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator<(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return x.key < y.key;
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator>(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return y < x;
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator<=(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return !(y < x);
+    }
+    template <class Key, class T, class V1, class V2>
+    inline bool operator>=(const __flat_map_iterator<Key, T, V1>& x, const __flat_map_iterator<Key, T, V2>& y) {
+        return !(x < y);
+    }
+
+
+    // flat_map ------------------------------------------------------------------
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class flat_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+
+        class value_compare : public binary_function<value_type, value_type, bool> {
+        public:
+            friend class flat_map<Key, T, Compare, Alloc>;
+            bool operator()(const value_type& x, const value_type& y) const {
+                return comp(x.first, y.first);
+            }
+        protected:
+            Compare comp;
+            value_compare(Compare c) : comp(c) { }
+        };
+
+        typedef __flat_map_iterator<Key, T, T> iterator;
+        typedef __flat_map_iterator<Key, T, const T> const_iterator;
+        typedef typename iterator::reference reference;
+        typedef typename const_iterator::reference const_reference;
+        typedef typename iterator::pointer pointer;
+        typedef typename const_iterator::pointer const_pointer;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+    private:
+        typedef vector<Key, Alloc> key_container;
+        typedef vector<T, Alloc> value_container;
+        typedef simple_alloc<size_type, Alloc> index_allocator;
+        typedef __flat_search<Key, Compare> search;
+
+        key_container keys; // 递增的键值
+        value_container values; // values[i] 是 keys[i] 对应的实值
+        Compare comp;
+
+        iterator make_iterator(size_type i) {
+            return iterator(keys.begin() + i, values.begin() + i);
+        }
+        const_iterator make_iterator(size_type i) const {
+            return const_iterator(keys.begin() + i, values.begin() + i);
+        }
+        size_type index(const_iterator position) const { return position.key - keys.begin(); }
+        size_type __lower_bound(const key_type& k) const {
+            return search::lower(keys.begin(), keys.end(), k, comp) - keys.begin();
+        }
+        size_type __find(const key_type& k) const {
+            size_type i = __lower_bound(k);
+            return (i == size() || comp(k, keys[i])) ? size() : i;
+        }
+        // 在下标 i 处插入, 实值由 args 构造
+        template <class K, class... Args>
+        iterator __insert_at(size_type i, K&& k, Args&&... args) {
+            keys.emplace(keys.begin() + i, LI::forward<K>(k));
+            try {
+                values.emplace(values.begin() + i, LI::forward<Args>(args)...);
+            }
+            catch(...) {
+                keys.erase(keys.begin() + i);
+                throw;
+            }
+            return make_iterator(i);
+        }
+        void __merge_tail(size_type n0);
+
+    public:
+        flat_map() : comp(Compare()) { }
+        explicit flat_map(const Compare& c) : comp(c) { }
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last) : comp(Compare()) {
+            insert(first, last);
+        }
+        // 调用者保证区间按键值严格递增, 直接依次追加, O(n)
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last, sorted_unique_tag) : comp(Compare()) {
+            for ( ; first != last; ++first) {
+                keys.push_back((*first).first);
+                values.push_back((*first).second);
+            }
+        }
+
+        flat_map(const flat_map<Key, T, Compare, Alloc>& x) : keys(x.keys), values(x.values), comp(x.comp) { }
+        flat_map(flat_map<Key, T, Compare, Alloc>&& x) : keys(LI::move(x.keys)), values(LI::move(x.values)), comp(x.comp) { }
+
+        ~flat_map() { }
+
+        flat_map<Key, T, Compare, Alloc>& operator=(const flat_map<Key, T, Compare, Alloc>& x) {
+            if (this != &x) {
+                flat_map<Key, T, Compare, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        flat_map<Key, T, Compare, Alloc>& operator=(flat_map<Key, T, Compare, Alloc>&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(flat_map<Key, T, Compare, Alloc>& x) {
+            keys.swap(x.keys);
+            values.swap(x.values);
+            LI::swap(comp, x.comp);
+        }
+
+        key_compare key_comp() const { return comp; }
+        value_compare value_comp() const { return value_compare(comp); }
+        iterator begin() { return make_iterator(0); }
+        iterator end() { return make_iterator(size()); }
+        const_iterator begin() const { return make_iterator(0); }
+        const_iterator end() const { return make_iterator(size()); }
+        bool empty() const { return keys.empty(); }
+        size_type size() const { return keys.size(); }
+        size_type max_size() const { return size_type(-1) / (sizeof(Key) + sizeof(T)); }
+        size_type capacity() const { return keys.capacity(); }
+        // 预先配置 n 个元素的空间, 之后插入不再重新配置
+        void reserve(size_type n) {
+            keys.reserve(n);
+            values.reserve(n);
+        }
+        T& operator[] (const key_type& k) {
+            return (*try_emplace(k).first).second;
+        }
+        T& operator[] (key_type&& k) {
+            return (*try_emplace(LI::move(k)).first).second;
+        }
+
+        // 原地构造 ---------------------------------------------
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            value_type v(LI::forward<Args>(args)...);
+            return try_emplace(LI::move(v.first), LI::move(v.second));
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            value_type v(LI::forward<Args>(args)...);
+            return try_emplace(position, LI::move(v.first), LI::move(v.second));
+        }
+        // 直接插入到有序的位置, O(n); 不经过缓冲区, 见文件开头的说明
+        template <class... Args>
+        pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+            size_type i = __lower_bound(k);
+            if (i != size() && !comp(k, keys[i])) return pair<iterator, bool>(make_iterator(i), false);
+            return pair<iterator, bool>(__insert_at(i, k, LI::forward<Args>(args)...), true);
+        }
+        template <class... Args>
+        pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+            size_type i = __lower_bound(k);
+            if (i != size() && !comp(k, keys[i])) return pair<iterator, bool>(make_iterator(i), false);
+            return pair<iterator, bool>(__insert_at(i, LI::move(k), LI::forward<Args>(args)...), true);
+        }
+        // 提示位置正确 (k 恰好在 position 之前) 时不需要查找
+        template <class... Args>
+        iterator try_emplace(const_iterator position, const key_type& k, Args&&... args) {
+            size_type i = index(position);
+            if ((i == 0 || comp(keys[i - 1], k)) && (i == size() || comp(k, keys[i]))) {
+                return __insert_at(i, k, LI::forward<Args>(args)...);
+            }
+            return try_emplace(k, LI::forward<Args>(args)...).first;
+        }
+        template <class... Args>
+        iterator try_emplace(const_iterator position, key_type&& k, Args&&... args) {
+            size_type i = index(position);
+            if ((i == 0 || comp(keys[i - 1], k)) && (i == size() || comp(k, keys[i]))) {
+                return __insert_at(i, LI::move(k), LI::forward<Args>(args)...);
+            }
+            return try_emplace(LI::move(k), LI::forward<Args>(args)...).first;
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(k, LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(LI::move(k), LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        template <class M>
+        iterator insert_or_assign(const_iterator position, const key_type& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, k, LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
+        }
+        template <class M>
+        iterator insert_or_assign(const_iterator position, key_type&& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, LI::move(k), LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
+        }
+
+        pair<iterator, bool> insert(const value_type& x) {
+            return try_emplace(x.first, x.second);
+        }
+        iterator insert(const_iterator position, const value_type& x) {
+            return try_emplace(position, x.first, x.second);
+        }
+        // 先全部追加到尾端, 再排序合并; 重复的键值只保留最先出现的一个 (与 map 逐个插入的结果相同)
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            size_type n0 = size();
+            try {
+                for ( ; first != last; ++first) {
+                    keys.push_back((*first).first);
+                    try {
+                        values.push_back((*first).second);
+                    }
+                    catch(...) {
+                        keys.pop_back();
+                        throw;
+                    }
+                }
+            }
+            catch(...) {
+                keys.erase(keys.begin() + n0, keys.end()); // 新追加的全部丢弃
+                values.erase(values.begin() + n0, values.end());
+                throw;
+            }
+            __merge_tail(n0);
+        }
+
+        // 删除后其后的迭代器失效, 返回被删元素的下一个元素
+        iterator erase(const_iterator position) {
+            size_type i = index(position);
+            keys.erase(keys.begin() + i);
+            values.erase(values.begin() + i);
+            return make_iterator(i);
+        }
+        size_type erase(const key_type& k) {
+            size_type i = __find(k);
+            if (i == size()) return 0;
+            erase(make_iterator(i));
+            return 1;
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            size_type i = index(first), j = index(last);
+            keys.erase(keys.begin() + i, keys.begin() + j);
+            values.erase(values.begin() + i, values.begin() + j);
+            return make_iterator(i);
+        }
+        void clear() {
+            keys.clear();
+            values.clear();
+        }
+        iterator find(const key_type& k) { return make_iterator(__find(k)); }
+        const_iterator find(const key_type& k) const { return make_iterator(__find(k)); }
+
+        // 区间查找
+        size_type count(const key_type& k) const { return __find(k) != size(); }
+        iterator lower_bound(const key_type& k) { return make_iterator(__lower_bound(k)); }
+        const_iterator lower_bound(const key_type& k) const { return make_iterator(__lower_bound(k)); }
+        iterator upper_bound(const key_type& k) {
+            size_type i = __lower_bound(k);
+            if (i != size() && !comp(k, keys[i])) ++i;
+            return make_iterator(i);
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return const_cast<flat_map*>(this)->upper_bound(k);
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+
+        // 第 i 小的元素, O(1)
+        const key_type& key_at(size_type i) const { return keys[i]; }
+        T& value_at(size_type i) { return values[i]; }
+        const T& value_at(size_type i) const { return values[i]; }
+    };
+
+    // 把 [n0, size()) 中新追加的元素排序, 去掉重复的键值后与 [0, n0) 合并
+    template <class Key, class T, class Compare, class Alloc>
+    void flat_map<Key, T, Compare, Alloc>::__merge_tail(size_type n0) {
+        size_type n = size();
+        if (n == n0) return;
+        size_type m = n - n0;
+        size_type* order = index_allocator::allocate(m);
+        try {
+            if (!__flat_sort_tail(keys.begin(), n0, n, comp, order)) {
+                index_allocator::deallocate(order, m);
+                return;
+            }
+            key_container new_keys;
+            value_container new_values;
+            new_keys.reserve(n);
+            new_values.reserve(n);
+            size_type i = 0, j = 0;
+            while (i < n0 || j < m) {
+                // 相等时原有的元素在前, 新的与刚放入的元素相等, 当作重复丢弃
+                if (j == m || (i < n0 && !comp(keys[order[j]], keys[i]))) {
+                    new_keys.push_back(LI::move(keys[i]));
+                    new_values.push_back(LI::move(values[i]));
+                    ++i;
+                }
+                else {
+                    size_type x = order[j++];
+                    if (!new_keys.empty() && !comp(new_keys.back(), keys[x])) continue;
+                    new_keys.push_back(LI::move(keys[x]));
+                    new_values.push_back(LI::move(values[x]));
+                }
+            }
+            keys.swap(new_keys);
+            values.swap(new_values);
+        }
+        catch(...) {
+            index_allocator::deallocate(order, m);
+            // 已经被移走的元素无法复原, 丢弃全部内容
+            clear();
+            throw;
+        }
+        index_allocator::deallocate(order, m);
+    }
+
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(flat_map<Key, T, Compare, Alloc>& x, flat_map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+
+    // flat_set ------------------------------------------------------------------
+    // 元素就是键值, 迭代器就是指向有序数组的 const 指针
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class flat_set {
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+        typedef const Key* pointer;
+        typedef const Key* const_pointer;
+        typedef const Key& reference;
+        typedef const Key& const_reference;
+        typedef const Key* iterator; // 不能通过迭代器改变键值
+        typedef const Key* const_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+    private:
+        typedef vector<Key, Alloc> key_container;
+        typedef simple_alloc<size_type, Alloc> index_allocator;
+        typedef __flat_search<Key, Compare> search;
+
+        key_container keys;
+        Compare comp;
+
+        size_type index(const_iterator position) const { return position - keys.begin(); }
+        size_type __lower_bound(const key_type& k) const {
+            return search::lower(keys.begin(), keys.end(), k, comp) - keys.begin();
+        }
+        size_type __find(const key_type& k) const {
+            size_type i = __lower_bound(k);
+            return (i == size() || comp(k, keys[i])) ? size() : i;
+        }
+        void __merge_tail(size_type n0);
+
+    public:
+        flat_set() : comp(Compare()) { }
+        explicit flat_set(const Compare& c) : comp(c) { }
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last) : comp(Compare()) {
+            insert(first, last);
+        }
+        // 调用者保证区间严格递增, O(n)
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last, sorted_unique_tag) : comp(Compare()) {
+            for ( ; first != last; ++first) {
+                keys.push_back(*first);
+            }
+        }
+
+        flat_set(const flat_set<Key, Compare, Alloc>& x) : keys(x.keys), comp(x.comp) { }
+        flat_set(flat_set<Key, Compare, Alloc>&& x) : keys(LI::move(x.keys)), comp(x.comp) { }
+
+        ~flat_set() { }
+
+        flat_set<Key, Compare, Alloc>& operator=(const flat_set<Key, Compare, Alloc>& x) {
+            if (this != &x) {
+                flat_set<Key, Compare, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        flat_set<Key, Compare, Alloc>& operator=(flat_set<Key, Compare, Alloc>&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(flat_set<Key, Compare, Alloc>& x) {
+            keys.swap(x.keys);
+            LI::swap(comp, x.comp);
+        }
+
+        key_compare key_comp() const { return comp; }
+        value_compare value_comp() const { return comp; }
+        iterator begin() const { return keys.begin(); }
+        iterator end() const { return keys.end(); }
+        bool empty() const { return keys.empty(); }
+        size_type size() const { return keys.size(); }
+        size_type max_size() const { return size_type(-1) / sizeof(Key); }
+        size_type capacity() const { return keys.capacity(); }
+        void reserve(size_type n) { keys.reserve(n); }
+        const_reference operator[](size_type i) const { return keys[i]; } // 第 i 小的元素
+
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return insert(value_type(LI::forward<Args>(args)...));
+        }
+        template <class... Args>
+        iterator emplace_hint(const_iterator position, Args&&... args) {
+            return insert(position, value_type(LI::forward<Args>(args)...));
+        }
+        pair<iterator, bool> insert(const value_type& x) {
+            size_type i = __lower_bound(x);
+            if (i != size() && !comp(x, keys[i])) return pair<iterator, bool>(begin() + i, false);
+            keys.emplace(keys.begin() + i, x);
+            return pair<iterator, bool>(begin() + i, true);
+        }
+        pair<iterator, bool> insert(value_type&& x) {
+            size_type i = __lower_bound(x);
+            if (i != size() && !comp(x, keys[i])) return pair<iterator, bool>(begin() + i, false);
+            keys.emplace(keys.begin() + i, LI::move(x));
+            return pair<iterator, bool>(begin() + i, true);
+        }
+        // 提示位置正确 (x 恰好在 position 之前) 时不需要查找
+        iterator insert(const_iterator position, const value_type& x) {
+            size_type i = index(position);
+            if ((i == 0 || comp(keys[i - 1], x)) && (i == size() || comp(x, keys[i]))) {
+                keys.emplace(keys.begin() + i, x);
+                return begin() + i;
+            }
+            return insert(x).first;
+        }
+        iterator insert(const_iterator position, value_type&& x) {
+            size_type i = index(position);
+            if ((i == 0 || comp(keys[i - 1], x)) && (i == size() || comp(x, keys[i]))) {
+                keys.emplace(keys.begin() + i, LI::move(x));
+                return begin() + i;
+            }
+            return insert(LI::move(x)).first;
+        }
+        // 先全部追加到尾端, 再排序合并
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            size_type n0 = size();
+            try {
+                for ( ; first != last; ++first) {
+                    keys.push_back(*first);
+                }
+            }
+            catch(...) {
+                keys.erase(keys.begin() + n0, keys.end());
+                throw;
+            }
+            __merge_tail(n0);
+        }
+
+        iterator erase(const_iterator position) {
+            size_type i = index(position);
+            keys.erase(keys.begin() + i);
+            return begin() + i;
+        }
+        size_type erase(const key_type& k) {
+            size_type i = __find(k);
+            if (i == size()) return 0;
+            keys.erase(keys.begin() + i);
+            return 1;
+        }
+        iterator erase(const_iterator first, const_iterator last) {
+            size_type i = index(first), j = index(last);
+            keys.erase(keys.begin() + i, keys.begin() + j);
+            return begin() + i;
+        }
+        void clear() { keys.clear(); }
+
+        iterator find(const key_type& k) const { return begin() + __find(k); }
+        size_type count(const key_type& k) const { return __find(k) != size(); }
+        iterator lower_bound(const key_type& k) const { return begin() + __lower_bound(k); }
+        iterator upper_bound(const key_type& k) const {
+            size_type i = __lower_bound(k);
+            if (i != size() && !comp(k, keys[i])) ++i;
+            return begin() + i;
+        }
+        pair<iterator, iterator> equal_range(const key_type& k) const {
+            return pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+        }
+    };
+
+    template <class Key, class Compare, class Alloc>
+    void flat_set<Key, Compare, Alloc>::__merge_tail(size_type n0) {
+        size_type n = size();
+        if (n == n0) return;
+        size_type m = n - n0;
+        size_type* order = index_allocator::allocate(m);
+        try {
+            if (!__flat_sort_tail(keys.begin(), n0, n, comp, order)) {
+                index_allocator::deallocate(order, m);
+                return;
+            }
+            key_container new_keys;
+            new_keys.reserve(n);
+            size_type i = 0, j = 0;
+            while (i < n0 || j < m) {
+                if (j == m || (i < n0 && !comp(keys[order[j]], keys[i]))) {
+                    new_keys.push_back(LI::move(keys[i++]));
+                }
+                else {
+                    size_type x = order[j++];
+                    if (!new_keys.empty() && !comp(new_keys.back(), keys[x])) continue;
+                    new_keys.push_back(LI::move(keys[x]));
+                }
+            }
+            keys.swap(new_keys);
+        }
+        catch(...) {
+            index_allocator::deallocate(order, m);
+            clear();
+            throw;
+        }
+        index_allocator::deallocate(order, m);
+    }
+
+    template <class Key, class Compare, class Alloc>
+    inline void swap(flat_set<Key, Compare, Alloc>& x, flat_set<Key, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef LI_FROZEN_MAP_H_
+#define LI_FROZEN_MAP_H_
+
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+#include "li_construct.h"
+#include "li_iterator.h"
+#include "li_simd.h"
+#include "li_utility.h"
+#include <stdint.h>
+
+// frozen_map: map 的只读快照
+// 元素按键值递增存放在一个数组中 (迭代器就是指针), 另以隐式的静态 B+ 树 (S+ 树) 做查找:
+//   最底层是全部键值按顺序排列, 每 B 个一块; 上层每个节点也是 B 个键值, 有 B + 1 个子节点,
+//   节点 j 的子节点是下一层的第 j * (B + 1) + i 块 (i = 0 .. B), 不需要指针;
+//   节点中第 i 个键值是第 i + 1 个子树中最小的键值
+// B 取一个缓存行 (64 字节) 能放下的键值个数, 查找时每层只访问一个缓存行,
+// 块内以 "小于 x 的键值个数" 决定往哪个子节点走, int / unsigned int 配合 less 时用 SIMD 比较
+// 不足一块的部分以最大的键值填充, 填充的键值不会小于任何不超过最大键值的 x, 因此不影响查找
+//
+// 快照与原来的 map 互不影响: map 继续接受写入, 需要时再 freeze() 一个新的快照给读者使用
+namespace LI {
+
+    // 每块的键值个数: 一个缓存行放得下的个数, 至少 4 个
+    template <class Key>
+    struct __frozen_block_size {
+        enum { value = (64 / sizeof(Key) >= 4) ? 64 / sizeof(Key) : 4 };
+    };
+
+    // 块中小于 x 的键值个数
+    template <class Key, class Compare, int B>
+    struct __frozen_block_rank {
+        static size_t rank(const Key* block, const Key& x, const Compare& comp) {
+            size_t r = 0;
+            for (int i = 0; i < B; ++i) {
+                r += comp(block[i], x); // 块内有序, 但逐个累加没有分支, 比二分更快
+            }
+            return r;
+        }
+    };
+    // less 比较时, 能用 SIMD 的型别一次比较整个块
+    template <class Key, int B>
+    struct __frozen_block_rank<Key, less<Key>, B> {
+        static size_t rank(const Key* block, const Key& x, const less<Key>& comp) {
+            typedef typename __simd_traits<Key>::has_simd_order has_simd;
+            return __rank(block, x, comp, has_simd());
+        }
+        static size_t __rank(const Key* block, const Key& x, const less<Key>&, __true_type) {
+            return size_t(__simd_count_less(block, block + B, x));
+        }
+        static size_t __rank(const Key* block, const Key& x, const less<Key>& comp, __false_type) {
+            size_t r = 0;
+            for (int i = 0; i < B; ++i) {
+                r += comp(block[i], x);
+            }
+            return r;
+        }
+    };
+
+    // 最多的层数: B >= 4 时 5^28 已超过 2^64
+    const int __frozen_max_layers = 32;
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class frozen_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        typedef const value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef const value_type& reference;
+        typedef const value_type& const_reference;
+        typedef const value_type* iterator; // 快照只读
+        typedef const value_type* const_iterator;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        enum { block_size = __frozen_block_size<Key>::value };
+
+    private:
+        typedef simple_alloc<value_type, Alloc> data_allocator;
+        typedef simple_alloc<key_type, Alloc> key_allocator;
+
+        value_type* data; // 按键值递增存放的元素
+        size_type node_count;
+        key_type* storage; // 申请到的键值空间, 多出一块用于对齐到缓存行
+        size_type storage_size;
+        key_type* tree; // 各层的键值, 从根所在的层开始
+        size_type tree_size;
+        size_type layer_offset[__frozen_max_layers]; // 每层第一块在 tree 中的位置
+        int layers;
+        Compare comp; // 键值比较准则
+
+    public:
+        frozen_map() : data(nullptr), node_count(0), storage(nullptr), storage_size(0),
+                       tree(nullptr), tree_size(0), layers(0), comp(Compare()) { }
+        // 调用者保证区间按键值严格递增, 例如 map 的 [begin(), end())
+        template <class InputIterator>
+        frozen_map(InputIterator first, InputIterator last, sorted_unique_tag, const Compare& c = Compare())
+            : data(nullptr), node_count(0), storage(nullptr), storage_size(0),
+              tree(nullptr), tree_size(0), layers(0), comp(c) {
+            __init(first, last);
+        }
+        frozen_map(const frozen_map<Key, T, Compare, Alloc>& x)
+            : data(nullptr), node_count(0), storage(nullptr), storage_size(0),
+              tree(nullptr), tree_size(0), layers(0), comp(x.comp) {
+            __init(x.begin(), x.end());
+        }
+        frozen_map(frozen_map<Key, T, Compare, Alloc>&& x)
+            : data(nullptr), node_count(0), storage(nullptr), storage_size(0),
+              tree(nullptr), tree_size(0), layers(0), comp(x.comp) {
+            swap(x);
+        }
+        ~frozen_map() {
+            __clear();
+        }
+
+        frozen_map<Key, T, Compare, Alloc>& operator=(const frozen_map<Key, T, Compare, Alloc>& x) {
+            if (this != &x) {
+                frozen_map<Key, T, Compare, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        frozen_map<Key, T, Compare, Alloc>& operator=(frozen_map<Key, T, Compare, Alloc>&& x) {
+            if (this != &x) {
+                __clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(frozen_map<Key, T, Compare, Alloc>& x) {
+            LI::swap(data, x.data);
+            LI::swap(node_count, x.node_count);
+            LI::swap(storage, x.storage);
+            LI::swap(storage_size, x.storage_size);
+            LI::swap(tree, x.tree);
+            LI::swap(tree_size, x.tree_size);
+            for (int i = 0; i < __frozen_max_layers; ++i) {
+                LI::swap(layer_offset[i], x.layer_offset[i]);
+            }
+            LI::swap(layers, x.layers);
+            LI::swap(comp, x.comp);
+        }
+
+        key_compare key_comp() const { return comp; }
+        const_iterator begin() const { return data; }
+        const_iterator end() const { return data + node_count; }
+        bool empty() const { return node_count == 0; }
+        size_type size() const { return node_count; }
+
+        // 第 i 小的元素, 快照以数组存放, O(1)
+        const_reference operator[](size_type i) const { return data[i]; }
+
+        const_iterator lower_bound(const key_type& k) const { return data + __lower_bound(k); }
+        const_iterator upper_bound(const key_type& k) const {
+            size_type i = __lower_bound(k);
+            if (i != node_count && !comp(k, data[i].first)) ++i; // 键值不重复, 相等的至多一个
+            return data + i;
+        }
+        const_iterator find(const key_type& k) const {
+            size_type i = __lower_bound(k);
+            return (i == node_count || comp(k, data[i].first)) ? end() : data + i;
+        }
+        size_type count(const key_type& k) const {
+            return find(k) != end();
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            const_iterator first = lower_bound(k);
+            const_iterator last = first;
+            if (last != end() && !comp(k, last->first)) ++last;
+            return pair<const_iterator, const_iterator>(first, last);
+        }
+
+    private:
+        // 第一个不小于 k 的元素的序号
+        size_type __lower_bound(const key_type& k) const {
+            // 比最大的键值还大时直接返回; 此后每层的结果都不会越过实际存在的块
+            if (node_count == 0 || comp(data[node_count - 1].first, k)) return node_count;
+            size_type j = 0; // 当前层中的块号
+            for (int h = 0; h + 1 < layers; ++h) {
+                const key_type* block = tree + layer_offset[h] + j * block_size;
+                j = j * (block_size + 1) + __frozen_block_rank<Key, Compare, block_size>::rank(block, k, comp);
+            }
+            const key_type* leaf = tree + layer_offset[layers - 1] + j * block_size;
+            return j * block_size + __frozen_block_rank<Key, Compare, block_size>::rank(leaf, k, comp);
+        }
+
+        template <class InputIterator>
+        void __init(InputIterator first, InputIterator last);
+        void __build_tree();
+        void __clear() {
+            if (tree) {
+                destroy(tree, tree + tree_size);
+                key_allocator::deallocate(storage, storage_size);
+                tree = storage = nullptr;
+                tree_size = storage_size = 0;
+            }
+            if (data) {
+                destroy(data, data + node_count);
+                data_allocator::deallocate(data, node_count);
+                data = nullptr;
+                node_count = 0;
+            }
+            layers = 0;
+        }
+    };
+
+    // 先复制元素, 再建立查找用的各层键值
+    template <class Key, class T, class Compare, class Alloc>
+    template <class InputIterator>
+    void frozen_map<Key, T, Compare, Alloc>::__init(InputIterator first, InputIterator last) {
+        size_type n = size_type(LI::distance(first, last));
+        if (n == 0) return;
+        value_type* p = data_allocator::allocate(n);
+        value_type* cur = p;
+        try {
+            for ( ; first != last; ++first, ++cur) {
+                construct(cur, *first);
+            }
+        }
+        catch(...) {
+            destroy(p, cur);
+            data_allocator::deallocate(p, n);
+            throw;
+        }
+        data = p;
+        node_count = n;
+        try {
+            __build_tree();
+        }
+        catch(...) {
+            __clear();
+            throw;
+        }
+    }
+
+    template <class Key, class T, class Compare, class Alloc>
+    void frozen_map<Key, T, Compare, Alloc>::__build_tree() {
+        const size_type B = block_size;
+        // 自底向上求每层的块数
+        size_type blocks[__frozen_max_layers];
+        int h = 0;
+        blocks[0] = (node_count + B - 1) / B;
+        while (blocks[h] > 1) {
+            blocks[h + 1] = (blocks[h] + B) / (B + 1);
+            ++h;
+        }
+        layers = h + 1;
+        // 根所在的层放在最前面
+        tree_size = 0;
+        for (int i = 0; i < layers; ++i) {
+            layer_offset[i] = tree_size;
+            tree_size += blocks[layers - 1 - i] * B;
+        }
+
+        storage_size = tree_size + B;
+        storage = key_allocator::allocate(storage_size);
+        tree = storage;
+        if (64 % sizeof(key_type) == 0 && uintptr_t(storage) % sizeof(key_type) == 0) {
+            tree += ((64 - uintptr_t(storage) % 64) % 64) / sizeof(key_type); // 每块对齐到缓存行
+        }
+
+        const key_type& max_key = data[node_count - 1].first;
+        size_type built = 0;
+        try {
+            for (int i = 0; i < layers; ++i) {
+                int height = layers - 1 - i; // 距离最底层的层数
+                size_type span = 1; // 本层一块对应最底层的多少块
+                for (int d = 0; d < height; ++d) {
+                    span *= B + 1;
+                }
+                key_type* layer = tree + layer_offset[i];
+                for (size_type pos = 0; pos < blocks[height] * B; ++pos) {
+                    size_type first_leaf; // 该位置对应的元素序号
+                    if (height == 0) {
+                        first_leaf = pos;
+                    }
+                    else { // 第 i 个键值是第 i + 1 个子树最左边的键值
+                        size_type child = (pos / B) * (B + 1) + pos % B + 1;
+                        first_leaf = child * (span / (B + 1)) * B;
+                    }
+                    construct(layer + pos, first_leaf < node_count ? data[first_leaf].first : max_key);
+                    built = layer_offset[i] + pos + 1;
+                }
+            }
+        }
+        catch(...) {
+            destroy(tree, tree + built);
+            key_allocator::deallocate(storage, storage_size);
+            tree = storage = nullptr;
+            tree_size = storage_size = 0;
+            throw;
+        }
+    }
+
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(frozen_map<Key, T, Compare, Alloc>& x, frozen_map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
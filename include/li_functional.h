@@ -1,6 +1,12 @@
 #ifndef LI_FUNCTIONAL_H_
 #define LI_FUNCTIONAL_H_
 
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+#include "li_pair.h"
+#include "li_simd.h"
+
 namespace LI {
     // 用来呈现 一元函数的参数型别和返回值型别
     template <class Arg, class Result>
@@ -17,10 +23,19 @@ namespace LI {
         typedef Result result_type;
     };
 
-    template <class T>
+    template <class T = void>
     struct less : public binary_function<T, T, bool> {
         bool operator()(const T& x, const T& y) const { return x < y; }
     };
+
+    // 透明的比较器: 两个参数可以是不同的型别, 只要能以 < 比较
+    // 带有 is_transparent 标记, 关联容器据此开放以任意型别查找 (如以 const char* 查找 string 键值)
+    template <>
+    struct less<void> {
+        typedef void is_transparent;
+        template <class T, class U>
+        bool operator()(const T& x, const U& y) const { return x < y; }
+    };
     
     template <class T>
     struct identity : public unary_function<T, T> {
@@ -32,15 +47,221 @@ namespace LI {
         const typename Pair::first_type& operator()(const Pair& x) const { return x.first; }
     };
 
+    template <class T>
+    struct equal_to : public binary_function<T, T, bool> {
+        bool operator()(const T& x, const T& y) const { return x == y; }
+    };
 
+    // 哈希函数 ---------------------------------------------------
+    // 整数、指针、浮点数、字节串和 pair 的哈希值都已充分打散 (任一输入位改变, 每个输出位约以一半的概率改变),
+    // 带有 is_avalanching 标记, 哈希表据此不再打散一次; 其他型别需要自行提供哈希函数
+    // 没有随机种子, 不能抵御刻意构造的碰撞
+    template <class Key>
+    struct hash { };
 
+    // cv 限定的型别与原型别相同 (pair<const Key, T> 的 first)
+    template <class Key>
+    struct hash<const Key> : public hash<Key> { };
 
+    // 64 位乘法取 128 位乘积, 高低两半异或 (wyhash 的 mum)
+    inline uint64_t __hash_mum(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = (__uint128_t) a * b;
+        return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        return lo ^ hi;
+#endif
+    }
 
+    // 斐波那契乘法: 乘以 2^64 / 黄金分割比, 乘积的高位最均匀, 再折叠到低位
+    // 只有一次乘法, 但低位只受输入的低位影响, 并未充分打散
+    inline size_t __hash_fibonacci(size_t h) {
+#if SIZE_MAX > 0xffffffffu
+        h *= 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+#else
+        h *= 0x9E3779B9u;
+        return h ^ (h >> 16);
+#endif
+    }
 
+    // murmur3 的终结函数 fmix64: 两次乘法, 三次移位异或, 整数的默认哈希
+    // (只做一次 128 位乘法更快, 但输入的最低位总是翻转输出的最低位, 并未充分打散)
+    inline uint64_t __hash_fmix(uint64_t k) {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdull;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ull;
+        k ^= k >> 33;
+        return k;
+    }
 
-}
+    // 两个哈希值合并为一个, 与次序有关 (hash(a, b) 与 hash(b, a) 不同)
+    inline size_t __hash_combine(size_t a, size_t b) {
+        return size_t(__hash_mum(uint64_t(a) ^ 0xa0761d6478bd642full, uint64_t(b) ^ 0xe7037ed1a0b428dbull));
+    }
+
+    inline uint64_t __hash_read8(const unsigned char* p) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+    inline uint64_t __hash_read4(const unsigned char* p) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    // 超过 256 字节的字节串: 以 SIMD 累加 64 字节一条 (li_simd.h), 最后一条与前面重叠, 再合并 8 个累加器
+    inline uint64_t __hash_bytes_long(const unsigned char* p, size_t len, uint64_t seed) {
+        const uint64_t* secret = __hash_secret<true>::key;
+        uint64_t acc[8] = {
+            0x00000000C2B2AE3Dull, 0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull,
+            0x85EBCA77C2B2AE63ull, 0x0000000085EBCA77ull, 0x27D4EB2F165667C5ull, 0x000000009E3779B1ull
+        };
+        for (int i = 0; i < 8; ++i) {
+            acc[i] += seed;
+        }
+        __simd_hash_stripes(acc, p, (len - 1) / 64);
+        __hash_stripe_scalar(acc, p + len - 64, secret + 3);
+        uint64_t h = len * 0x9E3779B185EBCA87ull;
+        for (int i = 0; i < 4; ++i) {
+            h += __hash_mum(acc[2 * i] ^ secret[8 + 2 * i], acc[2 * i + 1] ^ secret[9 + 2 * i]);
+        }
+        h ^= h >> 37;
+        h *= 0x165667919E3779F9ull;
+        return h ^ (h >> 32);
+    }
+
+    // 字节串哈希 (wyhash 的方式)
+    // 不超过 16 字节时只读首尾两段, 没有循环; 不超过 256 字节时每次处理 48 字节, 三路乘法互不依赖
+    inline size_t __hash_bytes(const void* data, size_t len, uint64_t seed = 0) {
+        const unsigned char* p = (const unsigned char*) data;
+        const uint64_t s0 = 0xa0761d6478bd642full, s1 = 0xe7037ed1a0b428dbull;
+        const uint64_t s2 = 0x8ebc6af09c88c6e3ull, s3 = 0x589965cc75374cc3ull;
+        if (len > 256) {
+            return size_t(__hash_bytes_long(p, len, seed));
+        }
+        seed ^= __hash_mum(seed ^ s0, s1);
+        uint64_t a, b;
+        if (len <= 16) {
+            if (len >= 4) {
+                size_t d = (len >> 3) << 2; // 8 字节以上时首尾各读 8 字节, 否则各读 4 字节 (可能重叠)
+                a = (__hash_read4(p) << 32) | __hash_read4(p + d);
+                b = (__hash_read4(p + len - 4) << 32) | __hash_read4(p + len - 4 - d);
+            }
+            else if (len > 0) {
+                a = ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8) | p[len - 1];
+                b = 0;
+            }
+            else {
+                a = b = 0;
+            }
+        }
+        else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t see1 = seed, see2 = seed;
+                do {
+                    seed = __hash_mum(__hash_read8(p) ^ s1, __hash_read8(p + 8) ^ seed);
+                    see1 = __hash_mum(__hash_read8(p + 16) ^ s2, __hash_read8(p + 24) ^ see1);
+                    see2 = __hash_mum(__hash_read8(p + 32) ^ s3, __hash_read8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            for ( ; i > 16; i -= 16, p += 16) {
+                seed = __hash_mum(__hash_read8(p) ^ s1, __hash_read8(p + 8) ^ seed);
+            }
+            a = __hash_read8(p + i - 16);
+            b = __hash_read8(p + i - 8);
+        }
+        return size_t(__hash_mum(s1 ^ len, __hash_mum(a ^ s1, b ^ seed)));
+    }
+
+    template <>
+    struct hash<char*> {
+        typedef void is_avalanching;
+        size_t operator()(const char* s) const { return __hash_bytes(s, strlen(s)); }
+    };
+    template <>
+    struct hash<const char*> {
+        typedef void is_avalanching;
+        size_t operator()(const char* s) const { return __hash_bytes(s, strlen(s)); }
+    };
 
+#define __LI_HASH_INTEGER(T) \
+    template <> \
+    struct hash<T> { \
+        typedef void is_avalanching; \
+        size_t operator()(T x) const { return size_t(__hash_fmix(uint64_t(x))); } \
+    };
+    __LI_HASH_INTEGER(bool)
+    __LI_HASH_INTEGER(char)
+    __LI_HASH_INTEGER(signed char)
+    __LI_HASH_INTEGER(unsigned char)
+    __LI_HASH_INTEGER(wchar_t)
+    __LI_HASH_INTEGER(char16_t)
+    __LI_HASH_INTEGER(char32_t)
+    __LI_HASH_INTEGER(short)
+    __LI_HASH_INTEGER(unsigned short)
+    __LI_HASH_INTEGER(int)
+    __LI_HASH_INTEGER(unsigned int)
+    __LI_HASH_INTEGER(long)
+    __LI_HASH_INTEGER(unsigned long)
+    __LI_HASH_INTEGER(long long)
+    __LI_HASH_INTEGER(unsigned long long)
+#undef __LI_HASH_INTEGER
+
+    template <class T>
+    struct hash<T*> {
+        typedef void is_avalanching;
+        size_t operator()(T* p) const { return size_t(__hash_fmix(uint64_t(uintptr_t(p)))); }
+    };
+
+    // 浮点数按位哈希, +0.0 与 -0.0 相等, 哈希值也必须相同
+    template <>
+    struct hash<float> {
+        typedef void is_avalanching;
+        size_t operator()(float x) const {
+            uint32_t bits = 0;
+            if (x != 0.0f) memcpy(&bits, &x, sizeof(x));
+            return size_t(__hash_fmix(bits));
+        }
+    };
+    template <>
+    struct hash<double> {
+        typedef void is_avalanching;
+        size_t operator()(double x) const {
+            uint64_t bits = 0;
+            if (x != 0.0) memcpy(&bits, &x, sizeof(x));
+            return size_t(__hash_fmix(bits));
+        }
+    };
 
+    template <class T1, class T2>
+    struct hash<pair<T1, T2> > {
+        typedef void is_avalanching;
+        size_t operator()(const pair<T1, T2>& x) const {
+            return __hash_combine(hash<T1>()(x.first), hash<T2>()(x.second));
+        }
+    };
+
+    // 斐波那契乘法的整数哈希: 比默认的 hash 快, 但未充分打散, 哈希表会再打散一次
+    template <class T>
+    struct fibonacci_hash : public unary_function<T, size_t> {
+        size_t operator()(T x) const { return __hash_fibonacci(size_t(x)); }
+    };
+
+}
 
 
 #endif
\ No newline at end of file
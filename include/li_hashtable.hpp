@@ -0,0 +1,522 @@
+#ifndef LI_HASHTABLE_H_
+#define LI_HASHTABLE_H_
+
+#include "li_iterator.h"
+#include "li_alloc.h"
+#include "li_construct.h"
+#include "li_pair.h"
+#include "li_utility.h"
+#include "li_functional.h"
+#include "li_simd.h"
+#include <stdint.h>
+
+// 开放定址的哈希表 (Swiss table 的做法)
+// 1. 元素直接存放在 slots 数组中, 另有一个控制字节数组 ctrl: 空位为 -128, 有元素时为其哈希值的低 7 位 (h2)
+// 2. 哈希值的其余位 (h1) 决定从哪个位置开始探测; 每次取 16 个控制字节, 以 SSE2 一条比较指令找出 h2 相同的位置,
+//    只有这些位置才需要比较键值; 这一组中有空位时, 键值若存在一定已经找到, 查找结束
+// 3. 以 16 个位置为步长线性探测: 一个元素与其起始位置之间没有空位
+//    删除时把其后能够前移的元素依次前移 (backward shift), 不留下墓碑, 删除再多查找也不会变慢
+// 4. ctrl 的尾端多出 15 个字节, 复制开头的 15 个控制字节, 从任何位置开始读 16 个字节都不必绕回
+// 5. 遍历从某个空位之后开始, 因此任何一段连续的元素都不会跨过遍历的起点;
+//    删除时前移的元素都来自被删位置之后, 边遍历边以 erase 的返回值删除不会漏掉或重复访问元素
+//
+// 插入可能重新配置 (rehash), 插入和删除都会使迭代器失效 (erase 的返回值除外)
+namespace LI {
+
+    const int __hashtable_group_width = 16;
+    const signed char __hashtable_empty = -128;
+
+    // 容量为 0 时 ctrl 指向这一组空位, 查找不需要另外判断容量
+    template <bool Dummy>
+    struct __hashtable_empty_group {
+        static const signed char group[__hashtable_group_width];
+    };
+    template <bool Dummy>
+    const signed char __hashtable_empty_group<Dummy>::group[__hashtable_group_width] = {
+        -128, -128, -128, -128, -128, -128, -128, -128,
+        -128, -128, -128, -128, -128, -128, -128, -128
+    };
+
+    // 哈希函数带有 is_avalanching 标记时哈希值已充分打散, 直接使用;
+    // 否则 (如整数直接作为哈希值) 以斐波那契乘法打散一次
+    template <class HashFcn, class = void>
+    struct __hashtable_avalanching {
+        typedef __false_type type;
+    };
+    template <class HashFcn>
+    struct __hashtable_avalanching<HashFcn, typename __void_type<typename HashFcn::is_avalanching>::type> {
+        typedef __true_type type;
+    };
+
+    template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class Alloc>
+    class hashtable;
+
+    // 哈希表的迭代器: (表, 位置), 从遍历的起点出发绕一圈
+    template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class Alloc, class Ref, class Ptr>
+    struct __hashtable_iterator {
+        typedef hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc> table;
+        typedef __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, Value&, Value*> iterator;
+        typedef __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, Ref, Ptr> self;
+        typedef size_t size_type;
+
+        typedef forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+
+        const table* ht;
+        size_type pos; // ht->capacity 表示 end()
+
+        __hashtable_iterator() : ht(nullptr), pos(0) { }
+        __hashtable_iterator(const table* t, size_type p) : ht(t), pos(p) { }
+        __hashtable_iterator(const iterator& it) : ht(it.ht), pos(it.pos) { }
+
+        reference operator*() const { return ht->slots[pos]; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            pos = ht->__next_full(pos);
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+    };
+
+    template <class V, class K, class HF, class EK, class EQ, class A, class Ref1, class Ptr1, class Ref2, class Ptr2>
+    inline bool operator==(const __hashtable_iterator<V, K, HF, EK, EQ, A, Ref1, Ptr1>& x,
+                           const __hashtable_iterator<V, K, HF, EK, EQ, A, Ref2, Ptr2>& y) {
+        return x.pos == y.pos;
+    }
+    template <class V, class K, class HF, class EK, class EQ, class A, class Ref1, class Ptr1, class Ref2, class Ptr2>
+    inline bool operator!=(const __hashtable_iterator<V, K, HF, EK, EQ, A, Ref1, Ptr1>& x,
+                           const __hashtable_iterator<V, K, HF, EK, EQ, A, Ref2, Ptr2>& y) {
+        return x.pos != y.pos;
+    }
+
+
+    template <class Value, class Key, class HashFcn, class ExtractKey, class EqualKey, class Alloc = alloc>
+    class hashtable {
+    public:
+        typedef Key key_type;
+        typedef Value value_type;
+        typedef HashFcn hasher;
+        typedef EqualKey key_equal;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef value_type* pointer;
+        typedef const value_type* const_pointer;
+        typedef value_type& reference;
+        typedef const value_type& const_reference;
+
+        typedef __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, Value&, Value*> iterator;
+        typedef __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, const Value&, const Value*> const_iterator;
+        friend struct __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, Value&, Value*>;
+        friend struct __hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc, const Value&, const Value*>;
+
+    private:
+        typedef simple_alloc<value_type, Alloc> slot_allocator;
+        typedef simple_alloc<signed char, Alloc> ctrl_allocator;
+        enum { W = __hashtable_group_width };
+
+        hasher hash;
+        key_equal equals;
+        ExtractKey get_key;
+
+        signed char* ctrl; // capacity + W - 1 个控制字节
+        value_type* slots;
+        size_type capacity; // 2 的幂, 或 0
+        size_type mask; // capacity - 1
+        size_type num_elements;
+        size_type growth_left; // 还能插入几个元素而不必 rehash
+        size_type iter_start; // 遍历的起点, 其前一个位置是空位
+        float max_load;
+
+        static bool is_full(signed char c) { return c >= 0; }
+        size_type hash_of(const key_type& k) const {
+            return mix(hash(k), typename __hashtable_avalanching<HashFcn>::type());
+        }
+        static size_type mix(size_type h, __true_type) { return h; }
+        static size_type mix(size_type h, __false_type) { return __hash_fibonacci(h); }
+        static size_type h1(size_type h) { return h >> 7; }
+        static signed char h2(size_type h) { return (signed char) (h & 0x7f); }
+
+        // 设置位置 i 的控制字节, i < W - 1 时同时写尾端的副本
+        void set_ctrl(size_type i, signed char c) {
+            ctrl[i] = c;
+            ctrl[((i - (W - 1)) & mask) + (W - 1)] = c;
+        }
+        // 键值为 k (哈希值 h) 的元素所在的位置, 不存在时返回 capacity
+        size_type __find(const key_type& k, size_type h) const;
+        // 从 h 的起始位置开始的第一个空位, 表中至少有一个空位
+        size_type __find_empty(size_type h) const {
+            size_type pos = h1(h) & mask;
+            while (true) {
+                unsigned int empty = __group_match_negative(ctrl + pos);
+                if (empty) return (pos + __lowest_bit(empty)) & mask;
+                pos = (pos + W) & mask;
+            }
+        }
+        // pos 之后 (按遍历顺序) 的第一个元素, 没有时返回 capacity
+        size_type __next_full(size_type pos) const {
+            while (true) {
+                pos = (pos + 1) & mask;
+                if (pos == iter_start) return capacity;
+                if (is_full(ctrl[pos])) return pos;
+            }
+        }
+        size_type __first_full() const {
+            if (num_elements == 0) return capacity;
+            return is_full(ctrl[iter_start]) ? iter_start : __next_full(iter_start);
+        }
+        // 以空位 e 之后的位置作为遍历的起点
+        void __reset_iter_start(size_type from) {
+            size_type e = from;
+            while (is_full(ctrl[e])) e = (e + 1) & mask;
+            iter_start = (e + 1) & mask;
+        }
+        // 容量为 c 时最多容纳的元素个数, 至少留一个空位
+        size_type __growth_limit(size_type c) const {
+            size_type n = size_type(c * max_load);
+            return n < c - 1 ? n : c - 1;
+        }
+        size_type __capacity_for(size_type n) const;
+        void __rehash(size_type new_capacity);
+        void __deallocate() {
+            if (capacity) {
+                ctrl_allocator::deallocate(ctrl, capacity + W - 1);
+                slot_allocator::deallocate(slots, capacity);
+            }
+        }
+        void __init_empty() {
+            ctrl = const_cast<signed char*>(__hashtable_empty_group<true>::group);
+            slots = nullptr;
+            capacity = mask = 0;
+            num_elements = growth_left = 0;
+            iter_start = 0;
+        }
+        // 把位置 i 的元素删除, 其后能前移的元素依次前移, 返回按遍历顺序的下一个元素
+        size_type __erase_at(size_type i);
+        void __copy_from(const hashtable& x);
+
+    public:
+        hashtable(size_type n, const HashFcn& hf, const EqualKey& eql)
+            : hash(hf), equals(eql), get_key(ExtractKey()), max_load(0.875f) {
+            __init_empty();
+            if (n) __rehash(__capacity_for(n));
+        }
+        hashtable(const hashtable& x) : hash(x.hash), equals(x.equals), get_key(x.get_key), max_load(x.max_load) {
+            __init_empty();
+            __copy_from(x);
+        }
+        hashtable(hashtable&& x) : hash(x.hash), equals(x.equals), get_key(x.get_key), max_load(x.max_load) {
+            __init_empty();
+            swap(x);
+        }
+        ~hashtable() {
+            clear();
+            __deallocate();
+        }
+        hashtable& operator=(const hashtable& x) {
+            if (this != &x) {
+                hashtable tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        hashtable& operator=(hashtable&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(hashtable& x) {
+            LI::swap(hash, x.hash);
+            LI::swap(equals, x.equals);
+            LI::swap(ctrl, x.ctrl);
+            LI::swap(slots, x.slots);
+            LI::swap(capacity, x.capacity);
+            LI::swap(mask, x.mask);
+            LI::swap(num_elements, x.num_elements);
+            LI::swap(growth_left, x.growth_left);
+            LI::swap(iter_start, x.iter_start);
+            LI::swap(max_load, x.max_load);
+        }
+
+        hasher hash_funct() const { return hash; }
+        key_equal key_eq() const { return equals; }
+        size_type size() const { return num_elements; }
+        size_type max_size() const { return size_type(-1) / sizeof(value_type); }
+        bool empty() const { return num_elements == 0; }
+
+        iterator begin() { return iterator(this, __first_full()); }
+        iterator end() { return iterator(this, capacity); }
+        const_iterator begin() const { return const_iterator(this, __first_full()); }
+        const_iterator end() const { return const_iterator(this, capacity); }
+
+        // 容量相关 ------------------------------------------------------
+        size_type bucket_count() const { return capacity; }
+        float load_factor() const { return capacity ? float(num_elements) / capacity : 0.0f; }
+        float max_load_factor() const { return max_load; }
+        // 负载因子上限, 限制在 (0, 15/16] 之内, 保证表中总有空位; 调低到现有元素放不下时立即 rehash
+        void max_load_factor(float f) {
+            if (!(f > 0.0f)) f = 0.875f;
+            if (f > 0.9375f) f = 0.9375f;
+            max_load = f;
+            if (capacity == 0) return;
+            if (__growth_limit(capacity) < num_elements) {
+                __rehash(__capacity_for(num_elements));
+            }
+            else {
+                growth_left = __growth_limit(capacity) - num_elements;
+            }
+        }
+        // 使容量至少为 n, 且能容纳现有元素
+        void rehash(size_type n) {
+            size_type c = __capacity_for(num_elements);
+            while (c < n) c <<= 1;
+            if (c != capacity) __rehash(c);
+        }
+        // 预留 n 个元素的空间, 之后插入不再 rehash
+        void reserve(size_type n) {
+            if (n > num_elements + growth_left) __rehash(__capacity_for(n));
+        }
+
+        // 插入 ------------------------------------------------------
+        // 键值 k 不存在时才以 args 在空位中直接构造元素
+        template <class... Args>
+        pair<iterator, bool> try_emplace_unique(const key_type& k, Args&&... args);
+        pair<iterator, bool> insert_unique(const value_type& v) {
+            return try_emplace_unique(get_key(v), v);
+        }
+        pair<iterator, bool> insert_unique(value_type&& v) {
+            return try_emplace_unique(get_key(v), LI::move(v));
+        }
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for ( ; first != last; ++first) {
+                insert_unique(*first);
+            }
+        }
+        // 先构造元素再查找, 键值重复时元素被丢弃
+        template <class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args) {
+            value_type v(LI::forward<Args>(args)...);
+            return try_emplace_unique(get_key(v), LI::move(v));
+        }
+
+        // 删除 ------------------------------------------------------
+        iterator erase(const_iterator position) {
+            return iterator(this, __erase_at(position.pos));
+        }
+        size_type erase(const key_type& k) {
+            size_type i = __find(k, hash_of(k));
+            if (i == capacity) return 0;
+            __erase_at(i);
+            return 1;
+        }
+        void clear();
+
+        // 查找 ------------------------------------------------------
+        iterator find(const key_type& k) { return iterator(this, __find(k, hash_of(k))); }
+        const_iterator find(const key_type& k) const { return const_iterator(this, __find(k, hash_of(k))); }
+        size_type count(const key_type& k) const { return __find(k, hash_of(k)) != capacity; }
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            iterator i = find(k);
+            iterator j = i;
+            if (j != end()) ++j;
+            return pair<iterator, iterator>(i, j);
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            const_iterator i = find(k);
+            const_iterator j = i;
+            if (j != end()) ++j;
+            return pair<const_iterator, const_iterator>(i, j);
+        }
+    };
+
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    typename hashtable<V, K, HF, EK, EQ, A>::size_type
+    hashtable<V, K, HF, EK, EQ, A>::__find(const key_type& k, size_type h) const {
+        const signed char tag = h2(h);
+        size_type pos = h1(h) & mask;
+        while (true) {
+            const signed char* group = ctrl + pos;
+            unsigned int match = __group_match_byte(group, tag);
+            while (match) {
+                size_type i = (pos + __lowest_bit(match)) & mask;
+                if (equals(get_key(slots[i]), k)) return i;
+                match &= match - 1;
+            }
+            // 这一组中有空位, 探测序列到此为止
+            if (__group_match_negative(group)) return capacity;
+            pos = (pos + W) & mask;
+        }
+    }
+
+    // 容纳 n 个元素所需的最小容量
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    typename hashtable<V, K, HF, EK, EQ, A>::size_type
+    hashtable<V, K, HF, EK, EQ, A>::__capacity_for(size_type n) const {
+        if (n == 0) return 0;
+        size_type c = W;
+        while (__growth_limit(c) < n) c <<= 1;
+        return c;
+    }
+
+    // 配置新的数组, 把元素逐个移动过去; 新表中没有相同的键值, 不必比较
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    void hashtable<V, K, HF, EK, EQ, A>::__rehash(size_type new_capacity) {
+        signed char* old_ctrl = ctrl;
+        value_type* old_slots = slots;
+        size_type old_capacity = capacity;
+        size_type n = num_elements;
+
+        if (new_capacity == 0) { // 只会在没有元素时发生
+            __deallocate();
+            __init_empty();
+            return;
+        }
+        if (new_capacity > max_size()) { // 容量翻倍后溢出
+            throw std::bad_alloc();
+        }
+        signed char* new_ctrl = ctrl_allocator::allocate(new_capacity + W - 1);
+        value_type* new_slots;
+        try {
+            new_slots = slot_allocator::allocate(new_capacity);
+        }
+        catch(...) {
+            ctrl_allocator::deallocate(new_ctrl, new_capacity + W - 1);
+            throw;
+        }
+        for (size_type i = 0; i < new_capacity + W - 1; ++i) {
+            new_ctrl[i] = __hashtable_empty;
+        }
+        ctrl = new_ctrl;
+        slots = new_slots;
+        capacity = new_capacity;
+        mask = new_capacity - 1;
+        num_elements = n;
+        growth_left = __growth_limit(new_capacity) - n;
+
+        for (size_type i = 0; i < old_capacity; ++i) {
+            if (is_full(old_ctrl[i])) {
+                size_type h = hash_of(get_key(old_slots[i]));
+                size_type j = __find_empty(h);
+                construct(slots + j, LI::move(old_slots[i]));
+                destroy(old_slots + i);
+                set_ctrl(j, h2(h));
+            }
+        }
+        if (old_capacity) {
+            ctrl_allocator::deallocate(old_ctrl, old_capacity + W - 1);
+            slot_allocator::deallocate(old_slots, old_capacity);
+        }
+        __reset_iter_start(0);
+    }
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    template <class... Args>
+    pair<typename hashtable<V, K, HF, EK, EQ, A>::iterator, bool>
+    hashtable<V, K, HF, EK, EQ, A>::try_emplace_unique(const key_type& k, Args&&... args) {
+        size_type h = hash_of(k);
+        size_type i = __find(k, h);
+        if (i != capacity) return pair<iterator, bool>(iterator(this, i), false);
+        if (growth_left == 0) {
+            // args 可能引用表中的元素, rehash 会搬动它们, 所以先构造好元素
+            value_type v(LI::forward<Args>(args)...);
+            __rehash(__capacity_for(num_elements + 1));
+            i = __find_empty(h);
+            construct(slots + i, LI::move(v));
+        }
+        else {
+            i = __find_empty(h);
+            construct(slots + i, LI::forward<Args>(args)...);
+        }
+        set_ctrl(i, h2(h));
+        ++num_elements;
+        --growth_left;
+        if (i == ((iter_start - 1) & mask)) {
+            __reset_iter_start(i); // 填上了遍历起点之前的空位
+        }
+        return pair<iterator, bool>(iterator(this, i), true);
+    }
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    typename hashtable<V, K, HF, EK, EQ, A>::size_type
+    hashtable<V, K, HF, EK, EQ, A>::__erase_at(size_type i) {
+        destroy(slots + i);
+        --num_elements;
+        ++growth_left;
+        size_type hole = i;
+        size_type j = (i + 1) & mask;
+        // 向后扫描到空位为止: 起始位置不在 (hole, j] 之内的元素可以移到 hole
+        while (is_full(ctrl[j])) {
+            size_type h = hash_of(get_key(slots[j]));
+            size_type home = h1(h) & mask;
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                construct(slots + hole, LI::move(slots[j]));
+                destroy(slots + j);
+                set_ctrl(hole, ctrl[j]);
+                hole = j;
+            }
+            j = (j + 1) & mask;
+        }
+        set_ctrl(hole, __hashtable_empty);
+        if (num_elements == 0) return capacity;
+        return is_full(ctrl[i]) ? i : __next_full(i);
+    }
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    void hashtable<V, K, HF, EK, EQ, A>::clear() {
+        if (num_elements) {
+            for (size_type i = 0; i < capacity; ++i) {
+                if (is_full(ctrl[i])) {
+                    destroy(slots + i);
+                }
+            }
+            for (size_type i = 0; i < capacity + W - 1; ++i) {
+                ctrl[i] = __hashtable_empty;
+            }
+            num_elements = 0;
+        }
+        if (capacity) {
+            growth_left = __growth_limit(capacity);
+        }
+        iter_start = 0;
+    }
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    void hashtable<V, K, HF, EK, EQ, A>::__copy_from(const hashtable& x) {
+        if (x.num_elements == 0) return;
+        __rehash(__capacity_for(x.num_elements));
+        try {
+            for (const_iterator i = x.begin(); i != x.end(); ++i) {
+                size_type h = hash_of(get_key(*i));
+                size_type j = __find_empty(h);
+                construct(slots + j, *i);
+                set_ctrl(j, h2(h));
+                ++num_elements;
+                --growth_left;
+            }
+        }
+        catch(...) {
+            clear();
+            throw;
+        }
+        __reset_iter_start(0);
+    }
+
+    template <class V, class K, class HF, class EK, class EQ, class A>
+    inline void swap(hashtable<V, K, HF, EK, EQ, A>& x, hashtable<V, K, HF, EK, EQ, A>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef LI_HEAP_H_
+#define LI_HEAP_H_
+
+#include "li_iterator.h"
+
+// heap 算法 (max-heap), 以随机访问迭代器表示的完全二叉树
+// 节点 i 的子节点为 2i+1 和 2i+2
+namespace LI {
+
+    // push_heap 算法 -----------------------------------------------
+    // 新元素已经位于容器尾端, 将其上溯到合适的位置
+
+    template <class RandomAccessIterator, class Distance, class T>
+    void __push_heap(RandomAccessIterator first, Distance holeIndex, Distance topIndex, T value) {
+        Distance parent = (holeIndex - 1) / 2; // 父节点
+        while (holeIndex > topIndex && *(first + parent) < value) {
+            *(first + holeIndex) = *(first + parent); // 父节点下移
+            holeIndex = parent;
+            parent = (holeIndex - 1) / 2;
+        }
+        *(first + holeIndex) = value;
+    }
+
+    template <class RandomAccessIterator, class Distance, class T>
+    inline void __push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Distance*, T*) {
+        LI::__push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)));
+    }
+
+    template <class RandomAccessIterator>
+    inline void push_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        LI::__push_heap_aux(first, last, distance_type(first), value_type(first));
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class Distance, class T, class Compare>
+    void __push_heap(RandomAccessIterator first, Distance holeIndex, Distance topIndex, T value, Compare comp) {
+        Distance parent = (holeIndex - 1) / 2;
+        while (holeIndex > topIndex && comp(*(first + parent), value)) {
+            *(first + holeIndex) = *(first + parent);
+            holeIndex = parent;
+            parent = (holeIndex - 1) / 2;
+        }
+        *(first + holeIndex) = value;
+    }
+
+    template <class RandomAccessIterator, class Compare, class Distance, class T>
+    inline void __push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Compare comp, Distance*, T*) {
+        LI::__push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)), comp);
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        LI::__push_heap_aux(first, last, comp, distance_type(first), value_type(first));
+    }
+
+
+    // pop_heap 算法 -----------------------------------------------
+    // 把根节点 (最大值) 移到尾端, 并重新调整 [first, last - 1) 为 heap
+
+    // 洞从 holeIndex 一路下沉到叶子, 再把 value 上溯
+    // 比边比较边下沉少一半的比较次数
+    template <class RandomAccessIterator, class Distance, class T>
+    void __adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len, T value) {
+        Distance topIndex = holeIndex;
+        Distance secondChild = 2 * holeIndex + 2; // 右子节点
+        while (secondChild < len) {
+            // 取两个子节点中较大者
+            if (*(first + secondChild) < *(first + (secondChild - 1))) {
+                --secondChild;
+            }
+            *(first + holeIndex) = *(first + secondChild);
+            holeIndex = secondChild;
+            secondChild = 2 * (secondChild + 1);
+        }
+        if (secondChild == len) { // 只有左子节点
+            *(first + holeIndex) = *(first + (secondChild - 1));
+            holeIndex = secondChild - 1;
+        }
+        LI::__push_heap(first, holeIndex, topIndex, value);
+    }
+
+    template <class RandomAccessIterator, class T, class Distance>
+    inline void __pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result, T value, Distance*) {
+        *result = *first; // 最大值放到 result
+        LI::__adjust_heap(first, Distance(0), Distance(last - first), value);
+    }
+
+    template <class RandomAccessIterator, class T>
+    inline void __pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*) {
+        LI::__pop_heap(first, last - 1, last - 1, T(*(last - 1)), distance_type(first));
+    }
+
+    template <class RandomAccessIterator>
+    inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        LI::__pop_heap_aux(first, last, value_type(first));
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class Distance, class T, class Compare>
+    void __adjust_heap(RandomAccessIterator first, Distance holeIndex, Distance len, T value, Compare comp) {
+        Distance topIndex = holeIndex;
+        Distance secondChild = 2 * holeIndex + 2;
+        while (secondChild < len) {
+            if (comp(*(first + secondChild), *(first + (secondChild - 1)))) {
+                --secondChild;
+            }
+            *(first + holeIndex) = *(first + secondChild);
+            holeIndex = secondChild;
+            secondChild = 2 * (secondChild + 1);
+        }
+        if (secondChild == len) {
+            *(first + holeIndex) = *(first + (secondChild - 1));
+            holeIndex = secondChild - 1;
+        }
+        LI::__push_heap(first, holeIndex, topIndex, value, comp);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare, class Distance>
+    inline void __pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result, T value, Compare comp, Distance*) {
+        *result = *first;
+        LI::__adjust_heap(first, Distance(0), Distance(last - first), value, comp);
+    }
+
+    template <class RandomAccessIterator, class T, class Compare>
+    inline void __pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp) {
+        LI::__pop_heap(first, last - 1, last - 1, T(*(last - 1)), comp, distance_type(first));
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        LI::__pop_heap_aux(first, last, value_type(first), comp);
+    }
+
+
+    // make_heap 算法 -----------------------------------------------
+    // 从最后一个非叶子节点开始, 依次下沉
+
+    template <class RandomAccessIterator, class T, class Distance>
+    void __make_heap(RandomAccessIterator first, RandomAccessIterator last, T*, Distance*) {
+        if (last - first < 2) return; // 长度为 0 或 1, 不必重排
+        Distance len = last - first;
+        Distance parent = (len - 2) / 2;
+        while (true) {
+            LI::__adjust_heap(first, parent, len, T(*(first + parent)));
+            if (parent == 0) return;
+            --parent;
+        }
+    }
+
+    template <class RandomAccessIterator>
+    inline void make_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        LI::__make_heap(first, last, value_type(first), distance_type(first));
+    }
+
+    // 自定义比较准则的版本
+    template <class RandomAccessIterator, class Compare, class T, class Distance>
+    void __make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp, T*, Distance*) {
+        if (last - first < 2) return;
+        Distance len = last - first;
+        Distance parent = (len - 2) / 2;
+        while (true) {
+            LI::__adjust_heap(first, parent, len, T(*(first + parent)), comp);
+            if (parent == 0) return;
+            --parent;
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    inline void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        LI::__make_heap(first, last, comp, value_type(first), distance_type(first));
+    }
+
+
+    // sort_heap 算法 -----------------------------------------------
+    // 不断 pop_heap, 最终得到递增序列
+
+    template <class RandomAccessIterator>
+    void sort_heap(RandomAccessIterator first, RandomAccessIterator last) {
+        while (last - first > 1) {
+            LI::pop_heap(first, last--);
+        }
+    }
+
+    template <class RandomAccessIterator, class Compare>
+    void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp) {
+        while (last - first > 1) {
+            LI::pop_heap(first, last--, comp);
+        }
+    }
+
+}
+
+
+#endif
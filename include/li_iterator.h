@@ -11,6 +11,11 @@ namespace LI {
     struct bidirectional_iterator_tag : public forward_iterator_tag {};
     struct random_access_iterator_tag : public bidirectional_iterator_tag {};
 
+    // 标记输入区间已经严格递增排列 (没有重复键值), 容器可以跳过查找直接建立
+    struct sorted_unique_tag {};
+    // 标记输入区间已经按键值递增排列, 允许相等的键值, 供 multiset / multimap 使用
+    struct sorted_equivalent_t {};
+
     // 迭代器基本类型
     template <class Category, class T, class Distance = ptrdiff_t, class Pointer = T*, class Reference = T&>
     struct iterator {
@@ -0,0 +1,126 @@
+#ifndef LI_LOCK_H_
+#define LI_LOCK_H_
+
+#include <atomic>
+#include <thread>
+
+// 自旋锁与读写锁 (多线程的内存池和 concurrent_map 使用)
+// 临界区都很短, 先忙等; 连续失败多次后让出 CPU, 线程数多于核数时也不会一直空转
+namespace LI {
+
+    // 忙等一次: 前若干次只让出流水线 (x86 的 pause), 之后让出 CPU
+    inline void __spin_pause(unsigned int& spins) {
+        if (++spins < 64) {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_ia32_pause();
+#endif
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    // test-and-test-and-set 自旋锁: 等待时只读不写, 不会让持有者所在核的缓存行反复失效
+    class __spin_lock {
+    private:
+        std::atomic<bool> locked;
+
+    public:
+        constexpr __spin_lock() : locked(false) { }
+        __spin_lock(const __spin_lock&) = delete;
+        __spin_lock& operator=(const __spin_lock&) = delete;
+
+        void lock() {
+            unsigned int spins = 0;
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    __spin_pause(spins);
+                }
+            }
+        }
+        bool try_lock() {
+            return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+        }
+        void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+    };
+
+    // 读写锁: 多个读者可以同时持有, 写者独占
+    // state 最低位表示写者持有, 次低位表示有写者在等待, 其余位是读者个数
+    // 有写者等待时新的读者不再进入, 读者再多写者也不会饿死
+    // 读者只做一次 fetch_add, 不会因为与其他读者竞争 compare_exchange 而重试
+    class __rw_spin_lock {
+    private:
+        enum { WRITER = 1, PENDING = 2, READER = 4 };
+        std::atomic<unsigned int> state;
+
+    public:
+        constexpr __rw_spin_lock() : state(0) { }
+        __rw_spin_lock(const __rw_spin_lock&) = delete;
+        __rw_spin_lock& operator=(const __rw_spin_lock&) = delete;
+
+        void lock_shared() {
+            unsigned int spins = 0;
+            for ( ; ; ) {
+                if (!(state.fetch_add(READER, std::memory_order_acquire) & (WRITER | PENDING))) {
+                    return;
+                }
+                // 有写者, 退回计数, 等写者结束再试
+                state.fetch_sub(READER, std::memory_order_relaxed);
+                while (state.load(std::memory_order_relaxed) & (WRITER | PENDING)) {
+                    __spin_pause(spins);
+                }
+            }
+        }
+        void unlock_shared() {
+            state.fetch_sub(READER, std::memory_order_release);
+        }
+
+        void lock() {
+            unsigned int spins = 0;
+            for ( ; ; ) {
+                unsigned int s = state.load(std::memory_order_relaxed);
+                if ((s & ~(unsigned int) PENDING) == 0) {
+                    // 没有读者也没有写者; 取得锁的同时清除等待标记, 其他等待的写者会重新设置
+                    if (state.compare_exchange_weak(s, WRITER, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        return;
+                    }
+                    continue;
+                }
+                if (!(s & PENDING)) {
+                    state.fetch_or(PENDING, std::memory_order_relaxed);
+                }
+                __spin_pause(spins);
+            }
+        }
+        void unlock() {
+            state.fetch_and(~(unsigned int) WRITER, std::memory_order_release);
+        }
+    };
+
+    // 作用域内持有锁
+    template <class Lock>
+    class __lock_guard {
+    private:
+        Lock& l;
+    public:
+        explicit __lock_guard(Lock& x) : l(x) { l.lock(); }
+        ~__lock_guard() { l.unlock(); }
+        __lock_guard(const __lock_guard&) = delete;
+        __lock_guard& operator=(const __lock_guard&) = delete;
+    };
+    template <class Lock>
+    class __shared_lock_guard {
+    private:
+        Lock& l;
+    public:
+        explicit __shared_lock_guard(Lock& x) : l(x) { l.lock_shared(); }
+        ~__shared_lock_guard() { l.unlock_shared(); }
+        __shared_lock_guard(const __shared_lock_guard&) = delete;
+        __shared_lock_guard& operator=(const __shared_lock_guard&) = delete;
+    };
+
+}
+
+#endif
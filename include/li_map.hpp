@@ -2,15 +2,20 @@
 #define LI_MAP_H_
 
 #include "li_rbtree.hpp"
+#include "li_frozen_map.hpp"
 #include "li_pair.h"
 #include "li_functional.h"
 #include "li_alloc.h"
 
 
-// map 的实现
+// map 与 multimap 的实现
 namespace LI {
+    template <class Key, class T, class Compare, class Alloc>
+    class multimap;
+
     template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
     class map {
+        template <class, class, class, class> friend class multimap; // merge 时要访问对方的红黑树
     public:
         typedef Key key_type; // 键值型别
         typedef T data_type; // 数据型别
@@ -44,35 +49,368 @@ namespace LI {
         typedef typename rep_type::const_iterator const_iterator; 
         typedef typename rep_type::size_type size_type;
         typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::node_type node_type; // 节点把手
+        typedef typename rep_type::insert_return_type insert_return_type;
+
+        map() : t(Compare()) { }
+        // 以区间构造, 已排序的输入每次插入均摊 O(1)
+        template <class InputIterator>
+        map(InputIterator first, InputIterator last) : t(Compare()) {
+            t.insert_unique(first, last);
+        }
+        // 调用者保证区间按键值严格递增, 直接建立平衡树, O(n)
+        template <class ForwardIterator>
+        map(ForwardIterator first, ForwardIterator last, sorted_unique_tag) : t(Compare()) {
+            t.build_from_sorted(first, last);
+        }
 
-        map() : t(Compare()) { } // 只定义默认构造函数, 其他就不定义了
+        map(const map<Key, T, Compare, Alloc>& x) : t(x.t) { } // O(n) 的结构复制
+        map(map<Key, T, Compare, Alloc>&& x) : t(LI::move(x.t)) { } // O(1)
 
         ~map() { }
 
+        map<Key, T, Compare, Alloc>& operator=(const map<Key, T, Compare, Alloc>& x) {
+            t = x.t;
+            return *this;
+        }
+        map<Key, T, Compare, Alloc>& operator=(map<Key, T, Compare, Alloc>&& x) {
+            t = LI::move(x.t);
+            return *this;
+        }
+        void swap(map<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+
         key_compare key_comp() const { return t.key_comp(); }
         value_compare value_comp() const { return value_compare(t.key_comp()); } // 也是以 key_comp 返回
         iterator begin() { return t.begin(); }
         iterator end() { return t.end(); }
+        const_iterator begin() const { return t.begin(); }
+        const_iterator end() const { return t.end(); }
         bool empty() const { return t.empty(); }
         size_type size() const { return t.size(); }
         size_type max_size() const { return t.max_size(); }
+        // 只下降一次; 键值不存在时才在节点中原地构造 T(), 已存在时不构造任何对象
         T& operator[] (const key_type& k) {
-            return (*((insert(value_type(k, T()))).first)).second;
+            return (*try_emplace(k).first).second;
+        }
+        T& operator[] (key_type&& k) {
+            return (*try_emplace(LI::move(k)).first).second;
+        }
+
+        // 原地构造 ---------------------------------------------
+        // 以 args 在节点中直接构造 value_type, 键值重复时构造的节点会被释放
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return t.emplace_unique(LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            return t.emplace_hint_unique(position, LI::forward<Args>(args)...);
+        }
+        // 键值不存在时才构造: first 由 k 构造, second 由 args 构造; 已存在时什么都不做, args 也不会被移动
+        template <class... Args>
+        pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+            return t.try_emplace_unique(k, __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+            return t.try_emplace_unique(k, __piecewise_construct_t(), LI::move(k), LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator try_emplace(iterator position, const key_type& k, Args&&... args) {
+            return t.try_emplace_hint_unique(position, k, __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator try_emplace(iterator position, key_type&& k, Args&&... args) {
+            return t.try_emplace_hint_unique(position, k, __piecewise_construct_t(), LI::move(k), LI::forward<Args>(args)...);
+        }
+        // 键值不存在时插入, 存在时赋值; 返回值的 second 表示是否插入
+        template <class M>
+        pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(k, LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj); // 未插入时 obj 没有被用过
+            }
+            return r;
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(LI::move(k), LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        // 带提示的版本, 以元素个数是否变化判断是否插入
+        template <class M>
+        iterator insert_or_assign(iterator position, const key_type& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, k, LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
+        }
+        template <class M>
+        iterator insert_or_assign(iterator position, key_type&& k, M&& obj) {
+            size_type n = size();
+            iterator i = try_emplace(position, LI::move(k), LI::forward<M>(obj));
+            if (size() == n) {
+                (*i).second = LI::forward<M>(obj);
+            }
+            return i;
         }
 
         // 注意 insert 的返回类型
         pair<iterator, bool> insert(const value_type& x) {
             return t.insert_unique(x);
         }
+        // 带提示的插入, 返回新节点 或 已存在的同键值节点
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_unique(position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            t.insert_unique(first, last);
+        }
+        // 以节点把手插入, 不申请内存也不复制元素
+        insert_return_type insert(node_type&& nh) {
+            return t.insert_unique(LI::move(nh));
+        }
+        iterator insert(iterator position, node_type&& nh) {
+            return t.insert_unique(position, LI::move(nh));
+        }
+        // 摘下节点而不释放, 可以再插入到另一个 map 中
+        node_type extract(iterator position) { return t.extract(position); }
+        node_type extract(const key_type& k) { return t.extract(k); }
+        // 把 source 中键值在本 map 里还不存在的元素搬过来, 其余的留在 source 中
+        void merge(map<Key, T, Compare, Alloc>& source) { t.merge_unique(source.t); }
+        void merge(map<Key, T, Compare, Alloc>&& source) { t.merge_unique(source.t); }
+        void merge(multimap<Key, T, Compare, Alloc>& source) { t.merge_unique(source.t); }
+        void merge(multimap<Key, T, Compare, Alloc>&& source) { t.merge_unique(source.t); }
         void erase(iterator position) { t.erase(position); }
-        void erase(const key_type& k) { t.erase(k); }
+        size_type erase(const key_type& k) { return t.erase(k); }
+        void erase(iterator first, iterator last) { t.erase(first, last); }
         void clear() { t.clear(); }
         iterator find(const key_type& x) { return t.find(x); }
+        const_iterator find(const key_type& x) const { return t.find(x); }
+        // 批量查找 result[i] = find(keys[i]), 多条树下降交替进行以重叠缓存未命中
+        void find_batch(const key_type* keys, size_type n, iterator* result) { t.find_batch(keys, n, result); }
+        void find_batch(const key_type* keys, size_type n, const_iterator* result) const { t.find_batch(keys, n, result); }
+        // 先排序键值再批量查找, 适合键值很多的情况
+        void find_batch_sorted(const key_type* keys, size_type n, iterator* result) { t.find_batch_sorted(keys, n, result); }
+        void find_batch_sorted(const key_type* keys, size_type n, const_iterator* result) const { t.find_batch_sorted(keys, n, result); }
+
+        // 区间查找
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+        const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        // 异构查找: Compare 带有 is_transparent (如 less<void>) 时接受任何能与 Key 比较的型别
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& x) { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type find(const K& x) const { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& x) const { return t.count(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& x) { return t.erase(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& x) { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type lower_bound(const K& x) const { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& x) { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type upper_bound(const K& x) const { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& x) { return t.equal_range(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<const_iterator, const_iterator> >::type equal_range(const K& x) const { return t.equal_range(x); }
+
+        // 生成只读快照, 查找时不再追指针; 之后对 map 的修改不影响已生成的快照, O(n)
+        frozen_map<Key, T, Compare, Alloc> freeze() const {
+            return frozen_map<Key, T, Compare, Alloc>(begin(), end(), sorted_unique_tag(), key_comp());
+        }
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        // 顺序统计, 需要在包含头文件之前定义 LI_RB_TREE_ORDER_STATISTIC
+        size_type rank(const key_type& x) const { return t.rank(x); } // 键值小于 x 的元素个数
+        iterator select(size_type k) { return t.select(k); } // 第 k 小的元素 (从 0 开始)
+        const_iterator select(size_type k) const { return t.select(k); }
+#endif
     };
 
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(map<Key, T, Compare, Alloc>& x, map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+
+    // multimap: 与 map 的区别是插入时调用 insert_equal, 允许键值重复, 因此没有 operator[]
+    template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+    class multimap {
+        template <class, class, class, class> friend class map;
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+
+        class value_compare : public binary_function<value_type, value_type, bool> {
+        public:
+            friend class multimap<Key, T, Compare, Alloc>;
+            bool operator()(const value_type& x, const value_type& y) const {
+                return comp(x.first, y.first);
+            }
+        protected:
+            Compare comp;
+            value_compare(Compare c) : comp(c) { }
+        };
+
+    private:
+        typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+        rep_type t;
+
+    public:
+        typedef typename rep_type::pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        typedef typename rep_type::iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::node_type node_type;
+
+        multimap() : t(Compare()) { }
+        explicit multimap(const Compare& comp) : t(comp) { }
+        template <class InputIterator>
+        multimap(InputIterator first, InputIterator last) : t(Compare()) {
+            t.insert_equal(first, last);
+        }
+        // 调用者保证区间已按键值排序 (允许相等), O(n)
+        template <class ForwardIterator>
+        multimap(ForwardIterator first, ForwardIterator last, sorted_equivalent_t) : t(Compare()) {
+            t.build_from_sorted(first, last);
+        }
 
+        multimap(const multimap<Key, T, Compare, Alloc>& x) : t(x.t) { }
+        multimap(multimap<Key, T, Compare, Alloc>&& x) : t(LI::move(x.t)) { }
 
+        ~multimap() { }
+
+        multimap<Key, T, Compare, Alloc>& operator=(const multimap<Key, T, Compare, Alloc>& x) {
+            t = x.t;
+            return *this;
+        }
+        multimap<Key, T, Compare, Alloc>& operator=(multimap<Key, T, Compare, Alloc>&& x) {
+            t = LI::move(x.t);
+            return *this;
+        }
+        void swap(multimap<Key, T, Compare, Alloc>& x) { t.swap(x.t); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return value_compare(t.key_comp()); }
+        iterator begin() { return t.begin(); }
+        iterator end() { return t.end(); }
+        const_iterator begin() const { return t.begin(); }
+        const_iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+
+        // 插入总是成功, 相等的键值排在已有元素之后
+        iterator insert(const value_type& x) {
+            return t.insert_equal(x);
+        }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_equal(position, x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            t.insert_equal(first, last);
+        }
+        template <class... Args>
+        iterator emplace(Args&&... args) {
+            return t.emplace_equal(LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            return t.emplace_hint_equal(position, LI::forward<Args>(args)...);
+        }
+        iterator insert(node_type&& nh) {
+            return t.insert_equal(LI::move(nh));
+        }
+        iterator insert(iterator position, node_type&& nh) {
+            return t.insert_equal(position, LI::move(nh));
+        }
+
+        node_type extract(iterator position) { return t.extract(position); }
+        node_type extract(const key_type& k) { return t.extract(k); } // 只摘下第一个键值等于 k 的元素
+        // source 中的元素全部搬过来
+        void merge(multimap<Key, T, Compare, Alloc>& source) { t.merge_equal(source.t); }
+        void merge(multimap<Key, T, Compare, Alloc>&& source) { t.merge_equal(source.t); }
+        void merge(map<Key, T, Compare, Alloc>& source) { t.merge_equal(source.t); }
+        void merge(map<Key, T, Compare, Alloc>&& source) { t.merge_equal(source.t); }
+        void erase(iterator position) { t.erase(position); }
+        size_type erase(const key_type& k) { return t.erase(k); } // 删除所有键值等于 k 的元素
+        void erase(iterator first, iterator last) { t.erase(first, last); }
+        void clear() { t.clear(); }
+        iterator find(const key_type& x) { return t.find(x); }
+        const_iterator find(const key_type& x) const { return t.find(x); }
+        // 批量查找 result[i] = find(keys[i]), 多条树下降交替进行以重叠缓存未命中
+        void find_batch(const key_type* keys, size_type n, iterator* result) { t.find_batch(keys, n, result); }
+        void find_batch(const key_type* keys, size_type n, const_iterator* result) const { t.find_batch(keys, n, result); }
+        // 先排序键值再批量查找, 适合键值很多的情况
+        void find_batch_sorted(const key_type* keys, size_type n, iterator* result) { t.find_batch_sorted(keys, n, result); }
+        void find_batch_sorted(const key_type* keys, size_type n, const_iterator* result) const { t.find_batch_sorted(keys, n, result); }
+
+        // 区间查找
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+        const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+        const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& x) { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type find(const K& x) const { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& x) const { return t.count(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& x) { return t.erase(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& x) { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type lower_bound(const K& x) const { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& x) { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type upper_bound(const K& x) const { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& x) { return t.equal_range(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<const_iterator, const_iterator> >::type equal_range(const K& x) const { return t.equal_range(x); }
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        size_type rank(const key_type& x) const { return t.rank(x); }
+        iterator select(size_type k) { return t.select(k); }
+        const_iterator select(size_type k) const { return t.select(k); }
+#endif
+    };
 
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(multimap<Key, T, Compare, Alloc>& x, multimap<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
 
 }
 
@@ -1,9 +1,16 @@
 #ifndef LI_PAIR_H_
 #define LI_PAIR_H_
 
+#include "li_type_traits.h"
+#include "li_utility.h"
+
 // pair 的实现
 namespace LI {
 
+    // 分段构造的标记: 第一个参数构造 first, 其余参数全部交给 second 的构造函数
+    // second 原地构造, 不经过临时对象 (map 的 try_emplace / operator[] 使用)
+    struct __piecewise_construct_t { };
+
     template <class T1, class T2>
     struct pair {
         typedef T1 first_type;
@@ -17,6 +24,15 @@ namespace LI {
         pair(const pair<const T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<const T1, T2>& p): first(p.first), second(p.second) { }
+        // 完美转发, 右值参数直接移动进成员
+        template <class U1, class U2>
+        pair(U1&& a, U2&& b): first(LI::forward<U1>(a)), second(LI::forward<U2>(b)) { }
+        template <class U1, class... Args>
+        pair(__piecewise_construct_t, U1&& a, Args&&... args): first(LI::forward<U1>(a)), second(LI::forward<Args>(args)...) { }
+        // 移动构造 (连同赋值一起声明), 容器搬动元素时不必复制
+        pair(pair&& p) = default;
+        pair& operator=(const pair& p) = default;
+        pair& operator=(pair&& p) = default;
         
     };
 
@@ -33,6 +49,15 @@ namespace LI {
         pair(const pair<const T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<const T1, T2>& p): first(p.first), second(p.second) { }
+        // 完美转发, 右值参数直接移动进成员
+        template <class U1, class U2>
+        pair(U1&& a, U2&& b): first(LI::forward<U1>(a)), second(LI::forward<U2>(b)) { }
+        template <class U1, class... Args>
+        pair(__piecewise_construct_t, U1&& a, Args&&... args): first(LI::forward<U1>(a)), second(LI::forward<Args>(args)...) { }
+        // 移动构造 (连同赋值一起声明), 容器搬动元素时不必复制
+        pair(pair&& p) = default;
+        pair& operator=(const pair& p) = default;
+        pair& operator=(pair&& p) = default;
         
     };
 
@@ -49,6 +74,15 @@ namespace LI {
         pair(const pair<const T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<const T1, T2>& p): first(p.first), second(p.second) { }
+        // 完美转发, 右值参数直接移动进成员
+        template <class U1, class U2>
+        pair(U1&& a, U2&& b): first(LI::forward<U1>(a)), second(LI::forward<U2>(b)) { }
+        template <class U1, class... Args>
+        pair(__piecewise_construct_t, U1&& a, Args&&... args): first(LI::forward<U1>(a)), second(LI::forward<Args>(args)...) { }
+        // 移动构造 (连同赋值一起声明), 容器搬动元素时不必复制
+        pair(pair&& p) = default;
+        pair& operator=(const pair& p) = default;
+        pair& operator=(pair&& p) = default;
         
     };
 
@@ -65,10 +99,31 @@ namespace LI {
         pair(const pair<const T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<T1, const T2>& p): first(p.first), second(p.second) { }
         pair(const pair<const T1, T2>& p): first(p.first), second(p.second) { }
+        // 完美转发, 右值参数直接移动进成员
+        template <class U1, class U2>
+        pair(U1&& a, U2&& b): first(LI::forward<U1>(a)), second(LI::forward<U2>(b)) { }
+        template <class U1, class... Args>
+        pair(__piecewise_construct_t, U1&& a, Args&&... args): first(LI::forward<U1>(a)), second(LI::forward<Args>(args)...) { }
+        // 移动构造 (连同赋值一起声明), 容器搬动元素时不必复制
+        pair(pair&& p) = default;
+        pair& operator=(const pair& p) = default;
+        pair& operator=(pair&& p) = default;
         
     };
 
 
+    // pair 自己定义了构造函数, 只有析构是否平凡取决于两个成员
+    // 容器 (如 map 的节点) 据此可以跳过逐个析构
+    template <class T1, class T2>
+    struct __type_traits<pair<T1, T2> > {
+        typedef __false_type   has_trivial_default_constructor;
+        typedef __false_type   has_trivial_copy_constructor;
+        typedef __false_type   has_trivial_assignment_operator;
+        typedef typename __and_type<typename __type_traits<T1>::has_trivial_destructor,
+                                    typename __type_traits<T2>::has_trivial_destructor>::type has_trivial_destructor;
+        typedef __false_type   is_POD_type;
+    };
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,417 @@
+#ifndef LI_PERSISTENT_MAP_H_
+#define LI_PERSISTENT_MAP_H_
+
+#include <atomic>
+#include <stddef.h>
+#include "li_thread_alloc.h"
+#include "li_construct.h"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_iterator.h"
+#include "li_lock.h"
+#include "li_utility.h"
+
+
+// persistent_map: 持久化 (不可变) 的有序 map, 每个版本一经建立就不再改变
+// insert / insert_or_assign / erase 不修改原来的版本, 而是返回一个新版本:
+// 只复制从根到被修改节点的一条路径 (O(log n) 个节点), 其余子树由新旧版本共用
+// 复制一个版本只是增加根节点的引用计数, O(1); 节点以原子的引用计数管理, 最后一个引用它的版本释放时回收
+// 以红黑树实现, 插入与删除采用 Kahrs 的函数式写法 (不需要父节点指针, 所以子树可以共用)
+// 不同线程可以同时读取和释放同一版本; 一个线程更新时其他线程仍读取自己持有的旧版本, 互不影响
+// 迭代器只在它所属的版本 (或共用这些节点的版本) 存活时有效
+// 节点默认由 thread_alloc 配置, 读者线程释放旧版本时不需要与写者争用同一把锁
+namespace LI {
+
+    // 持有一个引用的节点指针, 复制时加一, 析构时减一
+    template <class Node>
+    class __counted_link {
+    private:
+        Node* p;
+
+    public:
+        __counted_link() : p(0) { }
+        explicit __counted_link(Node* x) : p(x) { } // 接管 x 已有的一个引用
+        __counted_link(const __counted_link& x) : p(x.p) {
+            if (p != 0) p->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        __counted_link(__counted_link&& x) : p(x.p) { x.p = 0; }
+        ~__counted_link() { Node::release(p); }
+        __counted_link& operator=(__counted_link x) {
+            Node* tmp = p;
+            p = x.p;
+            x.p = tmp;
+            return *this;
+        }
+
+        Node* get() const { return p; }
+        Node* operator->() const { return p; }
+        // 交出持有的引用
+        Node* detach() {
+            Node* tmp = p;
+            p = 0;
+            return tmp;
+        }
+        explicit operator bool() const { return p != 0; }
+    };
+
+    template <class Value, class Alloc>
+    struct __persistent_rb_node {
+        typedef __counted_link<__persistent_rb_node> link_type;
+
+        std::atomic<size_t> refs;
+        bool red;
+        link_type left;
+        link_type right;
+        Value value;
+
+        // 新节点的引用计数为 1, 接管 l 和 r; 元素构造失败时 l 和 r 仍由调用者释放
+        static __persistent_rb_node* create(bool red, link_type&& l, const Value& v, link_type&& r) {
+            __persistent_rb_node* x = (__persistent_rb_node*) Alloc::allocate(sizeof(__persistent_rb_node));
+            try {
+                construct(&x->value, v);
+            }
+            catch(...) {
+                Alloc::deallocate(x, sizeof(__persistent_rb_node));
+                throw;
+            }
+            new (&x->refs) std::atomic<size_t>(1);
+            x->red = red;
+            new (&x->left) link_type(LI::move(l));
+            new (&x->right) link_type(LI::move(r));
+            return x;
+        }
+        // 减少一个引用, 最后一个引用释放时析构节点并释放子树 (递归深度不超过树高)
+        static void release(__persistent_rb_node* x) {
+            while (x != 0 && x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                __persistent_rb_node* r = x->right.detach(); // 右子树留给循环释放, 递归只沿左子树
+                destroy(&x->value);
+                x->left.~link_type();
+                x->right.~link_type();
+                Alloc::deallocate(x, sizeof(__persistent_rb_node));
+                x = r;
+            }
+        }
+    };
+
+    // 中序遍历的只读迭代器: 没有父节点指针, 以栈记录尚未访问的祖先
+    // 红黑树高度不超过 2 log2(n + 1), 64 层足够 2^32 - 1 个元素
+    template <class Value, class Alloc>
+    struct __persistent_map_iterator {
+        typedef forward_iterator_tag iterator_category; // 只支持 ++, 可以多次遍历
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Value* pointer;
+        typedef const Value& reference;
+        typedef __persistent_rb_node<Value, Alloc> node;
+        typedef __persistent_map_iterator<Value, Alloc> self;
+
+        enum { MAX_DEPTH = 64 };
+
+        node* stack[MAX_DEPTH]; // 栈顶是当前节点, 其下是之后要访问的祖先
+        int depth;
+
+        __persistent_map_iterator() : depth(0) { }
+
+        // 压入 x 及其左侧链
+        void push_left(node* x) {
+            for ( ; x != 0; x = x->left.get()) {
+                stack[depth++] = x;
+            }
+        }
+        node* current() const { return depth == 0 ? 0 : stack[depth - 1]; }
+
+        reference operator*() const { return stack[depth - 1]->value; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            node* x = stack[--depth];
+            push_left(x->right.get());
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const self& x) const { return current() == x.current(); }
+        bool operator!=(const self& x) const { return current() != x.current(); }
+    };
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = thread_alloc>
+    class persistent_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef const value_type& const_reference;
+        typedef __persistent_map_iterator<value_type, Alloc> const_iterator;
+        typedef const_iterator iterator; // 元素不可修改
+
+    private:
+        typedef __persistent_rb_node<value_type, Alloc> node;
+        typedef typename node::link_type link;
+
+        link root;
+        size_type node_count;
+        Compare comp;
+
+        persistent_map(link r, size_type n, const Compare& c) : root(LI::move(r)), node_count(n), comp(c) { }
+
+        static const Key& key(const link& x) { return x->value.first; }
+        static bool is_red(const link& x) { return x && x->red; }
+        static bool is_black(const link& x) { return x && !x->red; }
+        static link make(bool red, link l, const value_type& v, link r) {
+            return link(node::create(red, LI::move(l), v, LI::move(r)));
+        }
+        static link red_node(link l, const value_type& v, link r) { return make(true, LI::move(l), v, LI::move(r)); }
+        static link black_node(link l, const value_type& v, link r) { return make(false, LI::move(l), v, LI::move(r)); }
+
+        // 黑节点 a x b 的一侧出现两个相连的红节点时旋转并重新着色, 否则就是黑节点 a x b
+        static link balance(link a, const value_type& x, link b) {
+            if (is_red(a) && is_red(b)) {
+                return red_node(black_node(a->left, a->value, a->right), x, black_node(b->left, b->value, b->right));
+            }
+            if (is_red(a) && is_red(a->left)) {
+                return red_node(black_node(a->left->left, a->left->value, a->left->right), a->value,
+                                black_node(a->right, x, LI::move(b)));
+            }
+            if (is_red(a) && is_red(a->right)) {
+                return red_node(black_node(a->left, a->value, a->right->left), a->right->value,
+                                black_node(a->right->right, x, LI::move(b)));
+            }
+            if (is_red(b) && is_red(b->right)) {
+                return red_node(black_node(LI::move(a), x, b->left), b->value,
+                                black_node(b->right->left, b->right->value, b->right->right));
+            }
+            if (is_red(b) && is_red(b->left)) {
+                return red_node(black_node(LI::move(a), x, b->left->left), b->left->value,
+                                black_node(b->left->right, b->value, b->right));
+            }
+            return black_node(LI::move(a), x, LI::move(b));
+        }
+        // 黑节点改为红节点, 黑高度减一
+        static link sub1(const link& t) { return red_node(t->left, t->value, t->right); }
+        // 左子树 l 的黑高度比右子树 r 少一
+        static link balance_left(link l, const value_type& x, link r) {
+            if (is_red(l)) {
+                return red_node(black_node(l->left, l->value, l->right), x, LI::move(r));
+            }
+            if (is_black(r)) {
+                return balance(LI::move(l), x, red_node(r->left, r->value, r->right));
+            }
+            // r 为红, 其左子节点为黑
+            return red_node(black_node(LI::move(l), x, r->left->left), r->left->value,
+                            balance(r->left->right, r->value, sub1(r->right)));
+        }
+        // 右子树 r 的黑高度比左子树 l 少一
+        static link balance_right(link l, const value_type& x, link r) {
+            if (is_red(r)) {
+                return red_node(LI::move(l), x, black_node(r->left, r->value, r->right));
+            }
+            if (is_black(l)) {
+                return balance(red_node(l->left, l->value, l->right), x, LI::move(r));
+            }
+            // l 为红, 其右子节点为黑
+            return red_node(balance(sub1(l->left), l->value, l->right->left), l->right->value,
+                            black_node(l->right->right, x, LI::move(r)));
+        }
+        // 合并删除节点后留下的两棵子树, a 的元素都小于 b
+        static link append(const link& a, const link& b) {
+            if (!a) return b;
+            if (!b) return a;
+            if (is_red(a) && is_red(b)) {
+                link bc = append(a->right, b->left);
+                if (is_red(bc)) {
+                    return red_node(red_node(a->left, a->value, bc->left), bc->value, red_node(bc->right, b->value, b->right));
+                }
+                return red_node(a->left, a->value, red_node(LI::move(bc), b->value, b->right));
+            }
+            if (!is_red(a) && !is_red(b)) {
+                link bc = append(a->right, b->left);
+                if (is_red(bc)) {
+                    return red_node(black_node(a->left, a->value, bc->left), bc->value, black_node(bc->right, b->value, b->right));
+                }
+                return balance_left(a->left, a->value, black_node(LI::move(bc), b->value, b->right));
+            }
+            if (is_red(b)) {
+                return red_node(append(a, b->left), b->value, b->right);
+            }
+            return red_node(a->left, a->value, append(a->right, b));
+        }
+
+        // 插入 v 之后的子树 (根可能为红, 可能有两个相连的红节点, 由上一层的 balance 处理); 未改变时返回 t 本身
+        link __insert(const link& t, const value_type& v, bool assign, bool& inserted) const {
+            if (!t) {
+                inserted = true;
+                return red_node(link(), v, link());
+            }
+            if (comp(v.first, key(t))) {
+                link l = __insert(t->left, v, assign, inserted);
+                if (l.get() == t->left.get()) return t;
+                return t->red ? red_node(LI::move(l), t->value, t->right) : balance(LI::move(l), t->value, t->right);
+            }
+            if (comp(key(t), v.first)) {
+                link r = __insert(t->right, v, assign, inserted);
+                if (r.get() == t->right.get()) return t;
+                return t->red ? red_node(t->left, t->value, LI::move(r)) : balance(t->left, t->value, LI::move(r));
+            }
+            if (!assign) return t;
+            return make(t->red, t->left, v, t->right); // 替换元素, 颜色不变
+        }
+        // 删除键值 k 之后的子树; 不存在时返回 t 本身
+        link __erase(const link& t, const key_type& k, bool& erased) const {
+            if (!t) return t;
+            if (comp(k, key(t))) {
+                link l = __erase(t->left, k, erased);
+                if (!erased) return t;
+                return is_black(t->left) ? balance_left(LI::move(l), t->value, t->right)
+                                         : red_node(LI::move(l), t->value, t->right);
+            }
+            if (comp(key(t), k)) {
+                link r = __erase(t->right, k, erased);
+                if (!erased) return t;
+                return is_black(t->right) ? balance_right(t->left, t->value, LI::move(r))
+                                          : red_node(t->left, t->value, LI::move(r));
+            }
+            erased = true;
+            return append(t->left, t->right);
+        }
+        // 根节点总是黑色
+        static link blacken(link t) {
+            if (is_red(t)) return black_node(t->left, t->value, t->right);
+            return t;
+        }
+
+        // 第一个不小于 k (upper 时大于 k) 的元素
+        const_iterator __bound(const key_type& k, bool upper) const {
+            const_iterator it;
+            for (node* x = root.get(); x != 0; ) {
+                if (upper ? comp(k, x->value.first) : !comp(x->value.first, k)) {
+                    it.stack[it.depth++] = x;
+                    x = x->left.get();
+                }
+                else {
+                    x = x->right.get();
+                }
+            }
+            return it;
+        }
+
+    public:
+        explicit persistent_map(const Compare& c = Compare()) : node_count(0), comp(c) { }
+        template <class InputIterator>
+        persistent_map(InputIterator first, InputIterator last, const Compare& c = Compare()) : node_count(0), comp(c) {
+            for ( ; first != last; ++first) {
+                *this = insert(*first);
+            }
+        }
+        // 复制只共用根节点, O(1)
+        persistent_map(const persistent_map& x) : root(x.root), node_count(x.node_count), comp(x.comp) { }
+        persistent_map(persistent_map&& x) : root(LI::move(x.root)), node_count(x.node_count), comp(x.comp) {
+            x.node_count = 0;
+        }
+        persistent_map& operator=(persistent_map x) {
+            swap(x);
+            return *this;
+        }
+        ~persistent_map() { }
+
+        key_compare key_comp() const { return comp; }
+        size_type size() const { return node_count; }
+        bool empty() const { return node_count == 0; }
+        size_type max_size() const { return size_type(0xFFFFFFFFu); } // 受迭代器栈深度限制
+        void swap(persistent_map& x) {
+            LI::swap(root, x.root);
+            LI::swap(node_count, x.node_count);
+            LI::swap(comp, x.comp);
+        }
+        // 两个版本是否共用同一棵树 (比元素比较快得多, 可以用来判断版本是否改变)
+        bool same_version(const persistent_map& x) const { return root.get() == x.root.get(); }
+
+        const_iterator begin() const {
+            const_iterator it;
+            it.push_left(root.get());
+            return it;
+        }
+        const_iterator end() const { return const_iterator(); }
+
+        // 以下操作都返回新版本, *this 不变; 没有改变时新版本与 *this 共用同一棵树
+        // 键值已存在时不插入
+        persistent_map insert(const value_type& v) const {
+            bool inserted = false;
+            link t = __insert(root, v, false, inserted);
+            return persistent_map(blacken(LI::move(t)), node_count + (inserted ? 1 : 0), comp);
+        }
+        // 键值已存在时替换实值
+        template <class M>
+        persistent_map insert_or_assign(const key_type& k, M&& obj) const {
+            value_type v(k, LI::forward<M>(obj));
+            bool inserted = false;
+            link t = __insert(root, v, true, inserted);
+            return persistent_map(blacken(LI::move(t)), node_count + (inserted ? 1 : 0), comp);
+        }
+        persistent_map erase(const key_type& k) const {
+            bool erased = false;
+            link t = __erase(root, k, erased);
+            if (!erased) return *this;
+            return persistent_map(blacken(LI::move(t)), node_count - 1, comp);
+        }
+        persistent_map clear() const { return persistent_map(comp); }
+
+        const_iterator find(const key_type& k) const {
+            const_iterator it = lower_bound(k);
+            return (it == end() || comp(k, it->first)) ? end() : it;
+        }
+        size_type count(const key_type& k) const {
+            for (node* x = root.get(); x != 0; ) {
+                if (comp(k, x->value.first)) x = x->left.get();
+                else if (comp(x->value.first, k)) x = x->right.get();
+                else return 1;
+            }
+            return 0;
+        }
+        const_iterator lower_bound(const key_type& k) const { return __bound(k, false); }
+        const_iterator upper_bound(const key_type& k) const { return __bound(k, true); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+    };
+
+    template <class Key, class T, class Compare, class Alloc>
+    inline void swap(persistent_map<Key, T, Compare, Alloc>& x, persistent_map<Key, T, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+    // 发布版本: 写者 store 新版本, 读者 load 得到当时的版本 (O(1)), 之后各自持有, 不再需要同步
+    // 被替换的旧版本在锁外释放, 仍被读者持有的节点要等读者释放
+    template <class Version>
+    class version_cell {
+    private:
+        mutable __spin_lock lock;
+        Version current;
+
+    public:
+        version_cell() { }
+        explicit version_cell(const Version& v) : current(v) { }
+        version_cell(const version_cell&) = delete;
+        version_cell& operator=(const version_cell&) = delete;
+
+        Version load() const {
+            __lock_guard<__spin_lock> guard(lock);
+            return current;
+        }
+        void store(Version v) {
+            {
+                __lock_guard<__spin_lock> guard(lock);
+                current.swap(v);
+            }
+            // v 现在是旧版本, 在这里析构
+        }
+    };
+
+}
+
+#endif
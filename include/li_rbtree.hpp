@@ -5,6 +5,9 @@
 #include "li_alloc.h"
 #include "li_construct.h"
 #include "li_pair.h"
+#include "li_utility.h"
+#include "li_algorithm.h"
+#include <stdint.h>
 
 // 红黑树的设计与实现
 // 红黑树是一个二叉搜索树, 且满足以下规则:
@@ -24,15 +27,56 @@ namespace LI {
 
     // 节点两层设计
     // 第一层 无值的类型
+    // 颜色和父节点只通过 get_/set_ 函数存取, 以便切换为紧凑布局:
+    // 定义 LI_RB_TREE_COMPACT_NODE 时, 颜色存放在父节点指针的最低位
+    // (节点至少按指针大小对齐, 指针的最低位恒为 0), 每个节点省下 8 字节 (64 位平台 32 -> 24)
     struct __rb_tree_node_base {
         typedef __rb_tree_color_type color_type;
         typedef __rb_tree_node_base* base_ptr;
 
+#ifdef LI_RB_TREE_COMPACT_NODE
+        uintptr_t parent_and_color; // 父节点 | 颜色 (红 0 黑 1)
+        base_ptr left; // 左孩子
+        base_ptr right; // 右孩子
+
+        base_ptr get_parent() const {
+            return (base_ptr) (parent_and_color & ~uintptr_t(1));
+        }
+        void set_parent(base_ptr p) {
+            parent_and_color = uintptr_t(p) | (parent_and_color & uintptr_t(1)); // 保留颜色
+        }
+        color_type get_color() const {
+            return color_type(parent_and_color & uintptr_t(1));
+        }
+        void set_color(color_type c) {
+            parent_and_color = (parent_and_color & ~uintptr_t(1)) | uintptr_t(c);
+        }
+#else
         color_type color; // 节点颜色, 非黑即红
         base_ptr parent; // 父节点
         base_ptr left; // 左孩子
         base_ptr right; // 右孩子
 
+        base_ptr get_parent() const { return parent; }
+        void set_parent(base_ptr p) { parent = p; }
+        color_type get_color() const { return color; }
+        void set_color(color_type c) { color = c; }
+#endif
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        // 顺序统计: 以本节点为根的子树的节点个数, 每个节点多 8 字节
+        // 插入, 删除和旋转时维护, 换来 O(log n) 的 rank / select 和迭代器跳跃
+        size_t subtree_size;
+
+        static size_t size_of(base_ptr x) {
+            return x ? x->subtree_size : 0;
+        }
+        // 由左右子树重新计算
+        void update_size() {
+            subtree_size = size_of(left) + size_of(right) + 1;
+        }
+#endif
+
         static base_ptr minimum (base_ptr x) {
             while (x->left != nullptr) x = x->left; // 一直往左走
             return x;
@@ -78,10 +122,10 @@ namespace LI {
             }
         }
         else {
-            base_ptr y = node->parent; // 找到父节点
+            base_ptr y = node->get_parent(); // 找到父节点
             while (node == y->right) { // 继续往上直至是左孩子
                 node = y;
-                y = y->parent;
+                y = y->get_parent();
             }
             // 以下判断排除一种情况
             // 如果能找到左孩子 那么 y 是所求; 如果到达了终点, y 也是所求
@@ -94,7 +138,7 @@ namespace LI {
 
     // 按中序遍历的次序, -- 是找上一个节点
     void __rb_tree_base_iterator::decrement() {
-        if (node->color == __rb_tree_red && node->parent->parent == node) {  // 这个节点是 end 红节点
+        if (node->get_color() == __rb_tree_red && node->get_parent()->get_parent() == node) {  // 这个节点是 end 红节点
             node = node->right;
         }
         else if (node->left != nullptr) {  // 存在左子树
@@ -105,10 +149,10 @@ namespace LI {
             }
         }
         else {
-            base_ptr y = node->parent; // 找到父节点
+            base_ptr y = node->get_parent(); // 找到父节点
             while (node == y->left) { // 继续往上 直至是右孩子
                 node = y;
-                y = y->parent;
+                y = y->get_parent();
             }
             node = y; // 此为所求
             // 即使是特殊情况: node 根节点且是最小值, 即begin()
@@ -116,6 +160,73 @@ namespace LI {
         }
     }
 
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+    // 顺序统计的全局函数 ---------------------------------------------
+
+    // x 在中序中的位置 (从 0 开始), x 为 header 时返回节点总数; 同时求出 header
+    // 往上爬到根: 每次从右侧上来, 就加上父节点和它的左子树
+    inline size_t __rb_tree_rank(__rb_tree_node_base* x, __rb_tree_node_base*& header) {
+        __rb_tree_node_base* p = x->get_parent();
+        if (p == nullptr) { // 空树的 header
+            header = x;
+            return 0;
+        }
+        if (x->get_color() == __rb_tree_red && p->get_parent() == x) { // x 是 header, p 是根
+            header = x;
+            return p->subtree_size;
+        }
+        size_t r = __rb_tree_node_base::size_of(x->left);
+        while (p->get_parent() != x) { // 只有根与 header 互为父节点
+            if (x == p->right) {
+                r += __rb_tree_node_base::size_of(p->left) + 1;
+            }
+            x = p;
+            p = x->get_parent();
+        }
+        header = p;
+        return r;
+    }
+
+    inline size_t __rb_tree_rank(__rb_tree_node_base* x) {
+        __rb_tree_node_base* header;
+        return __rb_tree_rank(x, header);
+    }
+
+    // 以 x 为根的子树中, 中序第 k 个节点 (从 0 开始), 调用者保证 k < size_of(x)
+    inline __rb_tree_node_base* __rb_tree_select(__rb_tree_node_base* x, size_t k) {
+        for (;;) {
+            size_t l = __rb_tree_node_base::size_of(x->left);
+            if (k < l) {
+                x = x->left;
+            }
+            else if (k == l) {
+                return x;
+            }
+            else {
+                k -= l + 1;
+                x = x->right;
+            }
+        }
+    }
+
+    // 从 x 前进 n 步 (n 可为负), 结果必须落在 [begin, end] 中
+    inline __rb_tree_node_base* __rb_tree_advance(__rb_tree_node_base* x, ptrdiff_t n) {
+        if (n == 0) return x;
+        __rb_tree_node_base* header;
+        size_t k = __rb_tree_rank(x, header) + n;
+        __rb_tree_node_base* root = header->get_parent();
+        if (root == nullptr || k == root->subtree_size) {
+            return header; // end
+        }
+        return __rb_tree_select(root, k);
+    }
+
+    // 两个迭代器之间的距离, O(log n)
+    inline ptrdiff_t operator-(const __rb_tree_base_iterator& x, const __rb_tree_base_iterator& y) {
+        return ptrdiff_t(__rb_tree_rank(x.node)) - ptrdiff_t(__rb_tree_rank(y.node));
+    }
+#endif
+
 
     // 正规的迭代器
     template <class Value, class Ref, class Ptr>
@@ -170,6 +281,25 @@ namespace LI {
             return !(*this == x);
         }
 
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        // 借助子树大小, 一次跳跃 n 步只需 O(log n); 迭代器的类型仍然是双向迭代器
+        self& operator+=(difference_type n) {
+            node = __rb_tree_advance(node, n);
+            return *this;
+        }
+        self& operator-=(difference_type n) {
+            node = __rb_tree_advance(node, -n);
+            return *this;
+        }
+        self operator+(difference_type n) const {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self operator-(difference_type n) const {
+            self tmp = *this;
+            return tmp -= n;
+        }
+#endif
     };
 
     // 全局函数
@@ -179,22 +309,26 @@ namespace LI {
         __rb_tree_node_base* y = x->right; // 令 y 为旋转点的右子节点
         x->right = y->left;
         if (y->left != nullptr) {
-            y->left->parent = x; // 记得设置父节点
+            y->left->set_parent(x); // 记得设置父节点
         }
-        y->parent = x->parent;
+        y->set_parent(x->get_parent());
 
         if (x == root) {
             // 如果 x == root, 让 y 完全顶替 x
             root = y;
         }
-        else if (x == x->parent->left) { // 如果 x 是左节点
-            x->parent->left = y;
+        else if (x == x->get_parent()->left) { // 如果 x 是左节点
+            x->get_parent()->left = y;
         }
         else { // x 是右节点
-            x->parent->right = y;
+            x->get_parent()->right = y;
         }
         y->left = x;
-        x->parent = y;
+        x->set_parent(y);
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        y->subtree_size = x->subtree_size; // y 接替 x, 整棵子树的大小不变
+        x->update_size();
+#endif
     }
 
     // 全局函数
@@ -204,22 +338,26 @@ namespace LI {
         __rb_tree_node_base* y = x->left; // 令 y 为旋转点的左节点
         x->left = y->right;
         if (y->right != nullptr) {
-            y->right->parent = x; // 记得设置父节点
+            y->right->set_parent(x); // 记得设置父节点
         }
-        y->parent = x->parent;
+        y->set_parent(x->get_parent());
 
         if (x == root) { // x 为根节点
             root = y; // 令 y 代替 x
         }
-        else if (x == x->parent->right) {  // x 是右节点
-            x->parent->right = y; 
+        else if (x == x->get_parent()->right) {  // x 是右节点
+            x->get_parent()->right = y; 
         }
         else { // x 是左节点
-            x->parent->left = y; 
+            x->get_parent()->left = y; 
         }
 
         y->right = x;
-        x->parent = y;
+        x->set_parent(y);
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        y->subtree_size = x->subtree_size;
+        x->update_size();
+#endif
     }
 
     // 全局函数
@@ -228,53 +366,53 @@ namespace LI {
     // 这是一个自下而上的程序, 沿着路径, 如果遇到 x 的两个子节点都是红色, 就把 x 改为红色, 两子节点改为黑色
     // 可以避免 复杂的情况(父节点和祖父节点都是红色)
     inline void __rb_tree_rebalance(__rb_tree_node_base* x, __rb_tree_node_base*& root) {
-        x->color = __rb_tree_red; // 新节点必须为红
+        x->set_color(__rb_tree_red); // 新节点必须为红
         // 父节点为红
-        while (x != root && x->parent->color == __rb_tree_red) {
-            if (x->parent == x->parent->parent->left) { // 父节点是祖父节点的左节点
-                __rb_tree_node_base* y = x->parent->parent->right; // 令 y 是伯父节点
-                if (y && y->color == __rb_tree_red) { // 伯父节点存在且为红色节点
+        while (x != root && x->get_parent()->get_color() == __rb_tree_red) {
+            if (x->get_parent() == x->get_parent()->get_parent()->left) { // 父节点是祖父节点的左节点
+                __rb_tree_node_base* y = x->get_parent()->get_parent()->right; // 令 y 是伯父节点
+                if (y && y->get_color() == __rb_tree_red) { // 伯父节点存在且为红色节点
                     // 发现两个子节点都是红色
-                    x->parent->color = __rb_tree_black; // 更改父节点为黑色
-                    y->color = __rb_tree_black; // 更改伯父节点为黑色
-                    x->parent->parent->color = __rb_tree_red; // 更改祖父节点为红色
-                    x = x->parent->parent; // 继续往上检查
+                    x->get_parent()->set_color(__rb_tree_black); // 更改父节点为黑色
+                    y->set_color(__rb_tree_black); // 更改伯父节点为黑色
+                    x->get_parent()->get_parent()->set_color(__rb_tree_red); // 更改祖父节点为红色
+                    x = x->get_parent()->get_parent(); // 继续往上检查
                 }
                 else { // 无伯父节点, 或伯父节点为黑色
-                    if (x == x->parent->right) { // 如果新节点为父节点之右子节点
-                        x = x->parent;
+                    if (x == x->get_parent()->right) { // 如果新节点为父节点之右子节点
+                        x = x->get_parent();
                         // 如果是右子节点就先左旋
                         __rb_tree_rotate_left(x, root); // 第一参数为左旋点
                     }
-                    x->parent->color = __rb_tree_black; // 改变颜色
-                    x->parent->parent->color = __rb_tree_red;
+                    x->get_parent()->set_color(__rb_tree_black); // 改变颜色
+                    x->get_parent()->get_parent()->set_color(__rb_tree_red);
                     // 右旋
-                    __rb_tree_rotate_right(x->parent->parent, root); // 第一参数为右旋点
+                    __rb_tree_rotate_right(x->get_parent()->get_parent(), root); // 第一参数为右旋点
                 }
             }
             else { // 父节点是祖父节点的右节点
-                __rb_tree_node_base* y = x->parent->parent->left; // 令 y 是伯父节点
-                if (y && y->color == __rb_tree_red) { // 伯父节点存在且为红色
+                __rb_tree_node_base* y = x->get_parent()->get_parent()->left; // 令 y 是伯父节点
+                if (y && y->get_color() == __rb_tree_red) { // 伯父节点存在且为红色
                     // 发现两个字节点都是红色
-                    x->parent->color = __rb_tree_black; // 更改父节点颜色
-                    y->color = __rb_tree_black; // 更改伯父节点颜色
-                    x->parent->parent->color = __rb_tree_red; // 更改祖父节点的颜色
-                    x = x->parent->parent; // 继续往上检查
+                    x->get_parent()->set_color(__rb_tree_black); // 更改父节点颜色
+                    y->set_color(__rb_tree_black); // 更改伯父节点颜色
+                    x->get_parent()->get_parent()->set_color(__rb_tree_red); // 更改祖父节点的颜色
+                    x = x->get_parent()->get_parent(); // 继续往上检查
                 }
                 else { // 伯父节点不存在 或 伯父节点为黑色
-                    if (x == x->parent->left) { // 如果新节点为父节点的左节点
-                        x = x->parent;
+                    if (x == x->get_parent()->left) { // 如果新节点为父节点的左节点
+                        x = x->get_parent();
                         // 如果是左节点就先右旋
                         __rb_tree_rotate_right(x, root);
                     }
-                    x->parent->color = __rb_tree_black; // 改变颜色
-                    x->parent->parent->color = __rb_tree_red;
+                    x->get_parent()->set_color(__rb_tree_black); // 改变颜色
+                    x->get_parent()->get_parent()->set_color(__rb_tree_red);
                     // 左旋
-                    __rb_tree_rotate_left(x->parent->parent, root); // 第一参数是左旋点
+                    __rb_tree_rotate_left(x->get_parent()->get_parent(), root); // 第一参数是左旋点
                 }
             }
         }
-        root->color = __rb_tree_black; // 根节点永远为黑
+        root->set_color(__rb_tree_black); // 根节点永远为黑
     }
 
     inline __rb_tree_node_base* __rb_tree_rebalance_for_erase(__rb_tree_node_base* z, 
@@ -302,18 +440,26 @@ namespace LI {
             }
         }
 
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        // 真正从树中摘下的位置是 y, 它的祖先直到根的子树大小都减一
+        for (__rb_tree_node_base* p = y; p != root; ) {
+            p = p->get_parent();
+            --p->subtree_size;
+        }
+#endif
+
         if (y != z) { // z 有两个孩子, 用 y 代替 z
-            z->left->parent = y; // y 先连接 左子树
+            z->left->set_parent(y); // y 先连接 左子树
             y->left = z->left;
             if (y != z->right) {  // y 不是 z 的右孩子
-                x_parent = y->parent;
+                x_parent = y->get_parent();
                 if (x) { // 如果 x 不为 null, 先用 x 代替 y 的位置
-                    x->parent = y->parent;
+                    x->set_parent(y->get_parent());
                 }
-                y->parent->left = x; // y 必定是左孩子
+                y->get_parent()->left = x; // y 必定是左孩子
 
                 y->right = z->right; // y 连接右子树
-                z->right->parent = y;
+                z->right->set_parent(y);
             }
             else { // y 刚好是 z 的右孩子
                 x_parent = y;
@@ -322,43 +468,46 @@ namespace LI {
             if (root == z) { // z 是根节点
                 root = y; // 直接用 y 代替 root
             }
-            else if(z->parent->left == z) { // z 是左节点
-                z->parent->left = y;
+            else if(z->get_parent()->left == z) { // z 是左节点
+                z->get_parent()->left = y;
             }
             else { // z 是右节点
-                z->parent->right = y;
+                z->get_parent()->right = y;
             }
-            y->parent = z->parent; // 更新父节点
+            y->set_parent(z->get_parent()); // 更新父节点
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+            y->subtree_size = z->subtree_size; // z 已经在上面减过一
+#endif
 
             // 交换颜色
-            __rb_tree_color_type tmp_color = z->color;
-            z->color = y->color;
-            y->color = tmp_color;
+            __rb_tree_color_type tmp_color = z->get_color();
+            z->set_color(y->get_color());
+            y->set_color(tmp_color);
 
             y = z; // 做好 y 代替 z 的连接操作后, y 重新指向要删除的节点
         }
         else { // z == y, 即 z 至多一个孩子, x 指向 y 有可能存在的孩子
             // 用 x 代替 y(z) 的位置
-            x_parent = y->parent;
+            x_parent = y->get_parent();
             if (x) {
-                x->parent = y->parent; 
+                x->set_parent(y->get_parent()); 
             }
 
             if (root == z) { // z == y == root
                 root = x; // 直接用 x 代替 root
             }
             else {
-                if (z->parent->left == z) {
-                    z->parent->left = x;
+                if (z->get_parent()->left == z) {
+                    z->get_parent()->left = x;
                 }
                 else {
-                    z->parent->right = x;
+                    z->get_parent()->right = x;
                 }
             }
 
             if (leftmost == z) { // 维护最小值
                 if (z->right == nullptr) { // 此时 z 的左节点为 null
-                    leftmost = z->parent;
+                    leftmost = z->get_parent();
                 }
                 else {
                     leftmost = __rb_tree_node_base::minimum(x); // 此时 x 必为 z 的右节点
@@ -366,7 +515,7 @@ namespace LI {
             }
             if (rightmost == z) { // 维护最大值
                 if (z->left == nullptr) { // 此时 z 的右节点为 null
-                    rightmost = z->parent;
+                    rightmost = z->get_parent();
                 }
                 else {
                     rightmost = __rb_tree_node_base::maximum(x); // 此时 x 必为 z 的左节点
@@ -375,38 +524,38 @@ namespace LI {
         }
 
         // y 是要删除的节点, y 的颜色是黑色, 需要调整树形
-        if (y->color != __rb_tree_red) {
-            while (x != root && (x == nullptr || x->color == __rb_tree_black)) { // 双黑
+        if (y->get_color() != __rb_tree_red) {
+            while (x != root && (x == nullptr || x->get_color() == __rb_tree_black)) { // 双黑
                 if (x == x_parent->left) {
                     __rb_tree_node_base* w = x_parent->right; // 兄弟节点, 必定存在, 如果不存在删除前不符合黑高的规则
-                    if (w->color == __rb_tree_red) { // 兄弟节点是红色, 其子节点必然是黑色, x_parent 必然是黑色
-                        w->color = __rb_tree_black; // 更改颜色
-                        x_parent->color = __rb_tree_red;
+                    if (w->get_color() == __rb_tree_red) { // 兄弟节点是红色, 其子节点必然是黑色, x_parent 必然是黑色
+                        w->set_color(__rb_tree_black); // 更改颜色
+                        x_parent->set_color(__rb_tree_red);
                         __rb_tree_rotate_left(x_parent, root); // 左旋转
                         w = x_parent->right; // 待删除节点的兄弟节点(转化为兄弟节点为黑色的情况)
                     }
                     // 以下是兄弟节点为黑色的情况
-                    if ((w->left == nullptr || w->left->color == __rb_tree_black) && 
-                        (w->right == nullptr || w->right->color == __rb_tree_black)) { // 兄弟节点的孩子节点都为黑色
-                        w->color = __rb_tree_red; // 更改兄弟的颜色为红色(这样存在风险, 如果x_parent为红色会双红)
+                    if ((w->left == nullptr || w->left->get_color() == __rb_tree_black) && 
+                        (w->right == nullptr || w->right->get_color() == __rb_tree_black)) { // 兄弟节点的孩子节点都为黑色
+                        w->set_color(__rb_tree_red); // 更改兄弟的颜色为红色(这样存在风险, 如果x_parent为红色会双红)
                         x = x_parent; // 所以继续往上检查
-                        x_parent = x_parent->parent;
+                        x_parent = x_parent->get_parent();
                     }
                     else { // 兄弟节点的孩子节点存在红色
-                        if (w->right == nullptr || w->right->color == __rb_tree_black) { // 兄弟节点的右节点是黑色
+                        if (w->right == nullptr || w->right->get_color() == __rb_tree_black) { // 兄弟节点的右节点是黑色
                             if (w->left) {
-                                w->left->color = __rb_tree_black; // 兄弟节点的左孩子节点 改为黑色
+                                w->left->set_color(__rb_tree_black); // 兄弟节点的左孩子节点 改为黑色
                             }
-                            w->color = __rb_tree_red; // 兄弟节点改为红色
+                            w->set_color(__rb_tree_red); // 兄弟节点改为红色
                             __rb_tree_rotate_right(w, root); // 右旋
                             w = x_parent->right; // 变成兄弟节点的右节点是红色的情况
                         }
                         // 兄弟节点的右节点是红色的情况
                         // 交换兄弟节点和父节点的颜色
-                        w->color = x_parent->color;
-                        x_parent->color = __rb_tree_black; // 兄弟节点必是黑色的
+                        w->set_color(x_parent->get_color());
+                        x_parent->set_color(__rb_tree_black); // 兄弟节点必是黑色的
                         if (w->right) {
-                            w->right->color = __rb_tree_black; // 右孩子从红色变成黑色的
+                            w->right->set_color(__rb_tree_black); // 右孩子从红色变成黑色的
                         }
                         __rb_tree_rotate_left(x_parent, root); // 左旋
                         break; // 完成操作不必再调整了
@@ -414,32 +563,32 @@ namespace LI {
                 }
                 else { // 与上面的类似, 但 x 是右节点
                     __rb_tree_node_base* w = x_parent->left;
-                    if (w->color == __rb_tree_red) {
-                        w->color = __rb_tree_black;
-                        x_parent->color = __rb_tree_red;
+                    if (w->get_color() == __rb_tree_red) {
+                        w->set_color(__rb_tree_black);
+                        x_parent->set_color(__rb_tree_red);
                         __rb_tree_rotate_right(x_parent, root);
                         w = x_parent->left;
                     }
 
-                    if ((w->right == nullptr || w->right->color == __rb_tree_black) &&
-                        (w->left == nullptr || w->left->color == __rb_tree_black)) {
-                        w->color = __rb_tree_red;
+                    if ((w->right == nullptr || w->right->get_color() == __rb_tree_black) &&
+                        (w->left == nullptr || w->left->get_color() == __rb_tree_black)) {
+                        w->set_color(__rb_tree_red);
                         x = x_parent;
-                        x_parent = x_parent->parent;
+                        x_parent = x_parent->get_parent();
                     }
                     else {
-                        if (w->left == nullptr || w->left->color == __rb_tree_black) {
+                        if (w->left == nullptr || w->left->get_color() == __rb_tree_black) {
                             if (w->right) {
-                                w->right->color = __rb_tree_black;
+                                w->right->set_color(__rb_tree_black);
                             }
-                            w->color = __rb_tree_red;
+                            w->set_color(__rb_tree_red);
                             __rb_tree_rotate_left(w, root);
                             w = x_parent->left;
                         }
-                        w->color = x_parent->color;
-                        x_parent->color = __rb_tree_black;
+                        w->set_color(x_parent->get_color());
+                        x_parent->set_color(__rb_tree_black);
                         if (w->left) {
-                            w->left->color = __rb_tree_black;
+                            w->left->set_color(__rb_tree_black);
                         }
                         __rb_tree_rotate_right(x_parent, root);
                         break;
@@ -447,13 +596,118 @@ namespace LI {
                 }
             }
             if (x) {
-                x->color = __rb_tree_black; // 只有不断往上检查那一步跳出循环时遇到红色, 所以要改成黑色
+                x->set_color(__rb_tree_black); // 只有不断往上检查那一步跳出循环时遇到红色, 所以要改成黑色
             }
         }
         return y;
 
     }
 
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    class rb_tree;
+
+    // 比较准则定义了 is_transparent 时才有 type, 否则以 K 为参数的查找函数模板被排除 (SFINAE)
+    // K 不参与推导结果, 只是让判断依赖于函数模板自己的参数
+    template <class Compare, class K, class Result, class = void>
+    struct __rb_tree_transparent { };
+
+    template <class Compare, class K, class Result>
+    struct __rb_tree_transparent<Compare, K, Result, typename __void_type<typename Compare::is_transparent>::type> {
+        typedef Result type;
+    };
+
+    // 批量查找同时推进的路径条数
+    // 一次下降中相邻两层的访问是相互依赖的缓存未命中, 多条路径交替下降才能让未命中重叠
+    const int __rb_tree_batch_width = 16;
+
+    // 批量查找的键值来源: 第 i 次查找的键值及其结果写到 result 的哪个位置
+    template <class Key>
+    struct __rb_tree_batch_keys {
+        const Key* keys;
+        const Key& key(size_t i) const { return keys[i]; }
+        size_t index(size_t i) const { return i; }
+    };
+    // 按排序后的次序查找, order[i] 指向原数组中的键值
+    template <class Key>
+    struct __rb_tree_batch_sorted_keys {
+        const Key* keys;
+        const Key* const* order;
+        const Key& key(size_t i) const { return *order[i]; }
+        size_t index(size_t i) const { return order[i] - keys; }
+    };
+    // 以键值比较准则比较两个键值指针
+    template <class Key, class Compare>
+    struct __rb_tree_key_ptr_compare {
+        Compare comp;
+        __rb_tree_key_ptr_compare(const Compare& c) : comp(c) { }
+        bool operator()(const Key* x, const Key* y) const { return comp(*x, *y); }
+    };
+
+    // 节点把手: 独占一个从树中摘下的节点 (连同其中的元素)
+    // 只能移动不能复制; 析构时若仍持有节点, 才析构元素并释放节点
+    // 节点在两棵树之间转移时不需要重新申请内存, 也不复制元素
+    template <class Value, class Alloc>
+    class __rb_tree_node_handle {
+        template <class, class, class, class, class> friend class rb_tree;
+    public:
+        typedef Value value_type;
+
+    private:
+        typedef __rb_tree_node<Value>* link_type;
+        typedef simple_alloc<__rb_tree_node<Value>, Alloc> node_allocator;
+
+        link_type ptr;
+
+        explicit __rb_tree_node_handle(link_type p) : ptr(p) { }
+        // 交出节点的所有权
+        link_type release() {
+            link_type p = ptr;
+            ptr = nullptr;
+            return p;
+        }
+        void reset() {
+            if (ptr) {
+                destroy(&ptr->value_field);
+                node_allocator::deallocate(ptr);
+                ptr = nullptr;
+            }
+        }
+        __rb_tree_node_handle(const __rb_tree_node_handle&) = delete;
+        __rb_tree_node_handle& operator=(const __rb_tree_node_handle&) = delete;
+
+    public:
+        __rb_tree_node_handle() : ptr(nullptr) { }
+        __rb_tree_node_handle(__rb_tree_node_handle&& x) : ptr(x.ptr) {
+            x.ptr = nullptr;
+        }
+        __rb_tree_node_handle& operator=(__rb_tree_node_handle&& x) {
+            if (this != &x) {
+                reset();
+                ptr = x.release();
+            }
+            return *this;
+        }
+        ~__rb_tree_node_handle() {
+            reset();
+        }
+
+        bool empty() const {
+            return ptr == nullptr;
+        }
+        explicit operator bool() const {
+            return ptr != nullptr;
+        }
+        // 节点中的元素; 对 map 而言可以在重新插入前修改键值
+        value_type& value() const {
+            return ptr->value_field;
+        }
+        void swap(__rb_tree_node_handle& x) {
+            link_type tmp = ptr;
+            ptr = x.ptr;
+            x.ptr = tmp;
+        }
+    };
+
     // 红黑树的实现
     // Value 通常是一个 pair
     template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc>
@@ -484,11 +738,12 @@ namespace LI {
         void put_node(link_type p) {
             rb_tree_node_allocator::deallocate(p); // 释放一个节点空间
         }
-        // 构造一个节点
-        link_type creat_node (const value_type& x) {
+        // 构造一个节点, 参数原样转交给元素的构造函数
+        template <class... Args>
+        link_type creat_node (Args&&... args) {
             link_type tmp = get_node();
             try {
-                construct(&(tmp->value_field), x);
+                construct(&(tmp->value_field), LI::forward<Args>(args)...);
             }
             catch(...) {
                 put_node(tmp);
@@ -499,7 +754,10 @@ namespace LI {
         // 复制一个节点 包括颜色
         link_type clone_node (link_type x) {
             link_type tmp = creat_node(x->value_field);
-            tmp->color = x->color;
+            tmp->set_color(x->get_color());
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+            tmp->subtree_size = x->subtree_size; // 形状相同, 子树大小也相同
+#endif
             tmp->left = nullptr;
             tmp->right = nullptr;
             return tmp;
@@ -510,6 +768,11 @@ namespace LI {
             destroy(&p->value_field); // 析构内容
             put_node(p); // 释放内存
         }
+        // 只析构节点内容, 平凡析构的型别什么都不做
+        void destroy_value(link_type p, __false_type) {
+            destroy(&p->value_field);
+        }
+        void destroy_value(link_type, __true_type) { }
 
     protected:
         // RB_tree 只以 三笔数据表现
@@ -518,8 +781,12 @@ namespace LI {
         Compare key_compare; // 节点间键值的比较准则, 是一个可调用对象
 
         // 以下三个成员方便取得节点 header 的成员
-        link_type& root() const {
-            return (link_type&) header->parent;
+        // 根节点存放在 header 的父节点中, 紧凑布局下不是独立的指针, 因此以 set_root 修改
+        link_type root() const {
+            return (link_type) header->get_parent();
+        }
+        void set_root(link_type x) {
+            header->set_parent(x);
         }
         link_type& leftmost() const {
             return (link_type&) header->left; // 最小值
@@ -535,8 +802,11 @@ namespace LI {
         static link_type& right(link_type x) {
             return (link_type&) (x->right);
         }
-        static link_type& parent(link_type x) {
-            return (link_type&) (x->parent);
+        static link_type parent(link_type x) {
+            return (link_type) (x->get_parent());
+        }
+        static void set_parent(link_type x, base_ptr p) {
+            x->set_parent(p);
         }
         static reference value(link_type x) {
             return x->value_field;
@@ -544,8 +814,11 @@ namespace LI {
         static const Key& key(link_type x) {
             return KeyOfValue()(value(x)); // 如果 value(x) 是 pair, 则返回第一个值
         }
-        static color_type& color(link_type x) {
-            return (color_type&) (x->color);
+        static color_type color(link_type x) {
+            return x->get_color();
+        }
+        static void set_color(link_type x, color_type c) {
+            x->set_color(c);
         }
 
         // 以下六个函数用来方便取得节点 x 的成员
@@ -555,8 +828,8 @@ namespace LI {
         static link_type& right(base_ptr x) {
             return (link_type&) (x->right);
         }
-        static link_type& parent(base_ptr x) {
-            return (link_type&) (x->parent);
+        static link_type parent(base_ptr x) {
+            return (link_type) (x->get_parent());
         }
         static reference value(base_ptr x) {
             return ((link_type)x)->value_field;
@@ -564,8 +837,8 @@ namespace LI {
         static const Key& key(base_ptr x) {
             return KeyOfValue()(value(link_type(x))); // 如果 value(x) 是 pair, 则返回第一个值
         }
-        static color_type& color(base_ptr x) {
-            return (color_type&) (link_type(x)->color);
+        static color_type color(base_ptr x) {
+            return x->get_color();
         }
 
         // 求取极大值和极小值
@@ -579,31 +852,119 @@ namespace LI {
     public:
         typedef __rb_tree_iterator<value_type, reference, pointer> iterator; // 迭代器
         typedef __rb_tree_iterator<value_type, const_reference, const_pointer> const_iterator; // 迭代器
+        typedef __rb_tree_node_handle<value_type, Alloc> node_type; // 节点把手
+        // 以节点把手插入 (不允许重复) 的结果, 插入失败时节点仍在 node 中
+        struct insert_return_type {
+            iterator position;
+            bool inserted;
+            node_type node;
+        };
     private:
+        // 查找插入位置, 返回 (插入点, 父节点); 不允许重复而键值已存在时返回 (已存在的节点, nullptr)
+        link_type __insert_equal_pos(const key_type& k);
+        pair<link_type, link_type> __insert_unique_pos(const key_type& k);
+        pair<link_type, link_type> __insert_unique_hint_pos(iterator position, const key_type& k);
+        pair<link_type, link_type> __insert_equal_hint_pos(iterator position, const key_type& k);
+        pair<link_type, link_type> __insert_equal_lower_pos(const key_type& k);
         iterator __insert(base_ptr x_, base_ptr y_, const value_type& v);
-        // link_type __copy(link_type x, link_type p);
-        // void __erase(link_type x);
+        iterator __insert_node(base_ptr x_, base_ptr y_, link_type z); // 挂上已有的节点
+        iterator __link(bool insert_left, link_type y, link_type z);
+        link_type __unlink(iterator position); // 摘下节点, 不析构不释放
+        // 查找用的树下降, 返回节点指针, 供 iterator 和 const_iterator 版本共用
+        // 以模板参数 K 为键值, 比较准则透明时可以是任何能与 Key 比较的型别
+        template <class K>
+        link_type __find(const K& k) const;
+        template <class KeySource, class ResultIterator>
+        void __find_batch(const KeySource& src, size_type n, ResultIterator* result) const;
+        template <class ResultIterator>
+        void __find_batch_sorted(const key_type* keys, size_type n, ResultIterator* result) const;
+        template <class K>
+        link_type __lower_bound(const K& k) const;
+        template <class K>
+        link_type __upper_bound(const K& k) const;
+        template <class K>
+        pair<link_type, link_type> __equal_range(const K& k) const;
+        template <class K>
+        size_type __count(const K& k) const;
+        template <class K>
+        size_type __erase_key(const K& k);
+        // [first, last) 中的节点个数
+        size_type __distance(link_type first, link_type last) const {
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+            return size_type(const_iterator(last) - const_iterator(first)); // O(log n), 不必逐个走过
+#else
+            return size_type(LI::distance(const_iterator(first), const_iterator(last))); // 限定名字, 避免与 std::distance 的 ADL 冲突
+#endif
+        }
+        link_type __copy(link_type x, link_type p);
+        void __erase(link_type x); // 释放以 x 为根的整棵子树
         // 初始化的函数
         void init() {
             header = get_node(); // 分配空间
-            color(header) = __rb_tree_red; // end 为红色
-            root() = nullptr;
+            set_color(header, __rb_tree_red); // end 为红色
+            set_root(nullptr);
             leftmost() = header;  // header 的左节点初始化为自己
             rightmost() = header;  // header 的右节点初始化为自己
         }
-        void PostOrder(link_type x);
+        template <class ForwardIterator>
+        link_type __build_from_sorted(ForwardIterator& first, size_type n, size_type depth, size_type red_depth);
     public:
         // 默认构造函数
         rb_tree(const Compare& comp = Compare()) : node_count(0), key_compare(comp) {
             init();
         }
 
+        // 拷贝构造函数: 按原树的形状和颜色逐个复制节点, 不做任何比较和旋转, O(n)
+        rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) : node_count(0), key_compare(x.key_compare) {
+            init();
+            if (x.root() != nullptr) {
+                try {
+                    set_root(__copy(x.root(), header));
+                }
+                catch(...) {
+                    put_node(header); // __copy 已经释放了复制到一半的节点
+                    throw;
+                }
+                leftmost() = minimum(root());
+                rightmost() = maximum(root());
+            }
+            node_count = x.node_count;
+        }
+
+        // 移动构造函数: 只交换 header, O(1); x 留下一棵空树
+        rb_tree(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x) : node_count(0), key_compare(x.key_compare) {
+            init();
+            swap(x);
+        }
+
         ~rb_tree() {
             clear();
             put_node(header);
         }
 
-        // rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
+        // 先复制一份再交换, 复制失败时 *this 不受影响
+        rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x) {
+            if (this != &x) {
+                rb_tree<Key, Value, KeyOfValue, Compare, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& operator=(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+
+        // 交换两棵树, 只需交换 header 和 节点数量
+        void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& t) {
+            LI::swap(header, t.header);
+            LI::swap(node_count, t.node_count);
+            LI::swap(key_compare, t.key_compare);
+        }
 
     public:
         Compare key_comp() const {
@@ -615,6 +976,12 @@ namespace LI {
         iterator end() {
             return header; // 会以 header 为参数 构造迭代器
         }
+        const_iterator begin() const {
+            return leftmost();
+        }
+        const_iterator end() const {
+            return header;
+        }
         bool empty() const {
             return node_count == 0;
         }
@@ -625,10 +992,10 @@ namespace LI {
             return size_type(-1); // size_type 是  unsigned 型的, -1 是其正最大值
         }
         void clear() {
-            PostOrder(link_type(header->parent));
+            __erase(root());
             leftmost() = header;
             rightmost() = header;
-            root() = nullptr;
+            set_root(nullptr);
             node_count = 0;
         }
 
@@ -637,72 +1004,512 @@ namespace LI {
         iterator insert_equal(const value_type& v);
         // 将 x 插入 RB-tree (不允许重复)
         pair<iterator, bool> insert_unique(const value_type& v);
+        // 带提示的插入: v 应该紧挨在 position 之前时 O(1) 找到插入点, 否则退回一般的插入
+        iterator insert_unique(iterator position, const value_type& v);
+        iterator insert_equal(iterator position, const value_type& v);
+        // 区间插入, 以 end() 为提示, 已排序的输入每次插入均摊 O(1)
+        template <class InputIterator>
+        void insert_unique(InputIterator first, InputIterator last) {
+            for ( ; first != last; ++first) {
+                insert_unique(end(), *first);
+            }
+        }
+        template <class InputIterator>
+        void insert_equal(InputIterator first, InputIterator last) {
+            for ( ; first != last; ++first) {
+                insert_equal(end(), *first);
+            }
+        }
+
+        // 原地构造 ---------------------------------------------
+        // 先构造节点才能取得键值, 键值重复时再释放节点
+        template <class... Args>
+        pair<iterator, bool> emplace_unique(Args&&... args);
+        template <class... Args>
+        iterator emplace_equal(Args&&... args);
+        template <class... Args>
+        iterator emplace_hint_unique(iterator position, Args&&... args);
+        template <class... Args>
+        iterator emplace_hint_equal(iterator position, Args&&... args);
+        // 先以 k 查找插入位置, 键值不存在时才以 args 构造节点; 命中时不构造任何对象
+        template <class... Args>
+        pair<iterator, bool> try_emplace_unique(const key_type& k, Args&&... args);
+        template <class... Args>
+        iterator try_emplace_hint_unique(iterator position, const key_type& k, Args&&... args);
+
+        // 节点把手 ---------------------------------------------
+        // 摘下节点交给把手, 不释放内存; 键值不存在时返回空把手
+        node_type extract(iterator position) {
+            return node_type(__unlink(position));
+        }
+        node_type extract(const key_type& k);
+        // 把节点接回树中, 空把手什么都不做
+        insert_return_type insert_unique(node_type&& nh);
+        iterator insert_unique(iterator position, node_type&& nh);
+        iterator insert_equal(node_type&& nh);
+        iterator insert_equal(iterator position, node_type&& nh);
+        // 把 src 的节点直接搬到 *this 中, 不申请内存也不复制元素
+        void merge_unique(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& src);
+        void merge_equal(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& src);
+
+        // 以严格递增 (insert_unique 语义) 或 递增 (insert_equal 语义) 的区间重建整棵树, O(n)
+        template <class ForwardIterator>
+        void build_from_sorted(ForwardIterator first, ForwardIterator last);
 
         // 根据键值查找节点
-        iterator find(const key_type& k);
-        // 根据键值删除节点
-        void erase(const key_type& k);
+        iterator find(const key_type& k) {
+            return iterator(__find(k));
+        }
+        const_iterator find(const key_type& k) const {
+            return const_iterator(__find(k));
+        }
+        // 批量查找: result[i] = find(keys[i]), 多条下降路径交替进行
+        void find_batch(const key_type* keys, size_type n, iterator* result) {
+            __rb_tree_batch_keys<key_type> src = { keys };
+            __find_batch(src, n, result);
+        }
+        void find_batch(const key_type* keys, size_type n, const_iterator* result) const {
+            __rb_tree_batch_keys<key_type> src = { keys };
+            __find_batch(src, n, result);
+        }
+        // 先把键值排序再批量查找: 相邻的查找走过的上层节点大多相同, 缓存命中率更高;
+        // 排序需要 O(n log n) 次比较和 n 个指针的临时空间, 适合键值很多且在树中分布分散的情况
+        void find_batch_sorted(const key_type* keys, size_type n, iterator* result) {
+            __find_batch_sorted(keys, n, result);
+        }
+        void find_batch_sorted(const key_type* keys, size_type n, const_iterator* result) const {
+            __find_batch_sorted(keys, n, result);
+        }
+        // 只查找 order 指向的 n 个键值 (都在 keys 数组中), 结果写到 result 中各键值在 keys 里的位置
+        // concurrent_map 把一批键值按分片分组后, 各分片分别调用
+        void find_batch_indirect(const key_type* keys, const key_type* const* order, size_type n, const_iterator* result) const {
+            __rb_tree_batch_sorted_keys<key_type> src = { keys, order };
+            __find_batch(src, n, result);
+        }
+        // 根据键值删除节点, 返回删除的个数
+        size_type erase(const key_type& k) {
+            return __erase_key(k);
+        }
         // 根据迭代器删除节点
         void erase(iterator position);
+        // 删除 [first, last) 中的节点
+        void erase(iterator first, iterator last);
+
+        // 第一个键值不小于 k 的节点
+        iterator lower_bound(const key_type& k) {
+            return iterator(__lower_bound(k));
+        }
+        const_iterator lower_bound(const key_type& k) const {
+            return const_iterator(__lower_bound(k));
+        }
+        // 第一个键值大于 k 的节点
+        iterator upper_bound(const key_type& k) {
+            return iterator(__upper_bound(k));
+        }
+        const_iterator upper_bound(const key_type& k) const {
+            return const_iterator(__upper_bound(k));
+        }
+        // 键值等于 k 的区间 [lower_bound(k), upper_bound(k))
+        pair<iterator, iterator> equal_range(const key_type& k) {
+            pair<link_type, link_type> r = __equal_range(k);
+            return pair<iterator, iterator>(iterator(r.first), iterator(r.second));
+        }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            pair<link_type, link_type> r = __equal_range(k);
+            return pair<const_iterator, const_iterator>(const_iterator(r.first), const_iterator(r.second));
+        }
+        // 键值等于 k 的节点个数
+        size_type count(const key_type& k) const {
+            return __count(k);
+        }
+
+        // 异构查找 ---------------------------------------------
+        // 比较准则带有 is_transparent (如 less<void>) 时, 以下函数接受任何能与 Key 比较的型别,
+        // 不必为了查找先构造一个 Key (如以 const char* 查找 string 键值, 不申请内存)
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& k) {
+            return iterator(__find(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type find(const K& k) const {
+            return const_iterator(__find(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& k) {
+            return __erase_key(k);
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& k) {
+            return iterator(__lower_bound(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type lower_bound(const K& k) const {
+            return const_iterator(__lower_bound(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& k) {
+            return iterator(__upper_bound(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, const_iterator>::type upper_bound(const K& k) const {
+            return const_iterator(__upper_bound(k));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& k) {
+            pair<link_type, link_type> r = __equal_range(k);
+            return pair<iterator, iterator>(iterator(r.first), iterator(r.second));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<const_iterator, const_iterator> >::type equal_range(const K& k) const {
+            pair<link_type, link_type> r = __equal_range(k);
+            return pair<const_iterator, const_iterator>(const_iterator(r.first), const_iterator(r.second));
+        }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& k) const {
+            return __count(k);
+        }
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        // 顺序统计 ---------------------------------------------
+        // 键值小于 k 的节点个数, 即 lower_bound(k) 在中序中的位置
+        size_type rank(const key_type& k) const;
+        // 中序第 k 个节点 (从 0 开始), k >= size() 时返回 end()
+        iterator select(size_type k) {
+            return k < node_count ? iterator((link_type) __rb_tree_select(root(), k)) : end();
+        }
+        const_iterator select(size_type k) const {
+            return k < node_count ? const_iterator((link_type) __rb_tree_select(root(), k)) : end();
+        }
+#endif
     };
 
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+    // 与 lower_bound 相同的下降路径, 每次往右走时加上左子树和当前节点
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::PostOrder(link_type x) {
-        if (x) {
-            PostOrder((link_type)x->left);
-            PostOrder((link_type)x->right);
-            destroy_node(x);
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::rank(const key_type& k) const {
+        size_type r = 0;
+        link_type x = root();
+        while (x != nullptr) {
+            if (!key_compare(key(x), k)) { // x >= k, 往左走
+                x = left(x);
+            }
+            else { // x < k, x 和它的左子树都排在 k 之前
+                r += __rb_tree_node_base::size_of(x->left) + 1;
+                x = right(x);
+            }
         }
+        return r;
     }
+#endif
 
-    // 返回值是一个迭代器, 指向新增节点
+    // 不用递归的先序遍历: 沿左链一路向下, 右孩子压入显式栈, 节点读出左右孩子后立即摘下
+    // 红黑树高度不超过 2log(n+1), 显式栈容量 128 足够; 万一不够 (不合法的树) 再退回递归
+    // 压栈时预取右孩子, 等到回头处理它时缓存行已经载入, 对键值随机插入 (节点散落在内存中) 的树效果明显
+    // 摘下的节点析构后以首字串成一条链, 最后整串交还配置器 (第二级配置器 O(1) 接回 free list)
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator 
-    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(const value_type& v) {
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__erase(link_type x) {
+        typedef typename __type_traits<value_type>::has_trivial_destructor trivial_destructor;
+        const int stack_size = 128;
+        link_type stack[stack_size];
+        int top = 0;
+        link_type chain = nullptr; // 链头, 最后摘下的节点
+        link_type tail = x; // 链尾, 第一个摘下的节点就是 x
+        while (true) {
+            while (x) {
+                link_type l = left(x);
+                link_type r = right(x);
+                if (r) {
+                    if (top < stack_size) {
+                        stack[top++] = r;
+                        __LI_PREFETCH(r);
+                    }
+                    else {
+                        __erase(r);
+                    }
+                }
+                destroy_value(x, trivial_destructor());
+                *(void**)x = chain; // 节点已经无用, 首字改作链接
+                chain = x;
+                x = l;
+            }
+            if (0 == top) {
+                break;
+            }
+            x = stack[--top];
+        }
+        if (chain) {
+            rb_tree_node_allocator::deallocate_chain(chain, tail);
+        }
+    }
+
+    // 取中点为根, 递归建立左右子树, 得到一棵完美平衡的树 (左子树 (n - 1) / 2 个节点)
+    // 这样的树中所有空指针都位于最后两层, 因此把最深一层 (深度为 floor(log2 n)) 的节点涂红,
+    // 其余涂黑即满足红黑树的规则; 只有一个节点时它就是根, 保持黑色
+    // 节点按中序 (键值递增) 的次序申请, 从内存池的同一块连续空间中切出, 顺序遍历时局部性好
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class ForwardIterator>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__build_from_sorted(ForwardIterator& first, size_type n,
+                                                                         size_type depth, size_type red_depth) {
+        if (n == 0) return nullptr;
+        size_type left_n = (n - 1) / 2;
+        link_type l = __build_from_sorted(first, left_n, depth + 1, red_depth);
+        link_type x;
+        try {
+            x = creat_node(*first);
+        }
+        catch(...) {
+            __erase(l); // 释放已经建好的左子树
+            throw;
+        }
+        ++first;
+        left(x) = l;
+        if (l) set_parent(l, x);
+        right(x) = nullptr;
+        set_color(x, (depth == red_depth && depth > 0) ? __rb_tree_red : __rb_tree_black);
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        x->subtree_size = n;
+#endif
+        try {
+            link_type r = __build_from_sorted(first, n - 1 - left_n, depth + 1, red_depth);
+            right(x) = r;
+            if (r) set_parent(r, x);
+        }
+        catch(...) {
+            __erase(x); // x 和左子树一起释放
+            throw;
+        }
+        return x;
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class ForwardIterator>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::build_from_sorted(ForwardIterator first, ForwardIterator last) {
+        clear();
+        size_type n = size_type(LI::distance(first, last));
+        if (n == 0) return;
+        size_type red_depth = 0; // floor(log2 n)
+        for (size_type m = n; m > 1; m >>= 1) ++red_depth;
+
+        link_type x = __build_from_sorted(first, n, 0, red_depth);
+        set_root(x);
+        set_parent(x, header);
+        leftmost() = minimum(x);
+        rightmost() = maximum(x);
+        node_count = n;
+    }
+
+    // 复制以 x 为根的子树, 新子树的父节点为 p
+    // 沿左链迭代, 只对右子树递归, 递归深度不超过树高
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__copy(link_type x, link_type p) {
+        link_type top = clone_node(x); // 连同颜色一起复制
+        set_parent(top, p);
+        try {
+            if (right(x)) {
+                right(top) = __copy(right(x), top);
+            }
+            p = top;
+            x = left(x);
+            while (x != nullptr) {
+                link_type y = clone_node(x);
+                left(p) = y;
+                set_parent(y, p);
+                if (right(x)) {
+                    right(y) = __copy(right(x), y);
+                }
+                p = y;
+                x = left(x);
+            }
+        }
+        catch(...) {
+            __erase(top); // 释放已经复制的部分
+            throw;
+        }
+        return top;
+    }
+
+    // 插入位置的查找 ------------------------------------------------
+    // 返回 (x, y): y 为新节点的父节点, x 非空表示挂在 y 的左侧
+    // 不允许重复时若键值已存在, 返回 (已存在的节点, nullptr)
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_equal_pos(const key_type& k) {
         link_type y = header;
         link_type x = root();
         while (x != nullptr) {
             y = x;
-            x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
+            x = key_compare(k, key(x)) ? left(x) : right(x);
             // 找到合适的插入位置
         }
-
-        return __insert(x, y, v);
+        return y;
     }
 
-    // 返回值是一个迭代器 和 一个成功与否的标志
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool> 
-    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const value_type& v) {
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type,
+         typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_unique_pos(const key_type& k) {
         link_type y = header;
         link_type x = root();
 
         bool comp = true;
         while (x != nullptr) {
             y = x;
-            comp = key_compare(KeyOfValue()(v), key(x)); // v 的键值小于目前节点的键值?
-            x = comp ? left(x) : right(x); // x > v 当前节点往左; x <= v 当前节点往右
+            comp = key_compare(k, key(x)); // k 小于目前节点的键值?
+            x = comp ? left(x) : right(x); // x > k 当前节点往左; x <= k 当前节点往右
         }
         // 离开循环后, y 是插入点的父节点
 
         iterator j = iterator(y); // 令迭代器 j 指向插入点之父节点 y
-        if (comp) { // 如果离开 while 的时候 comp 为真, 则 v 应该插入在左侧(v < j)
+        if (comp) { // 如果离开 while 的时候 comp 为真, 则 k 应该插入在左侧(k < j)
             if (j == begin()) { // 如果父节点是最左节点
-                return pair<iterator, bool>(__insert(x, y, v), true);
+                return pair<link_type, link_type>(x, y);
             }
             else {
                 --j; // 父节点不是最左节点, 调整 j, 准备回头测试... (--j) < j
             }
         }
-        if (key_compare(key(j.node), KeyOfValue()(v))) { // (--j) < v < j
-            // 新键值不与既有节点之键值重复, 于是执行以下操作
-            return pair<iterator, bool>(__insert(x, y, v), true);
+        if (key_compare(key(j.node), k)) { // (--j) < k < j
+            // 新键值不与既有节点之键值重复
+            return pair<link_type, link_type>(x, y);
         }
 
         // 否则 肯定有重复的键值
-        // (--j) >= v 且 v < j  ==> 插入位置矛盾  ==> v == (--j)
-        // v >= j 且 (--j) >= v  ==> v == j
-        return pair<iterator, bool>(j, false);
+        // (--j) >= k 且 k < j  ==> 插入位置矛盾  ==> k == (--j)
+        // k >= j 且 (--j) >= k  ==> k == j
+        return pair<link_type, link_type>((link_type) j.node, nullptr);
+    }
+
+    // 先检查提示位置 position 及其前一个节点, 满足 (--position) < k < position 时
+    // 新节点必然可以挂在 (--position) 的右侧 或 position 的左侧, 不必从根节点往下找
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type,
+         typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_unique_hint_pos(iterator position, const key_type& k) {
+        if (position.node == header->left) { // begin()
+            if (size() > 0 && key_compare(k, key(position.node))) {
+                return pair<link_type, link_type>((link_type) position.node, (link_type) position.node); // 第一参数非空, 插在左侧
+            }
+            return __insert_unique_pos(k);
+        }
+        else if (position.node == header) { // end()
+            if (key_compare(key(rightmost()), k)) { // 比最大值还大, 递增输入的常见情况
+                return pair<link_type, link_type>(nullptr, rightmost());
+            }
+            return __insert_unique_pos(k);
+        }
+        else {
+            iterator before = position;
+            --before;
+            if (key_compare(key(before.node), k) && key_compare(k, key(position.node))) {
+                // before 是 position 的前驱: 要么 before 没有右孩子, 要么 position 没有左孩子
+                if (right(before.node) == nullptr) {
+                    return pair<link_type, link_type>(nullptr, (link_type) before.node);
+                }
+                return pair<link_type, link_type>((link_type) position.node, (link_type) position.node);
+            }
+            return __insert_unique_pos(k);
+        }
+    }
+
+    // 与上面的类似, 但允许相等, 次序与 std::multimap 相同:
+    // k <= position 时尽量插在 position 之前 (检查前驱), k > position 时尽量插在 position 之后 (检查后继),
+    // 都不满足时才从根节点往下找; 后一种情况插在相等元素的最前面, 离提示位置最近
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type,
+         typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_equal_hint_pos(iterator position, const key_type& k) {
+        if (position.node == header) { // end()
+            if (size() > 0 && !key_compare(k, key(rightmost()))) {
+                return pair<link_type, link_type>(nullptr, rightmost());
+            }
+            return pair<link_type, link_type>(nullptr, __insert_equal_pos(k));
+        }
+        if (!key_compare(key(position.node), k)) { // k <= position
+            if (position.node == leftmost()) {
+                return pair<link_type, link_type>((link_type) position.node, (link_type) position.node);
+            }
+            iterator before = position;
+            --before;
+            if (!key_compare(k, key(before.node))) { // (--position) <= k <= position
+                if (right(before.node) == nullptr) {
+                    return pair<link_type, link_type>(nullptr, (link_type) before.node);
+                }
+                return pair<link_type, link_type>((link_type) position.node, (link_type) position.node);
+            }
+            return pair<link_type, link_type>(nullptr, __insert_equal_pos(k));
+        }
+        // position < k
+        if (position.node == rightmost()) {
+            return pair<link_type, link_type>(nullptr, rightmost());
+        }
+        iterator after = position;
+        ++after;
+        if (!key_compare(key(after.node), k)) { // position < k <= (++position)
+            if (right(position.node) == nullptr) {
+                return pair<link_type, link_type>(nullptr, (link_type) position.node);
+            }
+            return pair<link_type, link_type>((link_type) after.node, (link_type) after.node);
+        }
+        return __insert_equal_lower_pos(k);
+    }
+
+    // 插在所有与 k 相等的元素之前
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type,
+         typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_equal_lower_pos(const key_type& k) {
+        link_type y = header;
+        link_type x = root();
+        while (x != nullptr) {
+            y = x;
+            x = !key_compare(key(x), k) ? left(x) : right(x);
+        }
+        if (y != header && !key_compare(key(y), k)) {
+            return pair<link_type, link_type>(y, y); // 第一参数非空, 插在 y 的左侧 (y 可能与 k 相等)
+        }
+        return pair<link_type, link_type>(nullptr, y);
+    }
+
+    // 插入值 ------------------------------------------------------
+
+    // 返回值是一个迭代器, 指向新增节点
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator 
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(const value_type& v) {
+        return __insert(nullptr, __insert_equal_pos(KeyOfValue()(v)), v);
+    }
+
+    // 返回值是一个迭代器 和 一个成功与否的标志
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool> 
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const value_type& v) {
+        pair<link_type, link_type> p = __insert_unique_pos(KeyOfValue()(v));
+        if (p.second) {
+            return pair<iterator, bool>(__insert(p.first, p.second, v), true);
+        }
+        return pair<iterator, bool>(iterator(p.first), false); // 键值重复
+    }
+
+    // 返回新节点 或 已存在的同键值节点
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(iterator position, const value_type& v) {
+        pair<link_type, link_type> p = __insert_unique_hint_pos(position, KeyOfValue()(v));
+        if (p.second) {
+            return __insert(p.first, p.second, v);
+        }
+        return iterator(p.first);
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(iterator position, const value_type& v) {
+        pair<link_type, link_type> p = __insert_equal_hint_pos(position, KeyOfValue()(v));
+        return __insert(p.first, p.second, v);
     }
 
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
@@ -712,14 +1519,30 @@ namespace LI {
         link_type x = (link_type)x_;
         link_type y = (link_type)y_;
 
-        link_type z;
+        // y 为 header 或 v < y 或 x != 0 (带提示的插入会指定插在 y 的左侧) 时挂在左侧
+        // 先比较再申请节点, 比较抛出异常时不会泄漏
+        bool insert_left = (y == header || x != nullptr || key_compare(KeyOfValue()(v), key(y)));
+        link_type z = creat_node(v); // 产生一个新节点
+        return __link(insert_left, y, z);
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator 
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__insert_node(base_ptr x_, base_ptr y_, link_type z) {
+        link_type x = (link_type)x_;
+        link_type y = (link_type)y_;
+        bool insert_left = (y == header || x != nullptr || key_compare(key(z), key(y)));
+        return __link(insert_left, y, z);
+    }
 
-        // y 为 header 或 v < y 或 x != 0(这种情况好像不会出现?) 
-        if (y == header || x != nullptr || key_compare(KeyOfValue()(v), key(y))) {
-            z = creat_node(v); // 产生一个新节点
+    // 把节点 z 挂到 y 的左侧或右侧, 然后调整树形
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator 
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__link(bool insert_left, link_type y, link_type z) {
+        if (insert_left) {
             left(y) = z;  // 这里如果 y == header, 也即 leftmost() = z 
             if (y == header) {
-                root() = z;
+                set_root(z);
                 rightmost() = z;
             }
             else if (y == leftmost()) {
@@ -727,25 +1550,239 @@ namespace LI {
             }
         }
         else {
-            z = creat_node(v); // 产生一个新节点
             right(y) = z;
             if (y == rightmost()) {
                 rightmost() = z; // 维护最大值
             }
         }
-        parent(z) = y; // 设定父节点
+        set_parent(z, y); // 设定父节点
         left(z) = nullptr;
         right(z) = nullptr;
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        z->subtree_size = 1;
+        for (base_ptr p = y; p != header; p = p->get_parent()) { // 新节点的祖先各加一, 之后的旋转自行维护
+            ++p->subtree_size;
+        }
+#endif
 
         // 新节点的颜色在 __rb_tree_rebalance() 设定
-        __rb_tree_rebalance(z, header->parent); // 参数 1 是新增节点, 参数 2 是 root
+        // 参数 1 是新增节点, 参数 2 是 root; root 可能被改变, 完成后写回 header
+        base_ptr r = root();
+        __rb_tree_rebalance(z, r);
+        set_root((link_type) r);
         ++node_count;
         return iterator(z);
     }
 
+    // 原地构造 ------------------------------------------------------
+
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator 
-    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::find(const key_type& k) {
+    template <class... Args>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::emplace_unique(Args&&... args) {
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        try {
+            pair<link_type, link_type> p = __insert_unique_pos(key(z));
+            if (p.second) {
+                return pair<iterator, bool>(__insert_node(p.first, p.second, z), true);
+            }
+            destroy_node(z); // 键值重复
+            return pair<iterator, bool>(iterator(p.first), false);
+        }
+        catch(...) {
+            destroy_node(z); // 比较时抛出异常
+            throw;
+        }
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::emplace_equal(Args&&... args) {
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        try {
+            return __insert_node(nullptr, __insert_equal_pos(key(z)), z);
+        }
+        catch(...) {
+            destroy_node(z);
+            throw;
+        }
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::emplace_hint_unique(iterator position, Args&&... args) {
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        try {
+            pair<link_type, link_type> p = __insert_unique_hint_pos(position, key(z));
+            if (p.second) {
+                return __insert_node(p.first, p.second, z);
+            }
+            destroy_node(z);
+            return iterator(p.first);
+        }
+        catch(...) {
+            destroy_node(z);
+            throw;
+        }
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::emplace_hint_equal(iterator position, Args&&... args) {
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        try {
+            pair<link_type, link_type> p = __insert_equal_hint_pos(position, key(z));
+            return __insert_node(p.first, p.second, z);
+        }
+        catch(...) {
+            destroy_node(z);
+            throw;
+        }
+    }
+
+    // 插入位置已经由 k 确定, 节点构造失败时树没有任何改变
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::try_emplace_unique(const key_type& k, Args&&... args) {
+        pair<link_type, link_type> p = __insert_unique_pos(k);
+        if (p.second == nullptr) {
+            return pair<iterator, bool>(iterator(p.first), false); // 命中, 不构造
+        }
+        // 在构造节点之前比较: args 中可能含有被移动的 k
+        bool insert_left = (p.second == header || p.first != nullptr || key_compare(k, key(p.second)));
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        return pair<iterator, bool>(__link(insert_left, p.second, z), true);
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class... Args>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::try_emplace_hint_unique(iterator position, const key_type& k, Args&&... args) {
+        pair<link_type, link_type> p = __insert_unique_hint_pos(position, k);
+        if (p.second == nullptr) {
+            return iterator(p.first);
+        }
+        bool insert_left = (p.second == header || p.first != nullptr || key_compare(k, key(p.second)));
+        link_type z = creat_node(LI::forward<Args>(args)...);
+        return __link(insert_left, p.second, z);
+    }
+
+    // 节点的摘取与接回 --------------------------------------------
+
+    // 从树中摘下节点, 但不析构也不释放, 交给节点把手
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__unlink(iterator position) {
+        base_ptr r = root();
+        link_type y = (link_type) __rb_tree_rebalance_for_erase(position.node, r, header->left, header->right);
+        set_root((link_type) r);
+        --node_count;
+        return y;
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::node_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::extract(const key_type& k) {
+        iterator position = find(k);
+        if (position == end()) {
+            return node_type();
+        }
+        return extract(position);
+    }
+
+    // 键值不存在时插入并返回 inserted 为真, 否则节点留在返回值的 node 中
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_return_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(node_type&& nh) {
+        insert_return_type ret;
+        if (nh.empty()) {
+            ret.position = end();
+            ret.inserted = false;
+            return ret;
+        }
+        pair<link_type, link_type> p = __insert_unique_pos(key(nh.ptr));
+        if (p.second) {
+            ret.position = __insert_node(p.first, p.second, nh.release());
+            ret.inserted = true;
+        }
+        else {
+            ret.position = iterator(p.first);
+            ret.inserted = false;
+            ret.node = LI::move(nh);
+        }
+        return ret;
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(iterator position, node_type&& nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        pair<link_type, link_type> p = __insert_unique_hint_pos(position, key(nh.ptr));
+        if (p.second) {
+            return __insert_node(p.first, p.second, nh.release());
+        }
+        return iterator(p.first); // 键值重复, 节点仍由 nh 持有
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(node_type&& nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        link_type y = __insert_equal_pos(key(nh.ptr));
+        return __insert_node(nullptr, y, nh.release());
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(iterator position, node_type&& nh) {
+        if (nh.empty()) {
+            return end();
+        }
+        pair<link_type, link_type> p = __insert_equal_hint_pos(position, key(nh.ptr));
+        return __insert_node(p.first, p.second, nh.release());
+    }
+
+    // 把 src 中键值在 *this 里还不存在的节点直接搬过来, 不申请内存也不复制元素
+    // 键值重复的节点留在 src 中
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::merge_unique(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& src) {
+        if (this == &src) return;
+        for (iterator it = src.begin(); it != src.end(); ) {
+            iterator cur = it++; // 先递增, cur 摘下后 it 仍然有效
+            pair<link_type, link_type> p = __insert_unique_pos(key(cur.node));
+            if (p.second) {
+                __insert_node(p.first, p.second, src.__unlink(cur));
+            }
+        }
+    }
+
+    // 允许重复时 src 的节点全部搬过来; 按递增次序搬, 相同键值保持原来的先后
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::merge_equal(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& src) {
+        if (this == &src) return;
+        if (empty()) { // 整棵树交换即可
+            swap(src);
+            return;
+        }
+        for (iterator it = src.begin(); it != src.end(); ) {
+            iterator cur = it++;
+            link_type y = __insert_equal_pos(key(cur.node));
+            __insert_node(nullptr, y, src.__unlink(cur));
+        }
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__find(const K& k) const {
         link_type y = header;
         link_type x = root();
         
@@ -759,26 +1796,210 @@ namespace LI {
             }
         }
 
-        iterator j = iterator(y);
-        return (j == end() || key_compare(k, key(j.node))) ? end() : j;
-        // j == end() 即 k 是最大的, 不可能相等
-        // k < key(j.node) 即不存在相等的, 如果相等, 有 k >= key(j.node)
+        return (y == header || key_compare(k, key(y))) ? header : y;
+        // y == header 即 k 是最大的, 不可能相等
+        // k < key(y) 即不存在相等的, 如果相等, 有 k >= key(y)
+    }
+
+    // 每条路径的下降过程与 __find 相同, 但每轮只走一层, 并预取下一层的节点;
+    // 一条路径走到底就写出结果, 换入下一个键值, 始终保持 __rb_tree_batch_width 条路径在进行
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class KeySource, class ResultIterator>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__find_batch(const KeySource& src, size_type n,
+                                                                       ResultIterator* result) const {
+        link_type x[__rb_tree_batch_width]; // 各路径当前的节点
+        link_type y[__rb_tree_batch_width]; // 各路径目前最后一个不小于键值的节点
+        size_type id[__rb_tree_batch_width]; // 各路径正在查找第几个键值
+        size_type active = 0;
+        size_type next = 0;
+        for ( ; active < size_type(__rb_tree_batch_width) && next < n; ++active, ++next) {
+            x[active] = root();
+            y[active] = header;
+            id[active] = next;
+        }
+        while (active > 0) {
+            for (size_type i = 0; i < active; ) {
+                const key_type& k = src.key(id[i]);
+                if (x[i] != nullptr) {
+                    if (!key_compare(key(x[i]), k)) {
+                        y[i] = x[i];
+                        x[i] = left(x[i]);
+                    }
+                    else {
+                        x[i] = right(x[i]);
+                    }
+                    if (x[i] != nullptr) {
+                        __LI_PREFETCH(x[i]); // 轮到这条路径之前, 先去访问其他路径
+                    }
+                    ++i;
+                    continue;
+                }
+                // 这条路径结束
+                result[src.index(id[i])] = ResultIterator((y[i] == header || key_compare(k, key(y[i]))) ? header : y[i]);
+                if (next < n) {
+                    x[i] = root();
+                    y[i] = header;
+                    id[i] = next++;
+                    ++i;
+                }
+                else { // 没有新的键值, 把最后一条路径移到这里
+                    --active;
+                    x[i] = x[active];
+                    y[i] = y[active];
+                    id[i] = id[active];
+                }
+            }
+        }
+    }
+
+    template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class ResultIterator>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__find_batch_sorted(const key_type* keys, size_type n,
+                                                                              ResultIterator* result) const {
+        typedef simple_alloc<const key_type*, Alloc> order_allocator;
+        if (n == 0) return;
+        const key_type** order = order_allocator::allocate(n);
+        try {
+            for (size_type i = 0; i < n; ++i) {
+                order[i] = keys + i;
+            }
+            LI::sort(order, order + n, __rb_tree_key_ptr_compare<key_type, Compare>(key_compare));
+            __rb_tree_batch_sorted_keys<key_type> src = { keys, order };
+            __find_batch(src, n, result);
+        }
+        catch(...) {
+            order_allocator::deallocate(order, n);
+            throw;
+        }
+        order_allocator::deallocate(order, n);
     }
 
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
     void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator position) {
-        link_type y = (link_type) __rb_tree_rebalance_for_erase(position.node, header->parent, header->left, header->right);
-        destroy_node(y); // 删除节点
-        --node_count;
+        destroy_node(__unlink(position)); // 摘下再删除节点
     }
 
     template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
-    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(const key_type& k) {
-        iterator position = find(k);
-        if (position == end()) {
-            return;
+    template <class K>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__erase_key(const K& k) {
+        pair<link_type, link_type> p = __equal_range(k); // 允许重复键值时可能有多个
+        size_type n = __distance(p.first, p.second);
+        erase(iterator(p.first), iterator(p.second));
+        return n;
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::size_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__count(const K& k) const {
+        pair<link_type, link_type> r = __equal_range(k);
+        return __distance(r.first, r.second);
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    void rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::erase(iterator first, iterator last) {
+        if (first == begin() && last == end()) { // 删除全部节点, 不必逐个调整树形
+            clear();
+        }
+        else {
+            while (first != last) {
+                erase(first++); // 先递增, first 指向的节点删除后迭代器失效
+            }
         }
-        erase(position); // 调用另一个版本 erase
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__lower_bound(const K& k) const {
+        link_type y = header; // 最后一个不小于 k 的节点
+        link_type x = root();
+
+        while (x != nullptr) {
+            if (!key_compare(key(x), k)) { // x >= k, 记录并往左走
+                y = x;
+                x = left(x);
+            }
+            else { // x < k, 往右走
+                x = right(x);
+            }
+        }
+        return y;
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__upper_bound(const K& k) const {
+        link_type y = header; // 最后一个大于 k 的节点
+        link_type x = root();
+
+        while (x != nullptr) {
+            if (key_compare(k, key(x))) { // x > k, 记录并往左走
+                y = x;
+                x = left(x);
+            }
+            else { // x <= k, 往右走
+                x = right(x);
+            }
+        }
+        return y;
+    }
+
+    // 从根往下走到第一个等于 k 的节点 x 时分叉:
+    // lower_bound 只可能在 x 和其左子树中, upper_bound 只可能在其右子树中 (或者是已经记录的 yu)
+    // 共享分叉前的路径, 比分别调用 lower_bound 和 upper_bound 少走一段
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    template <class K>
+    pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type,
+         typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::link_type>
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc>::__equal_range(const K& k) const {
+        link_type y = header;
+        link_type x = root();
+
+        while (x != nullptr) {
+            if (key_compare(key(x), k)) { // x < k
+                x = right(x);
+            }
+            else if (key_compare(k, key(x))) { // x > k
+                y = x;
+                x = left(x);
+            }
+            else { // x == k
+                link_type yu = y;
+                link_type xu = right(x);
+                y = x;
+                x = left(x);
+                // 左子树中找 lower_bound
+                while (x != nullptr) {
+                    if (!key_compare(key(x), k)) {
+                        y = x;
+                        x = left(x);
+                    }
+                    else {
+                        x = right(x);
+                    }
+                }
+                // 右子树中找 upper_bound
+                while (xu != nullptr) {
+                    if (key_compare(k, key(xu))) {
+                        yu = xu;
+                        xu = left(xu);
+                    }
+                    else {
+                        xu = right(xu);
+                    }
+                }
+                return pair<link_type, link_type>(y, yu);
+            }
+        }
+        return pair<link_type, link_type>(y, y); // 没有等于 k 的节点
+    }
+
+    template<class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+    inline void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x, rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& y) {
+        x.swap(y);
     }
 
 }
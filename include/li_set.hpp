@@ -0,0 +1,302 @@
+#ifndef LI_SET_H_
+#define LI_SET_H_
+
+#include "li_rbtree.hpp"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+
+
+// set 与 multiset 的实现
+// 元素就是键值, 以 identity 取键值, 节点中只保存一个 Key
+namespace LI {
+    template <class Key, class Compare, class Alloc>
+    class multiset;
+
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class set {
+        template <class, class, class> friend class multiset; // merge 时要访问对方的红黑树
+    public:
+        typedef Key key_type;
+        typedef Key value_type; // 实值就是键值
+        typedef Compare key_compare;
+        typedef Compare value_compare; // 两者使用同一个比较函数
+
+    private:
+        typedef rb_tree<key_type, value_type, identity<value_type>, key_compare, Alloc> rep_type;
+        rep_type t; // 红黑树对象
+        typedef typename rep_type::iterator rep_iterator;
+        // 以 const_iterator 的节点指针建立 rep_type::iterator, 不把迭代器的引用重新解释为另一型别
+        static rep_iterator __rep(const typename rep_type::const_iterator& it) {
+            return rep_iterator((typename rep_iterator::link_type) it.node);
+        }
+
+    public:
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        // 修改元素会破坏排列规则, 所以 iterator 也定义为 const_iterator
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::node_type node_type; // 节点把手
+        typedef typename rep_type::insert_return_type insert_return_type;
+
+        set() : t(Compare()) { }
+        explicit set(const Compare& comp) : t(comp) { }
+        // 以区间构造, 已排序的输入每次插入均摊 O(1)
+        template <class InputIterator>
+        set(InputIterator first, InputIterator last) : t(Compare()) {
+            t.insert_unique(first, last);
+        }
+        // 调用者保证区间严格递增, 直接建立平衡树, O(n)
+        template <class ForwardIterator>
+        set(ForwardIterator first, ForwardIterator last, sorted_unique_tag) : t(Compare()) {
+            t.build_from_sorted(first, last);
+        }
+
+        set(const set<Key, Compare, Alloc>& x) : t(x.t) { }
+        set(set<Key, Compare, Alloc>&& x) : t(LI::move(x.t)) { }
+
+        ~set() { }
+
+        set<Key, Compare, Alloc>& operator=(const set<Key, Compare, Alloc>& x) {
+            t = x.t;
+            return *this;
+        }
+        set<Key, Compare, Alloc>& operator=(set<Key, Compare, Alloc>&& x) {
+            t = LI::move(x.t);
+            return *this;
+        }
+        void swap(set<Key, Compare, Alloc>& x) { t.swap(x.t); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return t.key_comp(); }
+        iterator begin() const { return t.begin(); }
+        iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+
+        // 插入 --------------------------------------------------
+        // 红黑树返回的是 rep_iterator, 需要转成 const_iterator
+        pair<iterator, bool> insert(const value_type& x) {
+            pair<rep_iterator, bool> p = t.insert_unique(x);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_unique(__rep(position), x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            t.insert_unique(first, last);
+        }
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            pair<rep_iterator, bool> p = t.emplace_unique(LI::forward<Args>(args)...);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            return t.emplace_hint_unique(__rep(position), LI::forward<Args>(args)...);
+        }
+        insert_return_type insert(node_type&& nh) {
+            return t.insert_unique(LI::move(nh));
+        }
+        iterator insert(iterator position, node_type&& nh) {
+            return t.insert_unique(__rep(position), LI::move(nh));
+        }
+
+        // 删除 --------------------------------------------------
+        node_type extract(iterator position) { return t.extract(__rep(position)); }
+        node_type extract(const key_type& k) { return t.extract(k); }
+        // source 中已存在于本 set 的元素留在 source 中
+        void merge(set<Key, Compare, Alloc>& source) { t.merge_unique(source.t); }
+        void merge(set<Key, Compare, Alloc>&& source) { t.merge_unique(source.t); }
+        void merge(multiset<Key, Compare, Alloc>& source) { t.merge_unique(source.t); }
+        void merge(multiset<Key, Compare, Alloc>&& source) { t.merge_unique(source.t); }
+        void erase(iterator position) { t.erase(__rep(position)); }
+        size_type erase(const key_type& k) { return t.erase(k); }
+        void erase(iterator first, iterator last) { t.erase(__rep(first), __rep(last)); }
+        void clear() { t.clear(); }
+
+        // 查找 --------------------------------------------------
+        iterator find(const key_type& x) const { return t.find(x); }
+        // 批量查找 result[i] = find(keys[i]), 多条树下降交替进行以重叠缓存未命中
+        void find_batch(const key_type* keys, size_type n, iterator* result) const { t.find_batch(keys, n, result); }
+        // 先排序键值再批量查找, 适合键值很多的情况
+        void find_batch_sorted(const key_type* keys, size_type n, iterator* result) const { t.find_batch_sorted(keys, n, result); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        // 异构查找: Compare 带有 is_transparent (如 less<void>) 时接受任何能与 Key 比较的型别
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& x) const { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& x) const { return t.count(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& x) { return t.erase(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& x) const { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& x) const { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& x) const { return t.equal_range(x); }
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        size_type rank(const key_type& x) const { return t.rank(x); } // 小于 x 的元素个数
+        iterator select(size_type k) const { return t.select(k); } // 第 k 小的元素 (从 0 开始)
+#endif
+    };
+
+    template <class Key, class Compare, class Alloc>
+    inline void swap(set<Key, Compare, Alloc>& x, set<Key, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+
+    // multiset: 与 set 唯一的区别是插入时调用 insert_equal, 允许键值重复
+    template <class Key, class Compare = less<Key>, class Alloc = alloc>
+    class multiset {
+        template <class, class, class> friend class set;
+    public:
+        typedef Key key_type;
+        typedef Key value_type;
+        typedef Compare key_compare;
+        typedef Compare value_compare;
+
+    private:
+        typedef rb_tree<key_type, value_type, identity<value_type>, key_compare, Alloc> rep_type;
+        rep_type t;
+        typedef typename rep_type::iterator rep_iterator;
+        // 以 const_iterator 的节点指针建立 rep_type::iterator, 不把迭代器的引用重新解释为另一型别
+        static rep_iterator __rep(const typename rep_type::const_iterator& it) {
+            return rep_iterator((typename rep_iterator::link_type) it.node);
+        }
+
+    public:
+        typedef typename rep_type::const_pointer pointer;
+        typedef typename rep_type::const_pointer const_pointer;
+        typedef typename rep_type::const_reference reference;
+        typedef typename rep_type::const_reference const_reference;
+        typedef typename rep_type::const_iterator iterator;
+        typedef typename rep_type::const_iterator const_iterator;
+        typedef typename rep_type::size_type size_type;
+        typedef typename rep_type::difference_type difference_type;
+        typedef typename rep_type::node_type node_type;
+
+        multiset() : t(Compare()) { }
+        explicit multiset(const Compare& comp) : t(comp) { }
+        template <class InputIterator>
+        multiset(InputIterator first, InputIterator last) : t(Compare()) {
+            t.insert_equal(first, last);
+        }
+        // 调用者保证区间已按键值排序 (允许相等), O(n)
+        template <class ForwardIterator>
+        multiset(ForwardIterator first, ForwardIterator last, sorted_equivalent_t) : t(Compare()) {
+            t.build_from_sorted(first, last);
+        }
+
+        multiset(const multiset<Key, Compare, Alloc>& x) : t(x.t) { }
+        multiset(multiset<Key, Compare, Alloc>&& x) : t(LI::move(x.t)) { }
+
+        ~multiset() { }
+
+        multiset<Key, Compare, Alloc>& operator=(const multiset<Key, Compare, Alloc>& x) {
+            t = x.t;
+            return *this;
+        }
+        multiset<Key, Compare, Alloc>& operator=(multiset<Key, Compare, Alloc>&& x) {
+            t = LI::move(x.t);
+            return *this;
+        }
+        void swap(multiset<Key, Compare, Alloc>& x) { t.swap(x.t); }
+
+        key_compare key_comp() const { return t.key_comp(); }
+        value_compare value_comp() const { return t.key_comp(); }
+        iterator begin() const { return t.begin(); }
+        iterator end() const { return t.end(); }
+        bool empty() const { return t.empty(); }
+        size_type size() const { return t.size(); }
+        size_type max_size() const { return t.max_size(); }
+
+        // 插入总是成功, 相等的元素排在已有元素之后
+        iterator insert(const value_type& x) {
+            return t.insert_equal(x);
+        }
+        iterator insert(iterator position, const value_type& x) {
+            return t.insert_equal(__rep(position), x);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            t.insert_equal(first, last);
+        }
+        template <class... Args>
+        iterator emplace(Args&&... args) {
+            return t.emplace_equal(LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        iterator emplace_hint(iterator position, Args&&... args) {
+            return t.emplace_hint_equal(__rep(position), LI::forward<Args>(args)...);
+        }
+        iterator insert(node_type&& nh) {
+            return t.insert_equal(LI::move(nh));
+        }
+        iterator insert(iterator position, node_type&& nh) {
+            return t.insert_equal(__rep(position), LI::move(nh));
+        }
+
+        node_type extract(iterator position) { return t.extract(__rep(position)); }
+        node_type extract(const key_type& k) { return t.extract(k); } // 只摘下第一个等于 k 的元素
+        // source 中的元素全部搬过来
+        void merge(multiset<Key, Compare, Alloc>& source) { t.merge_equal(source.t); }
+        void merge(multiset<Key, Compare, Alloc>&& source) { t.merge_equal(source.t); }
+        void merge(set<Key, Compare, Alloc>& source) { t.merge_equal(source.t); }
+        void merge(set<Key, Compare, Alloc>&& source) { t.merge_equal(source.t); }
+        void erase(iterator position) { t.erase(__rep(position)); }
+        size_type erase(const key_type& k) { return t.erase(k); } // 删除所有等于 k 的元素
+        void erase(iterator first, iterator last) { t.erase(__rep(first), __rep(last)); }
+        void clear() { t.clear(); }
+
+        iterator find(const key_type& x) const { return t.find(x); }
+        // 批量查找 result[i] = find(keys[i]), 多条树下降交替进行以重叠缓存未命中
+        void find_batch(const key_type* keys, size_type n, iterator* result) const { t.find_batch(keys, n, result); }
+        // 先排序键值再批量查找, 适合键值很多的情况
+        void find_batch_sorted(const key_type* keys, size_type n, iterator* result) const { t.find_batch_sorted(keys, n, result); }
+        size_type count(const key_type& x) const { return t.count(x); }
+        iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+        iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+        pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type find(const K& x) const { return t.find(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type count(const K& x) const { return t.count(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, size_type>::type erase(const K& x) { return t.erase(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type lower_bound(const K& x) const { return t.lower_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, iterator>::type upper_bound(const K& x) const { return t.upper_bound(x); }
+        template <class K>
+        typename __rb_tree_transparent<Compare, K, pair<iterator, iterator> >::type equal_range(const K& x) const { return t.equal_range(x); }
+
+#ifdef LI_RB_TREE_ORDER_STATISTIC
+        size_type rank(const key_type& x) const { return t.rank(x); }
+        iterator select(size_type k) const { return t.select(k); }
+#endif
+    };
+
+    template <class Key, class Compare, class Alloc>
+    inline void swap(multiset<Key, Compare, Alloc>& x, multiset<Key, Compare, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
@@ -0,0 +1,706 @@
+#ifndef LI_SIMD_H_
+#define LI_SIMD_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+#include "li_type_traits.h"
+
+// 算法的 SIMD 内核
+// 只处理连续存放的 int / unsigned int / float, 由 li_algorithm.h 中的 dispatch 选用;
+// 另有哈希表控制字节的匹配和长字节串哈希的累加 (li_hashtable.hpp, li_functional.h)
+// x86 上 SSE2 为基础版本, 运行时检测到 AVX2 时改用 256 位版本; 其他平台退回普通循环
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define __LI_SIMD_X86 1
+#include <immintrin.h>
+// 单独为某个函数打开 AVX2 指令, 不影响其余代码的编译选项
+#define __LI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace LI {
+
+    // 哪些型别可以使用 SIMD 内核
+    // has_simd_equal: find / count (按位相等 或 IEEE 相等)
+    // has_simd_order: min / max (浮点数因 NaN 的比较语义不同, 不使用)
+    // has_simd_sum:   accumulate (浮点加法不满足结合律, 不使用)
+    template <class T>
+    struct __simd_traits {
+        typedef __false_type has_simd_equal;
+        typedef __false_type has_simd_order;
+        typedef __false_type has_simd_sum;
+    };
+    template <>
+    struct __simd_traits<int> {
+        typedef __true_type has_simd_equal;
+        typedef __true_type has_simd_order;
+        typedef __true_type has_simd_sum;
+    };
+    template <>
+    struct __simd_traits<unsigned int> {
+        typedef __true_type has_simd_equal;
+        typedef __true_type has_simd_order;
+        typedef __true_type has_simd_sum;
+    };
+    template <>
+    struct __simd_traits<float> {
+        typedef __true_type  has_simd_equal;
+        typedef __false_type has_simd_order;
+        typedef __false_type has_simd_sum;
+    };
+
+    // 运行时检测 CPU 是否支持 AVX2, 只检测一次
+    inline bool __cpu_has_avx2() {
+#if defined(__LI_SIMD_X86)
+        static const bool has_avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+        return has_avx2;
+#else
+        return false;
+#endif
+    }
+
+    // 取得掩码中最低 / 最高位的序号 (mask != 0)
+    inline int __lowest_bit(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(mask);
+#else
+        int n = 0;
+        while (!(mask & 1u)) { mask >>= 1; ++n; }
+        return n;
+#endif
+    }
+    inline int __highest_bit(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 31 - __builtin_clz(mask);
+#else
+        int n = 0;
+        while (mask >>= 1) ++n;
+        return n;
+#endif
+    }
+    inline int __popcount(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcount(mask);
+#else
+        int n = 0;
+        for ( ; mask; mask &= mask - 1) ++n;
+        return n;
+#endif
+    }
+
+
+    // 普通循环版本, 处理尾部元素 或 在没有 SIMD 的平台上使用 ---------------------
+    template <class T>
+    inline const T* __find_scalar(const T* first, const T* last, T value) {
+        for ( ; first != last; ++first) {
+            if (*first == value) return first;
+        }
+        return last;
+    }
+    template <class T>
+    inline const T* __find_last_scalar(const T* first, const T* last, T value) {
+        for (const T* p = last; p != first; ) {
+            if (*--p == value) return p;
+        }
+        return last;
+    }
+    template <class T>
+    inline ptrdiff_t __count_scalar(const T* first, const T* last, T value) {
+        ptrdiff_t n = 0;
+        for ( ; first != last; ++first) {
+            n += (*first == value);
+        }
+        return n;
+    }
+    template <class T>
+    inline ptrdiff_t __count_less_scalar(const T* first, const T* last, T value) {
+        ptrdiff_t n = 0;
+        for ( ; first != last; ++first) {
+            n += (*first < value);
+        }
+        return n;
+    }
+    // 区间非空
+    template <class T>
+    inline void __minmax_scalar(const T* first, const T* last, T& min_value, T& max_value) {
+        for ( ; first != last; ++first) {
+            if (*first < min_value) min_value = *first;
+            if (max_value < *first) max_value = *first;
+        }
+    }
+    template <class T>
+    inline T __sum_scalar(const T* first, const T* last, T init) {
+        for ( ; first != last; ++first) {
+            init = init + *first;
+        }
+        return init;
+    }
+    // 两个严格递增序列的交集, 结果写入 result, 返回结果的尾端
+    template <class T>
+    inline T* __intersect_unique_scalar(const T* first1, const T* last1, const T* first2, const T* last2, T* result) {
+        while (first1 != last1 && first2 != last2) {
+            if (*first1 < *first2) ++first1;
+            else if (*first2 < *first1) ++first2;
+            else {
+                *result++ = *first1;
+                ++first1;
+                ++first2;
+            }
+        }
+        return result;
+    }
+
+
+#if defined(__LI_SIMD_X86)
+    // AVX2 版本, 每次处理 8 个 32 位元素 ------------------------------------------
+
+    __LI_TARGET_AVX2 inline const int* __find_i32_avx2(const int* first, const int* last, int value) {
+        const __m256i v = _mm256_set1_epi32(value);
+        for ( ; last - first >= 8; first += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) first);
+            unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+            if (mask) return first + __lowest_bit(mask);
+        }
+        return __find_scalar(first, last, value);
+    }
+    __LI_TARGET_AVX2 inline const int* __find_last_i32_avx2(const int* first, const int* last, int value) {
+        const __m256i v = _mm256_set1_epi32(value);
+        const int* p = last;
+        for ( ; p - first >= 8; p -= 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) (p - 8));
+            unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v)));
+            if (mask) return p - 8 + __highest_bit(mask);
+        }
+        const int* result = __find_last_scalar(first, p, value);
+        return result == p ? last : result;
+    }
+    __LI_TARGET_AVX2 inline ptrdiff_t __count_i32_avx2(const int* first, const int* last, int value) {
+        const __m256i v = _mm256_set1_epi32(value);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 8; first += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*) first);
+            n += __popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v))));
+        }
+        return n + __count_scalar(first, last, value);
+    }
+    // 统计小于 value 的元素个数; 无符号数先与 bias (0x80000000) 异或, 转成有符号数的比较
+    __LI_TARGET_AVX2 inline ptrdiff_t __count_less_i32_avx2(const int* first, const int* last, int value, int bias) {
+        const __m256i b = _mm256_set1_epi32(bias);
+        const __m256i v = _mm256_set1_epi32(value ^ bias);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 8; first += 8) {
+            __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) first), b);
+            n += __popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, x))));
+        }
+        for ( ; first != last; ++first) {
+            n += ((*first ^ bias) < (value ^ bias));
+        }
+        return n;
+    }
+    __LI_TARGET_AVX2 inline const float* __find_f32_avx2(const float* first, const float* last, float value) {
+        const __m256 v = _mm256_set1_ps(value);
+        for ( ; last - first >= 8; first += 8) {
+            __m256 x = _mm256_loadu_ps(first);
+            unsigned int mask = _mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_EQ_OQ));
+            if (mask) return first + __lowest_bit(mask);
+        }
+        return __find_scalar(first, last, value);
+    }
+    __LI_TARGET_AVX2 inline ptrdiff_t __count_f32_avx2(const float* first, const float* last, float value) {
+        const __m256 v = _mm256_set1_ps(value);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 8; first += 8) {
+            __m256 x = _mm256_loadu_ps(first);
+            n += __popcount(_mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_EQ_OQ)));
+        }
+        return n + __count_scalar(first, last, value);
+    }
+    __LI_TARGET_AVX2 inline void __minmax_i32_avx2(const int* first, const int* last, int& min_value, int& max_value) {
+        if (last - first >= 8) {
+            __m256i vmin = _mm256_set1_epi32(min_value);
+            __m256i vmax = _mm256_set1_epi32(max_value);
+            for ( ; last - first >= 8; first += 8) {
+                __m256i x = _mm256_loadu_si256((const __m256i*) first);
+                vmin = _mm256_min_epi32(vmin, x);
+                vmax = _mm256_max_epi32(vmax, x);
+            }
+            int buf_min[8], buf_max[8];
+            _mm256_storeu_si256((__m256i*) buf_min, vmin);
+            _mm256_storeu_si256((__m256i*) buf_max, vmax);
+            __minmax_scalar(buf_min, buf_min + 8, min_value, max_value);
+            __minmax_scalar(buf_max, buf_max + 8, min_value, max_value);
+        }
+        __minmax_scalar(first, last, min_value, max_value);
+    }
+    __LI_TARGET_AVX2 inline void __minmax_u32_avx2(const unsigned int* first, const unsigned int* last, unsigned int& min_value, unsigned int& max_value) {
+        if (last - first >= 8) {
+            __m256i vmin = _mm256_set1_epi32(int(min_value));
+            __m256i vmax = _mm256_set1_epi32(int(max_value));
+            for ( ; last - first >= 8; first += 8) {
+                __m256i x = _mm256_loadu_si256((const __m256i*) first);
+                vmin = _mm256_min_epu32(vmin, x);
+                vmax = _mm256_max_epu32(vmax, x);
+            }
+            unsigned int buf_min[8], buf_max[8];
+            _mm256_storeu_si256((__m256i*) buf_min, vmin);
+            _mm256_storeu_si256((__m256i*) buf_max, vmax);
+            __minmax_scalar(buf_min, buf_min + 8, min_value, max_value);
+            __minmax_scalar(buf_max, buf_max + 8, min_value, max_value);
+        }
+        __minmax_scalar(first, last, min_value, max_value);
+    }
+    // 整数加法按 2 的补码回绕, 各通道分别累加后再合并, 结果与顺序累加相同
+    __LI_TARGET_AVX2 inline unsigned int __sum_u32_avx2(const unsigned int* first, const unsigned int* last, unsigned int init) {
+        __m256i acc = _mm256_setzero_si256();
+        for ( ; last - first >= 8; first += 8) {
+            acc = _mm256_add_epi32(acc, _mm256_loadu_si256((const __m256i*) first));
+        }
+        unsigned int buf[8];
+        _mm256_storeu_si256((__m256i*) buf, acc);
+        return __sum_scalar(first, last, __sum_scalar(buf, buf + 8, init));
+    }
+
+    // 两个严格递增序列的交集: 各取 8 个元素, 把 B 块循环移位 8 次与 A 块比较 (all-pairs),
+    // 得到 A 块中哪些元素出现在 B 块中; 之后块尾较小 (或相等) 的一方前进
+    __LI_TARGET_AVX2 inline unsigned int* __intersect_u32_avx2(const unsigned int* first1, const unsigned int* last1,
+                                                               const unsigned int* first2, const unsigned int* last2,
+                                                               unsigned int* result) {
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        while (last1 - first1 >= 8 && last2 - first2 >= 8) {
+            __m256i a = _mm256_loadu_si256((const __m256i*) first1);
+            __m256i b = _mm256_loadu_si256((const __m256i*) first2);
+            __m256i eq = _mm256_cmpeq_epi32(a, b);
+            for (int i = 1; i < 8; ++i) {
+                b = _mm256_permutevar8x32_epi32(b, rotate);
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, b));
+            }
+            unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            for ( ; mask; mask &= mask - 1) {
+                *result++ = first1[__lowest_bit(mask)];
+            }
+            unsigned int max1 = first1[7], max2 = first2[7];
+            if (max1 <= max2) first1 += 8;
+            if (max2 <= max1) first2 += 8;
+        }
+        return __intersect_unique_scalar(first1, last1, first2, last2, result);
+    }
+#endif
+
+#if defined(__SSE2__)
+    // SSE2 版本, 每次处理 4 个 32 位元素 ------------------------------------------
+
+    inline const int* __find_i32_sse2(const int* first, const int* last, int value) {
+        const __m128i v = _mm_set1_epi32(value);
+        for ( ; last - first >= 4; first += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*) first);
+            unsigned int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v)));
+            if (mask) return first + __lowest_bit(mask);
+        }
+        return __find_scalar(first, last, value);
+    }
+    inline const int* __find_last_i32_sse2(const int* first, const int* last, int value) {
+        const __m128i v = _mm_set1_epi32(value);
+        const int* p = last;
+        for ( ; p - first >= 4; p -= 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*) (p - 4));
+            unsigned int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v)));
+            if (mask) return p - 4 + __highest_bit(mask);
+        }
+        const int* result = __find_last_scalar(first, p, value);
+        return result == p ? last : result;
+    }
+    inline ptrdiff_t __count_i32_sse2(const int* first, const int* last, int value) {
+        const __m128i v = _mm_set1_epi32(value);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 4; first += 4) {
+            __m128i x = _mm_loadu_si128((const __m128i*) first);
+            n += __popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, v))));
+        }
+        return n + __count_scalar(first, last, value);
+    }
+    inline ptrdiff_t __count_less_i32_sse2(const int* first, const int* last, int value, int bias) {
+        const __m128i b = _mm_set1_epi32(bias);
+        const __m128i v = _mm_set1_epi32(value ^ bias);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 4; first += 4) {
+            __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*) first), b);
+            n += __popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, x))));
+        }
+        for ( ; first != last; ++first) {
+            n += ((*first ^ bias) < (value ^ bias));
+        }
+        return n;
+    }
+    inline const float* __find_f32_sse2(const float* first, const float* last, float value) {
+        const __m128 v = _mm_set1_ps(value);
+        for ( ; last - first >= 4; first += 4) {
+            unsigned int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first), v));
+            if (mask) return first + __lowest_bit(mask);
+        }
+        return __find_scalar(first, last, value);
+    }
+    inline ptrdiff_t __count_f32_sse2(const float* first, const float* last, float value) {
+        const __m128 v = _mm_set1_ps(value);
+        ptrdiff_t n = 0;
+        for ( ; last - first >= 4; first += 4) {
+            n += __popcount(_mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(first), v)));
+        }
+        return n + __count_scalar(first, last, value);
+    }
+    // SSE2 没有 32 位的 min / max 指令, 用比较结果做掩码选择
+    // bias 为 0x80000000 时把无符号数映射为有符号数再比较
+    inline void __minmax_32_sse2(const int* first, const int* last, int& min_value, int& max_value, int bias) {
+        if (last - first >= 4) {
+            const __m128i vbias = _mm_set1_epi32(bias);
+            __m128i vmin = _mm_set1_epi32(min_value ^ bias);
+            __m128i vmax = _mm_set1_epi32(max_value ^ bias);
+            for ( ; last - first >= 4; first += 4) {
+                __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*) first), vbias);
+                __m128i lt = _mm_cmplt_epi32(x, vmin);
+                __m128i gt = _mm_cmpgt_epi32(x, vmax);
+                vmin = _mm_or_si128(_mm_and_si128(lt, x), _mm_andnot_si128(lt, vmin));
+                vmax = _mm_or_si128(_mm_and_si128(gt, x), _mm_andnot_si128(gt, vmax));
+            }
+            int buf_min[4], buf_max[4];
+            _mm_storeu_si128((__m128i*) buf_min, vmin);
+            _mm_storeu_si128((__m128i*) buf_max, vmax);
+            int mn = min_value ^ bias, mx = max_value ^ bias;
+            __minmax_scalar(buf_min, buf_min + 4, mn, mx);
+            __minmax_scalar(buf_max, buf_max + 4, mn, mx);
+            min_value = mn ^ bias;
+            max_value = mx ^ bias;
+        }
+        // 尾部元素在调用端按原型别处理
+    }
+    inline unsigned int __sum_u32_sse2(const unsigned int* first, const unsigned int* last, unsigned int init) {
+        __m128i acc = _mm_setzero_si128();
+        for ( ; last - first >= 4; first += 4) {
+            acc = _mm_add_epi32(acc, _mm_loadu_si128((const __m128i*) first));
+        }
+        unsigned int buf[4];
+        _mm_storeu_si128((__m128i*) buf, acc);
+        return __sum_scalar(first, last, __sum_scalar(buf, buf + 4, init));
+    }
+
+    // 同上, 每次各取 4 个元素, B 块移位 3 次
+    inline unsigned int* __intersect_u32_sse2(const unsigned int* first1, const unsigned int* last1,
+                                              const unsigned int* first2, const unsigned int* last2,
+                                              unsigned int* result) {
+        while (last1 - first1 >= 4 && last2 - first2 >= 4) {
+            __m128i a = _mm_loadu_si128((const __m128i*) first1);
+            __m128i b = _mm_loadu_si128((const __m128i*) first2);
+            __m128i eq = _mm_cmpeq_epi32(a, b);
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1))));
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2))));
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3))));
+            unsigned int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+            for ( ; mask; mask &= mask - 1) {
+                *result++ = first1[__lowest_bit(mask)];
+            }
+            unsigned int max1 = first1[3], max2 = first2[3];
+            if (max1 <= max2) first1 += 4;
+            if (max2 <= max1) first2 += 4;
+        }
+        return __intersect_unique_scalar(first1, last1, first2, last2, result);
+    }
+#endif
+
+
+    // 对外的内核接口, 运行时选择实现 ----------------------------------------------
+
+    // 返回第一个等于 value 的位置, 没有则返回 last
+    inline const int* __simd_find(const int* first, const int* last, int value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __find_i32_avx2(first, last, value);
+#endif
+#if defined(__SSE2__)
+        return __find_i32_sse2(first, last, value);
+#else
+        return __find_scalar(first, last, value);
+#endif
+    }
+    inline const unsigned int* __simd_find(const unsigned int* first, const unsigned int* last, unsigned int value) {
+        const int* result = __simd_find((const int*) first, (const int*) last, int(value));
+        return first + (result - (const int*) first);
+    }
+    inline const float* __simd_find(const float* first, const float* last, float value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __find_f32_avx2(first, last, value);
+#endif
+#if defined(__SSE2__)
+        return __find_f32_sse2(first, last, value);
+#else
+        return __find_scalar(first, last, value);
+#endif
+    }
+
+    // 返回最后一个等于 value 的位置, 没有则返回 last
+    inline const int* __simd_find_last(const int* first, const int* last, int value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __find_last_i32_avx2(first, last, value);
+#endif
+#if defined(__SSE2__)
+        return __find_last_i32_sse2(first, last, value);
+#else
+        return __find_last_scalar(first, last, value);
+#endif
+    }
+    inline const unsigned int* __simd_find_last(const unsigned int* first, const unsigned int* last, unsigned int value) {
+        const int* result = __simd_find_last((const int*) first, (const int*) last, int(value));
+        return first + (result - (const int*) first);
+    }
+
+    // 统计等于 value 的元素个数
+    inline ptrdiff_t __simd_count(const int* first, const int* last, int value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __count_i32_avx2(first, last, value);
+#endif
+#if defined(__SSE2__)
+        return __count_i32_sse2(first, last, value);
+#else
+        return __count_scalar(first, last, value);
+#endif
+    }
+    inline ptrdiff_t __simd_count(const unsigned int* first, const unsigned int* last, unsigned int value) {
+        return __simd_count((const int*) first, (const int*) last, int(value));
+    }
+    inline ptrdiff_t __simd_count(const float* first, const float* last, float value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __count_f32_avx2(first, last, value);
+#endif
+#if defined(__SSE2__)
+        return __count_f32_sse2(first, last, value);
+#else
+        return __count_scalar(first, last, value);
+#endif
+    }
+
+    // 统计小于 value 的元素个数, 对有序区间即为 lower_bound 的位置
+    inline ptrdiff_t __simd_count_less(const int* first, const int* last, int value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __count_less_i32_avx2(first, last, value, 0);
+#endif
+#if defined(__SSE2__)
+        return __count_less_i32_sse2(first, last, value, 0);
+#else
+        return __count_less_scalar(first, last, value);
+#endif
+    }
+    inline ptrdiff_t __simd_count_less(const unsigned int* first, const unsigned int* last, unsigned int value) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __count_less_i32_avx2((const int*) first, (const int*) last, int(value), int(0x80000000u));
+#endif
+#if defined(__SSE2__)
+        return __count_less_i32_sse2((const int*) first, (const int*) last, int(value), int(0x80000000u));
+#else
+        return __count_less_scalar(first, last, value);
+#endif
+    }
+
+    // 求区间的最小值和最大值, 区间必须非空
+    inline void __simd_minmax(const int* first, const int* last, int& min_value, int& max_value) {
+        min_value = max_value = *first;
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) {
+            __minmax_i32_avx2(first, last, min_value, max_value);
+            return;
+        }
+#endif
+#if defined(__SSE2__)
+        __minmax_32_sse2(first, last, min_value, max_value, 0);
+        first += (last - first) & ~ptrdiff_t(3);
+#endif
+        __minmax_scalar(first, last, min_value, max_value);
+    }
+    inline void __simd_minmax(const unsigned int* first, const unsigned int* last, unsigned int& min_value, unsigned int& max_value) {
+        min_value = max_value = *first;
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) {
+            __minmax_u32_avx2(first, last, min_value, max_value);
+            return;
+        }
+#endif
+#if defined(__SSE2__)
+        int mn = int(min_value), mx = int(max_value);
+        __minmax_32_sse2((const int*) first, (const int*) last, mn, mx, int(0x80000000u));
+        min_value = (unsigned int) mn;
+        max_value = (unsigned int) mx;
+        first += (last - first) & ~ptrdiff_t(3);
+#endif
+        __minmax_scalar(first, last, min_value, max_value);
+    }
+
+    // 求和, 按 2 的补码回绕
+    inline unsigned int __simd_sum(const unsigned int* first, const unsigned int* last, unsigned int init) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __sum_u32_avx2(first, last, init);
+#endif
+#if defined(__SSE2__)
+        return __sum_u32_sse2(first, last, init);
+#else
+        return __sum_scalar(first, last, init);
+#endif
+    }
+    inline int __simd_sum(const int* first, const int* last, int init) {
+        return int(__simd_sum((const unsigned int*) first, (const unsigned int*) last, (unsigned int) init));
+    }
+
+    // 两个严格递增 (无重复) 序列的交集, 返回结果的尾端
+    inline unsigned int* __simd_intersect_unique(const unsigned int* first1, const unsigned int* last1,
+                                                 const unsigned int* first2, const unsigned int* last2,
+                                                 unsigned int* result) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __intersect_u32_avx2(first1, last1, first2, last2, result);
+#endif
+#if defined(__SSE2__)
+        return __intersect_u32_sse2(first1, last1, first2, last2, result);
+#else
+        return __intersect_unique_scalar(first1, last1, first2, last2, result);
+#endif
+    }
+
+
+    // 哈希表的控制字节组 (16 个), 返回的掩码第 i 位对应第 i 个字节 -----------------
+    // 等于 b 的字节
+    inline unsigned int __group_match_byte(const signed char* group, signed char b) {
+#if defined(__SSE2__)
+        __m128i g = _mm_loadu_si128((const __m128i*) group);
+        return (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(b)));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < 16; ++i) {
+            mask |= (unsigned int) (group[i] == b) << i;
+        }
+        return mask;
+#endif
+    }
+    // 最高位为 1 (负数) 的字节
+    inline unsigned int __group_match_negative(const signed char* group) {
+#if defined(__SSE2__)
+        return (unsigned int) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+#else
+        unsigned int mask = 0;
+        for (int i = 0; i < 16; ++i) {
+            mask |= (unsigned int) (group[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+    // 长字节串哈希的累加 (xxh3 的方式) ------------------------------------------
+    // 8 个 64 位累加器, 每条 64 字节: 第 i 个 64 位字 v 与密钥异或得 k,
+    // acc[i] += k 的低 32 位 * 高 32 位, acc[i ^ 1] += v (保留原始数据, 乘积为 0 时也不丢失信息)
+    // 第 s 条使用的密钥从 key[s % 8] 开始, 每 8 条 (512 字节) 以 key[8..15] 搅乱一次累加器
+    // 三个版本的结果完全相同
+    template <bool Dummy>
+    struct __hash_secret {
+        static const uint64_t key[16];
+    };
+    template <bool Dummy>
+    const uint64_t __hash_secret<Dummy>::key[16] = {
+        0xc0e16b163a85a4dcull, 0x890acd8dd443c47cull, 0xb3889d8a6dc47761ull, 0x6a0398e528f0ae6aull,
+        0x048344ece48a855eull, 0xf175cfea21871330ull, 0x391ceef02702c2fdull, 0x4baf8cac4784cb12ull,
+        0x3547744583a3f88eull, 0xd9cf2b15c6b6c90eull, 0x961facc76d5fe21cull, 0x0094ab49d50f11f9ull,
+        0xe3211e37bdbeb6dcull, 0x62fe6c274ff3511aull, 0x5ac30b329fdf0574ull, 0x1450582c6b65b406ull
+    };
+    const uint32_t __hash_scramble_prime = 0x9E3779B1u;
+
+    inline void __hash_stripe_scalar(uint64_t* acc, const unsigned char* p, const uint64_t* key) {
+        for (int i = 0; i < 8; ++i) {
+            uint64_t v;
+            memcpy(&v, p + 8 * i, 8);
+            uint64_t k = v ^ key[i];
+            acc[i ^ 1] += v;
+            acc[i] += (k & 0xffffffffu) * (k >> 32);
+        }
+    }
+    inline void __hash_scramble_scalar(uint64_t* acc, const uint64_t* key) {
+        for (int i = 0; i < 8; ++i) {
+            uint64_t a = acc[i];
+            a ^= a >> 47;
+            a ^= key[i];
+            acc[i] = a * __hash_scramble_prime;
+        }
+    }
+    inline void __hash_stripes_scalar(uint64_t* acc, const unsigned char* p, size_t n) {
+        const uint64_t* secret = __hash_secret<true>::key;
+        for (size_t s = 0; s < n; ++s, p += 64) {
+            __hash_stripe_scalar(acc, p, secret + (s & 7));
+            if ((s & 7) == 7) __hash_scramble_scalar(acc, secret + 8);
+        }
+    }
+
+#if defined(__SSE2__)
+    // _mm_mul_epu32 取每个 64 位元素的低 32 位相乘; 64 位乘 32 位常数拆成高低两半再相加
+    inline void __hash_stripes_sse2(uint64_t* acc, const unsigned char* p, size_t n) {
+        const uint64_t* secret = __hash_secret<true>::key;
+        const __m128i prime = _mm_set1_epi32((int) __hash_scramble_prime);
+        __m128i a[4];
+        for (int i = 0; i < 4; ++i) a[i] = _mm_loadu_si128((const __m128i*) (acc + 2 * i));
+        for (size_t s = 0; s < n; ++s, p += 64) {
+            const uint64_t* key = secret + (s & 7);
+            for (int i = 0; i < 4; ++i) {
+                __m128i v = _mm_loadu_si128((const __m128i*) (p + 16 * i));
+                __m128i k = _mm_xor_si128(v, _mm_loadu_si128((const __m128i*) (key + 2 * i)));
+                __m128i prod = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+                a[i] = _mm_add_epi64(a[i], _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+                a[i] = _mm_add_epi64(a[i], prod);
+            }
+            if ((s & 7) == 7) {
+                for (int i = 0; i < 4; ++i) {
+                    __m128i x = _mm_xor_si128(a[i], _mm_srli_epi64(a[i], 47));
+                    x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i*) (secret + 8 + 2 * i)));
+                    __m128i lo = _mm_mul_epu32(x, prime);
+                    __m128i hi = _mm_mul_epu32(_mm_srli_epi64(x, 32), prime);
+                    a[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+                }
+            }
+        }
+        for (int i = 0; i < 4; ++i) _mm_storeu_si128((__m128i*) (acc + 2 * i), a[i]);
+    }
+#endif
+
+#if defined(__LI_SIMD_X86)
+    __LI_TARGET_AVX2 inline void __hash_stripes_avx2(uint64_t* acc, const unsigned char* p, size_t n) {
+        const uint64_t* secret = __hash_secret<true>::key;
+        const __m256i prime = _mm256_set1_epi32((int) __hash_scramble_prime);
+        __m256i a[2];
+        for (int i = 0; i < 2; ++i) a[i] = _mm256_loadu_si256((const __m256i*) (acc + 4 * i));
+        for (size_t s = 0; s < n; ++s, p += 64) {
+            const uint64_t* key = secret + (s & 7);
+            for (int i = 0; i < 2; ++i) {
+                __m256i v = _mm256_loadu_si256((const __m256i*) (p + 32 * i));
+                __m256i k = _mm256_xor_si256(v, _mm256_loadu_si256((const __m256i*) (key + 4 * i)));
+                __m256i prod = _mm256_mul_epu32(k, _mm256_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+                a[i] = _mm256_add_epi64(a[i], _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+                a[i] = _mm256_add_epi64(a[i], prod);
+            }
+            if ((s & 7) == 7) {
+                for (int i = 0; i < 2; ++i) {
+                    __m256i x = _mm256_xor_si256(a[i], _mm256_srli_epi64(a[i], 47));
+                    x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i*) (secret + 8 + 4 * i)));
+                    __m256i lo = _mm256_mul_epu32(x, prime);
+                    __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), prime);
+                    a[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+                }
+            }
+        }
+        for (int i = 0; i < 2; ++i) _mm256_storeu_si256((__m256i*) (acc + 4 * i), a[i]);
+    }
+#endif
+
+    // 把 n 条 (每条 64 字节) 累加进 acc[8]
+    inline void __simd_hash_stripes(uint64_t* acc, const unsigned char* p, size_t n) {
+#if defined(__LI_SIMD_X86)
+        if (__cpu_has_avx2()) return __hash_stripes_avx2(acc, p, n);
+#endif
+#if defined(__SSE2__)
+        __hash_stripes_sse2(acc, p, n);
+#else
+        __hash_stripes_scalar(acc, p, n);
+#endif
+    }
+
+}
+
+#endif
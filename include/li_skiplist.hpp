@@ -0,0 +1,400 @@
+#ifndef LI_SKIPLIST_H_
+#define LI_SKIPLIST_H_
+
+#include <atomic>
+#include <stdint.h>
+#include "li_epoch.h"
+#include "li_thread_alloc.h"
+#include "li_construct.h"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_iterator.h"
+
+
+// skiplist_map: 无锁的有序 map, 多个线程可以同时插入、删除和查找, 互相之间不加锁
+// 每个节点有 1 ~ MAX_LEVEL 层后继指针, 第 0 层是包含所有元素的有序链表, 第 i 层大约是第 i - 1 层的 1/4
+// 删除分为两步: 先在后继指针的最低位打上删除标记 (逻辑删除, 之后的 CAS 都不会修改它), 再从各层链表中摘下
+// 摘下的节点可能仍在被其他线程读取, 交给 epoch_guard 的纪元回收 (li_epoch.h), 所有线程离开之后才释放
+// 迭代器和 insert 返回的迭代器只在持有 epoch_guard 的期间有效; 元素插入之后不再修改
+// 节点默认由 thread_alloc 配置, 每个线程有自己的区块缓存, 配置节点时一般也不加锁
+namespace LI {
+
+    template <class Value>
+    struct __skiplist_node : public __ebr_node {
+        typedef std::atomic<uintptr_t> link_type; // 后继指针, 最低位为 1 表示本节点已被删除
+
+        Value value; // 头节点不构造
+        int height;
+        std::atomic<int> refs; // 插入者和删除者各持有一份, 都放弃之后才交给纪元回收
+        // 之后紧跟 height 个 link_type
+
+        link_type* next() { return reinterpret_cast<link_type*>(this + 1); }
+
+        static size_t size(int h) { return sizeof(__skiplist_node) + h * sizeof(link_type); }
+        static __skiplist_node* ptr(uintptr_t link) { return reinterpret_cast<__skiplist_node*>(link & ~uintptr_t(1)); }
+        static bool marked(uintptr_t link) { return (link & 1) != 0; }
+    };
+
+    // 只读的前向迭代器, 沿第 0 层跳过已删除的节点
+    template <class Value>
+    struct __skiplist_iterator {
+        typedef forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Value* pointer;
+        typedef const Value& reference;
+        typedef __skiplist_node<Value> node;
+        typedef __skiplist_iterator<Value> self;
+
+        node* cur;
+
+        __skiplist_iterator() : cur(0) { }
+        explicit __skiplist_iterator(node* x) : cur(x) { }
+
+        reference operator*() const { return cur->value; }
+        pointer operator->() const { return &(operator*()); }
+        self& operator++() {
+            cur = node::ptr(cur->next()[0].load(std::memory_order_acquire));
+            while (cur != 0) {
+                uintptr_t succ = cur->next()[0].load(std::memory_order_acquire);
+                if (!node::marked(succ)) break;
+                cur = node::ptr(succ);
+            }
+            return *this;
+        }
+        self operator++(int) {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const self& x) const { return cur == x.cur; }
+        bool operator!=(const self& x) const { return cur != x.cur; }
+    };
+
+    template <class Key, class T, class Compare = less<Key>, class Alloc = thread_alloc>
+    class skiplist_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+        typedef Compare key_compare;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+        typedef const value_type& const_reference;
+        typedef __skiplist_iterator<value_type> const_iterator;
+        typedef const_iterator iterator; // 元素不可修改
+
+        enum { MAX_LEVEL = 16 }; // 每层约为下一层的 1/4, 足够 2^32 个元素
+
+    private:
+        typedef __skiplist_node<value_type> node;
+        typedef typename node::link_type link_type;
+
+        node* head; // 有 MAX_LEVEL 层, 不含元素
+        std::atomic<int> top; // 当前用到的层数, 查找从这一层开始
+        std::atomic<size_type> node_count;
+        Compare comp;
+
+        static const Key& key(node* x) { return x->value.first; }
+
+        // 随机层数: 每多一层的概率为 1/4, 随机数由每个线程自己的 xorshift 产生
+        static int __random_level() {
+            static thread_local uint32_t seed = 0;
+            if (seed == 0) {
+                seed = uint32_t(__hash_fmix(uint64_t(uintptr_t(&seed)))) | 1;
+            }
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            uint32_t r = seed;
+            int h = 1;
+            while (h < MAX_LEVEL && (r & 3) == 0) {
+                ++h;
+                r >>= 2;
+            }
+            return h;
+        }
+
+        // 构造一个 h 层的节点, 参数原样转交给元素的构造函数
+        template <class... Args>
+        static node* __create_node(int h, Args&&... args) {
+            node* x = (node*) Alloc::allocate(node::size(h));
+            try {
+                construct(&x->value, LI::forward<Args>(args)...);
+            }
+            catch(...) {
+                Alloc::deallocate(x, node::size(h));
+                throw;
+            }
+            x->height = h;
+            new (&x->refs) std::atomic<int>(2);
+            for (int i = 0; i < h; ++i) {
+                new (&x->next()[i]) link_type(0);
+            }
+            return x;
+        }
+        static void __reclaim(__ebr_node* p) {
+            node* x = static_cast<node*>(p);
+            destroy(&x->value);
+            Alloc::deallocate(x, node::size(x->height));
+        }
+        // 插入者和删除者都放弃节点之后, 它已从各层摘下, 交给纪元回收
+        static void __release(node* x) {
+            if (x->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                __ebr_retire(x, &__reclaim);
+            }
+        }
+
+        // 找出每一层上最后一个小于 k 的节点 preds 和它的后继 succs, 途中摘下已删除的节点
+        // 返回 succs[0] 的键值是否等于 k; 须在临界区内调用
+        bool __find(const key_type& k, node** preds, node** succs) {
+        retry:
+            int t = top.load(std::memory_order_acquire);
+            for (int l = MAX_LEVEL - 1; l >= t; --l) {
+                preds[l] = head;
+                succs[l] = 0; // 之后若有节点升到这一层, 链入时的 CAS 会失败并重新查找
+            }
+            node* pred = head;
+            for (int l = t - 1; l >= 0; --l) {
+                node* curr = node::ptr(pred->next()[l].load(std::memory_order_acquire));
+                while (curr != 0) {
+                    uintptr_t succ = curr->next()[l].load(std::memory_order_acquire);
+                    if (node::marked(succ)) {
+                        uintptr_t expected = uintptr_t(curr);
+                        if (!pred->next()[l].compare_exchange_strong(expected, succ & ~uintptr_t(1))) {
+                            goto retry; // pred 也被删除或其后继已变
+                        }
+                        curr = node::ptr(succ);
+                        continue;
+                    }
+                    if (!comp(key(curr), k)) break;
+                    pred = curr;
+                    curr = node::ptr(succ);
+                }
+                preds[l] = pred;
+                succs[l] = curr;
+            }
+            return succs[0] != 0 && !comp(k, key(succs[0]));
+        }
+
+        // 只读的查找, 不修改链表: 第 0 层上第一个未删除、且不小于 k (upper 时大于 k) 的节点
+        node* __search(const key_type& k, bool upper) const {
+            node* pred = head;
+            node* curr = 0;
+            for (int l = top.load(std::memory_order_acquire) - 1; l >= 0; --l) {
+                curr = node::ptr(pred->next()[l].load(std::memory_order_acquire));
+                while (curr != 0) {
+                    uintptr_t succ = curr->next()[l].load(std::memory_order_acquire);
+                    if (node::marked(succ)) {
+                        curr = node::ptr(succ);
+                        continue;
+                    }
+                    if (upper ? comp(k, key(curr)) : !comp(key(curr), k)) break;
+                    pred = curr;
+                    curr = node::ptr(succ);
+                }
+            }
+            return curr;
+        }
+
+        // 从各层摘下键值为 k 的已删除节点, 返回时这些节点都已不可到达 (链入者放弃节点之前也会调用一次)
+        void __unlink(const key_type& k) {
+        retry:
+            node* pred = head;
+            for (int l = top.load(std::memory_order_acquire) - 1; l >= 0; --l) {
+                node* p = pred; // 键值等于 k 的未删除节点之后继续扫描, 但下降仍从 pred 开始
+                node* curr = node::ptr(p->next()[l].load(std::memory_order_acquire));
+                while (curr != 0) {
+                    uintptr_t succ = curr->next()[l].load(std::memory_order_acquire);
+                    if (node::marked(succ)) {
+                        uintptr_t expected = uintptr_t(curr);
+                        if (!p->next()[l].compare_exchange_strong(expected, succ & ~uintptr_t(1))) {
+                            goto retry;
+                        }
+                        curr = node::ptr(succ);
+                        continue;
+                    }
+                    if (comp(key(curr), k)) {
+                        pred = p = curr;
+                    }
+                    else if (!comp(k, key(curr))) {
+                        p = curr;
+                    }
+                    else {
+                        break;
+                    }
+                    curr = node::ptr(succ);
+                }
+            }
+        }
+
+        // 插入键值为 k 的节点, 不存在时才由 make 构造 (只构造一次)
+        template <class Make>
+        pair<const_iterator, bool> __insert(const key_type& k, Make make) {
+            epoch_guard guard;
+            node* preds[MAX_LEVEL];
+            node* succs[MAX_LEVEL];
+            node* x = 0;
+            for (;;) {
+                if (__find(k, preds, succs)) {
+                    if (x != 0) __reclaim(x); // 未发布过, 直接释放
+                    return pair<const_iterator, bool>(const_iterator(succs[0]), false);
+                }
+                if (x == 0) {
+                    x = make();
+                    int t = top.load(std::memory_order_relaxed);
+                    while (x->height > t && !top.compare_exchange_weak(t, x->height)) { }
+                }
+                for (int i = 0; i < x->height; ++i) {
+                    x->next()[i].store(uintptr_t(succs[i]), std::memory_order_relaxed);
+                }
+                // 链入第 0 层即插入成功
+                uintptr_t expected = uintptr_t(succs[0]);
+                if (preds[0]->next()[0].compare_exchange_strong(expected, uintptr_t(x))) break;
+            }
+            node_count.fetch_add(1, std::memory_order_relaxed);
+            // 自下而上链入其余各层, 节点被删除 (后继已打标记) 时停止
+            for (int i = 1; i < x->height; ++i) {
+                for (;;) {
+                    uintptr_t old = x->next()[i].load(std::memory_order_acquire);
+                    if (node::marked(old)) goto done;
+                    if (old != uintptr_t(succs[i]) &&
+                        !x->next()[i].compare_exchange_strong(old, uintptr_t(succs[i]))) {
+                        goto done; // 这一层尚未链入, 只有删除者会修改它
+                    }
+                    uintptr_t expected = uintptr_t(succs[i]);
+                    if (preds[i]->next()[i].compare_exchange_strong(expected, uintptr_t(x))) break;
+                    __find(k, preds, succs);
+                }
+            }
+        done:
+            // 链入期间节点被删除, 删除者摘下时可能还没有链入的层要再摘一次
+            if (node::marked(x->next()[0].load(std::memory_order_acquire))) {
+                __unlink(k);
+            }
+            const_iterator result(x);
+            __release(x);
+            return pair<const_iterator, bool>(result, true);
+        }
+
+    public:
+        explicit skiplist_map(const Compare& c = Compare()) : top(1), node_count(0), comp(c) {
+            head = (node*) Alloc::allocate(node::size(MAX_LEVEL));
+            head->height = MAX_LEVEL;
+            for (int i = 0; i < MAX_LEVEL; ++i) {
+                new (&head->next()[i]) link_type(0);
+            }
+        }
+        template <class InputIterator>
+        skiplist_map(InputIterator first, InputIterator last, const Compare& c = Compare()) : skiplist_map(c) {
+            for ( ; first != last; ++first) {
+                insert(*first);
+            }
+        }
+        // 析构时不能有其他线程访问; 已摘下的节点由纪元回收释放
+        ~skiplist_map() {
+            node* x = node::ptr(head->next()[0].load(std::memory_order_acquire));
+            while (x != 0) {
+                node* next = node::ptr(x->next()[0].load(std::memory_order_relaxed));
+                __reclaim(x);
+                x = next;
+            }
+            Alloc::deallocate(head, node::size(MAX_LEVEL));
+        }
+        skiplist_map(const skiplist_map&) = delete;
+        skiplist_map& operator=(const skiplist_map&) = delete;
+
+        key_compare key_comp() const { return comp; }
+        // 并发修改时只是近似值
+        size_type size() const { return node_count.load(std::memory_order_relaxed); }
+        bool empty() const { return size() == 0; }
+        size_type max_size() const { return size_type(-1); }
+
+        // 以下迭代器只在持有 epoch_guard 时有效
+        const_iterator begin() const {
+            const_iterator it(head);
+            return ++it;
+        }
+        const_iterator end() const { return const_iterator(); }
+
+        pair<const_iterator, bool> insert(const value_type& v) {
+            return __insert(v.first, [&]() { return __create_node(__random_level(), v); });
+        }
+        pair<const_iterator, bool> insert(value_type&& v) {
+            return __insert(v.first, [&]() { return __create_node(__random_level(), LI::move(v)); });
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for ( ; first != last; ++first) {
+                insert(*first);
+            }
+        }
+        // 先构造节点再查找, 键值已存在时析构
+        template <class... Args>
+        pair<const_iterator, bool> emplace(Args&&... args) {
+            node* x = __create_node(__random_level(), LI::forward<Args>(args)...);
+            bool taken = false; // __insert 取走节点后, 键值已存在时由它释放
+            pair<const_iterator, bool> r = __insert(key(x), [x, &taken]() { taken = true; return x; });
+            if (!taken) __reclaim(x); // 第一次查找就找到了相同的键值, 节点从未交给 __insert
+            return r;
+        }
+        // 键值已存在时不构造元素
+        template <class... Args>
+        pair<const_iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+            return __insert(k, [&]() {
+                return __create_node(__random_level(), __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+            });
+        }
+
+        // 返回删除的元素个数; 多个线程同时删除同一键值时只有一个成功
+        size_type erase(const key_type& k) {
+            epoch_guard guard;
+            node* x = __search(k, false);
+            if (x == 0 || comp(k, key(x))) return 0;
+            // 自上而下打标记, 第 0 层的标记由谁打上, 就由谁完成删除
+            for (int i = x->height - 1; i >= 1; --i) {
+                x->next()[i].fetch_or(1);
+            }
+            if (node::marked(x->next()[0].fetch_or(1))) return 0;
+            node_count.fetch_sub(1, std::memory_order_relaxed);
+            __unlink(k);
+            __release(x);
+            return 1;
+        }
+        void erase(const_iterator position) { erase(position->first); }
+        // 其他线程同时插入的元素不一定被删除
+        void clear() {
+            epoch_guard guard;
+            for (const_iterator it = begin(); it != end(); ++it) {
+                erase(it->first);
+            }
+        }
+
+        const_iterator find(const key_type& k) const {
+            node* x = __search(k, false);
+            return (x == 0 || comp(k, key(x))) ? end() : const_iterator(x);
+        }
+        // 找到时复制出实值, 不需要调用者持有 epoch_guard
+        bool find(const key_type& k, T& result) const {
+            epoch_guard guard;
+            node* x = __search(k, false);
+            if (x == 0 || comp(k, key(x))) return false;
+            result = x->value.second;
+            return true;
+        }
+        size_type count(const key_type& k) const {
+            epoch_guard guard;
+            node* x = __search(k, false);
+            return (x == 0 || comp(k, key(x))) ? 0 : 1;
+        }
+        const_iterator lower_bound(const key_type& k) const { return const_iterator(__search(k, false)); }
+        const_iterator upper_bound(const key_type& k) const { return const_iterator(__search(k, true)); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+            return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
+        }
+    };
+
+}
+
+#endif
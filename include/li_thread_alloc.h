@@ -0,0 +1,116 @@
+#ifndef LI_THREAD_ALLOC_H_
+#define LI_THREAD_ALLOC_H_
+
+#include "li_alloc.h"
+
+// 带有每线程缓存的配置器
+// 每个线程为每种区块大小保留一个自己的 free list, 在本线程内配置和释放都不加锁;
+// 缓存空了才从共用的内存池 (threads_alloc) 一次取一批, 缓存过多时一次还回一半, 每批只加一次锁
+// 区块可以在一个线程配置, 在另一个线程释放 (进入释放者的缓存); 线程结束时缓存全部还回内存池
+// 接口与 alloc 相同, 可以作为 simple_alloc 和各容器的 Alloc
+namespace LI {
+
+    template <int inst>
+    class __thread_cache_alloc {
+    private:
+        typedef __default_alloc_template<true, inst> pool;
+        enum { BATCH = 32 }; // 一次从内存池取出的区块数
+        enum { MAX_CACHED = 128 }; // 每种大小最多缓存的区块数, 超过时还回一半
+
+        struct obj {
+            obj* next;
+        };
+        struct cache {
+            obj* list[__NFREELISTS];
+            int count[__NFREELISTS];
+            cache() {
+                for (int i = 0; i < __NFREELISTS; ++i) {
+                    list[i] = 0;
+                    count[i] = 0;
+                }
+            }
+            // 线程结束, 缓存的区块全部还回内存池
+            ~cache() {
+                for (int i = 0; i < __NFREELISTS; ++i) {
+                    if (list[i] != 0) {
+                        obj* last = list[i];
+                        while (last->next != 0) last = last->next;
+                        pool::deallocate_chain(list[i], last, (i + 1) * __ALIGN);
+                    }
+                }
+                destroyed() = true;
+            }
+        };
+
+        static size_t FREELIST_INDEX(size_t bytes) {
+            return (((bytes) + __ALIGN - 1) / __ALIGN - 1);
+        }
+        static cache& local() {
+            static thread_local cache c;
+            return c;
+        }
+        // 本线程的缓存已经析构 (线程退出时其他 thread_local 对象的析构函数还可能配置或释放), 此后直接使用内存池
+        static bool& destroyed() {
+            static thread_local bool d = false;
+            return d;
+        }
+
+    public:
+        static void* allocate(size_t n) {
+            if (n > (size_t) __MAX_BYTES) {
+                return malloc_alloc::allocate(n);
+            }
+            if (destroyed()) {
+                return pool::allocate(n);
+            }
+            cache& c = local();
+            size_t i = FREELIST_INDEX(n);
+            obj* result = c.list[i];
+            if (result == 0) {
+                int nobjs = BATCH;
+                result = (obj*) pool::allocate_chain((i + 1) * __ALIGN, nobjs);
+                c.count[i] = nobjs;
+            }
+            c.list[i] = result->next;
+            --c.count[i];
+            return result;
+        }
+
+        static void deallocate(void* p, size_t n) {
+            if (n > (size_t) __MAX_BYTES) {
+                malloc_alloc::deallocate(p, n);
+                return;
+            }
+            if (destroyed()) {
+                pool::deallocate(p, n);
+                return;
+            }
+            cache& c = local();
+            size_t i = FREELIST_INDEX(n);
+            obj* q = (obj*) p;
+            q->next = c.list[i];
+            c.list[i] = q;
+            if (++c.count[i] > MAX_CACHED) {
+                // 留下一半, 其余一次还回内存池
+                obj* last = q;
+                for (int k = 1; k < MAX_CACHED / 2; ++k) last = last->next;
+                obj* rest = last->next;
+                last->next = 0;
+                obj* rest_last = rest;
+                while (rest_last->next != 0) rest_last = rest_last->next;
+                pool::deallocate_chain(rest, rest_last, (i + 1) * __ALIGN);
+                c.count[i] = MAX_CACHED / 2;
+            }
+        }
+
+        // 一串区块直接还回内存池, 不经过缓存
+        static void deallocate_chain(void* first, void* last, size_t n) {
+            pool::deallocate_chain(first, last, n);
+        }
+    };
+
+    typedef __thread_cache_alloc<0> thread_alloc;
+
+}
+
+#endif
@@ -140,6 +140,48 @@ namespace LI {
         typedef __true_type   has_trivial_destructor;
         typedef __true_type   is_POD_type;
     };
+    // const 限定不改变型别的平凡性
+    template<class T>
+    struct __type_traits<const T> : public __type_traits<T> { };
+
+    // 任何型别都映射为 void, 用于在偏特化中检测某个嵌套型别是否存在
+    template <class T>
+    struct __void_type {
+        typedef void type;
+    };
+
+    // 两个标记的逻辑与, 用于组合型别 (如 pair) 的特性推导
+    template <class T1, class T2>
+    struct __and_type {
+        typedef __false_type type;
+    };
+    template <>
+    struct __and_type<__true_type, __true_type> {
+        typedef __true_type type;
+    };
+
+
+    // 判断是否为算术型别(整数和浮点数)
+    // 算术型别的比较没有副作用, 可以放心使用无分支 / 向量化的算法版本
+    template <class type>
+    struct __is_arithmetic {
+        typedef __false_type is_arithmetic;
+    };
+
+    template<> struct __is_arithmetic<char>               { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<signed char>        { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<unsigned char>      { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<short>              { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<unsigned short>     { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<int>                { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<unsigned int>       { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<long>               { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<unsigned long>      { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<long long>          { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<unsigned long long> { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<float>              { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<double>             { typedef __true_type is_arithmetic; };
+    template<> struct __is_arithmetic<long double>        { typedef __true_type is_arithmetic; };
 
 
 
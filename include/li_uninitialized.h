@@ -14,7 +14,7 @@ namespace LI {
     // 有 POD(Plain Old data) : 标量类型 或 C struct 型别 
     template<class InputIterator, class ForwardIterator>
     inline ForwardIterator __uninitialized_copy_aux(InputIterator first, InputIterator last, ForwardIterator result, __true_type) {
-        return copy(first, last, result); // 调用 copy 算法
+        return LI::copy(first, last, result); // 调用 copy 算法
     }
     // 有 non-POD
     template<class InputIterator, class ForwardIterator>
@@ -53,7 +53,7 @@ namespace LI {
     // POD 型别
     template <class ForwardIterator, class T>
     inline void __uninitialized_fill_aux(ForwardIterator first, ForwardIterator last, const T& x, __true_type) {
-        fill(first, last, x); // 调用 fill 算法
+        LI::fill(first, last, x); // 调用 fill 算法
     }
     // non-POD 型别
     template <class ForwardIterator, class T>
@@ -82,7 +82,7 @@ namespace LI {
     // POD 型别
     template <class ForwardIterator, class Size, class T>
     inline ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n, const T& x, __true_type) {
-        return fill_n(first, n, x); // 调用 fill_n 函数
+        return LI::fill_n(first, n, x); // 调用 fill_n 函数
     }
     // non-POD 型别
     template <class ForwardIterator, class Size, class T>
@@ -0,0 +1,141 @@
+#ifndef LI_UNORDERED_MAP_H_
+#define LI_UNORDERED_MAP_H_
+
+#include "li_hashtable.hpp"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+
+
+// unordered_map: 以开放定址的哈希表封装, 不保持键值的次序, 查找平均 O(1)
+// 元素直接存放在表中, 插入可能 rehash, 插入和删除都会使迭代器与元素的指针失效
+namespace LI {
+
+    template <class Key, class T, class HashFcn = hash<Key>, class EqualKey = equal_to<Key>, class Alloc = alloc>
+    class unordered_map {
+    public:
+        typedef Key key_type;
+        typedef T data_type;
+        typedef T mapped_type;
+        typedef pair<const Key, T> value_type;
+
+    private:
+        typedef hashtable<value_type, key_type, HashFcn, select1st<value_type>, EqualKey, Alloc> ht;
+        ht rep; // 底层的哈希表
+
+    public:
+        typedef typename ht::hasher hasher;
+        typedef typename ht::key_equal key_equal;
+        typedef typename ht::size_type size_type;
+        typedef typename ht::difference_type difference_type;
+        typedef typename ht::pointer pointer;
+        typedef typename ht::const_pointer const_pointer;
+        typedef typename ht::reference reference;
+        typedef typename ht::const_reference const_reference;
+        typedef typename ht::iterator iterator;
+        typedef typename ht::const_iterator const_iterator;
+
+        unordered_map() : rep(0, hasher(), key_equal()) { }
+        explicit unordered_map(size_type n, const hasher& hf = hasher(), const key_equal& eql = key_equal())
+            : rep(n, hf, eql) { }
+        template <class InputIterator>
+        unordered_map(InputIterator first, InputIterator last) : rep(0, hasher(), key_equal()) {
+            rep.insert_unique(first, last);
+        }
+
+        unordered_map(const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x) : rep(x.rep) { }
+        unordered_map(unordered_map<Key, T, HashFcn, EqualKey, Alloc>&& x) : rep(LI::move(x.rep)) { }
+
+        ~unordered_map() { }
+
+        unordered_map<Key, T, HashFcn, EqualKey, Alloc>& operator=(const unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x) {
+            rep = x.rep;
+            return *this;
+        }
+        unordered_map<Key, T, HashFcn, EqualKey, Alloc>& operator=(unordered_map<Key, T, HashFcn, EqualKey, Alloc>&& x) {
+            rep = LI::move(x.rep);
+            return *this;
+        }
+        void swap(unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x) { rep.swap(x.rep); }
+
+        hasher hash_function() const { return rep.hash_funct(); }
+        key_equal key_eq() const { return rep.key_eq(); }
+        iterator begin() { return rep.begin(); }
+        iterator end() { return rep.end(); }
+        const_iterator begin() const { return rep.begin(); }
+        const_iterator end() const { return rep.end(); }
+        bool empty() const { return rep.empty(); }
+        size_type size() const { return rep.size(); }
+        size_type max_size() const { return rep.max_size(); }
+        T& operator[] (const key_type& k) {
+            return (*try_emplace(k).first).second;
+        }
+        T& operator[] (key_type&& k) {
+            return (*try_emplace(LI::move(k)).first).second;
+        }
+
+        // 原地构造 ---------------------------------------------
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            return rep.emplace_unique(LI::forward<Args>(args)...);
+        }
+        // 键值不存在时才构造: first 由 k 构造, second 由 args 构造
+        template <class... Args>
+        pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+            return rep.try_emplace_unique(k, __piecewise_construct_t(), k, LI::forward<Args>(args)...);
+        }
+        template <class... Args>
+        pair<iterator, bool> try_emplace(key_type&& k, Args&&... args) {
+            return rep.try_emplace_unique(k, __piecewise_construct_t(), LI::move(k), LI::forward<Args>(args)...);
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(const key_type& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(k, LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+        template <class M>
+        pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj) {
+            pair<iterator, bool> r = try_emplace(LI::move(k), LI::forward<M>(obj));
+            if (!r.second) {
+                (*r.first).second = LI::forward<M>(obj);
+            }
+            return r;
+        }
+
+        pair<iterator, bool> insert(const value_type& x) { return rep.insert_unique(x); }
+        pair<iterator, bool> insert(value_type&& x) { return rep.insert_unique(LI::move(x)); }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { rep.insert_unique(first, last); }
+
+        // 返回下一个元素, 可以边遍历边删除
+        iterator erase(const_iterator position) { return rep.erase(position); }
+        size_type erase(const key_type& k) { return rep.erase(k); }
+        void clear() { rep.clear(); }
+
+        iterator find(const key_type& k) { return rep.find(k); }
+        const_iterator find(const key_type& k) const { return rep.find(k); }
+        size_type count(const key_type& k) const { return rep.count(k); }
+        pair<iterator, iterator> equal_range(const key_type& k) { return rep.equal_range(k); }
+        pair<const_iterator, const_iterator> equal_range(const key_type& k) const { return rep.equal_range(k); }
+
+        // 容量 ----------------------------------------------------
+        size_type bucket_count() const { return rep.bucket_count(); }
+        float load_factor() const { return rep.load_factor(); }
+        float max_load_factor() const { return rep.max_load_factor(); }
+        void max_load_factor(float f) { rep.max_load_factor(f); }
+        void rehash(size_type n) { rep.rehash(n); }
+        void reserve(size_type n) { rep.reserve(n); }
+    };
+
+    template <class Key, class T, class HashFcn, class EqualKey, class Alloc>
+    inline void swap(unordered_map<Key, T, HashFcn, EqualKey, Alloc>& x, unordered_map<Key, T, HashFcn, EqualKey, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
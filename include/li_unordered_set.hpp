@@ -0,0 +1,104 @@
+#ifndef LI_UNORDERED_SET_H_
+#define LI_UNORDERED_SET_H_
+
+#include "li_hashtable.hpp"
+#include "li_pair.h"
+#include "li_functional.h"
+#include "li_alloc.h"
+
+
+// unordered_set: 元素就是键值, 以 identity 取键值; 迭代器不能改变元素
+namespace LI {
+
+    template <class Value, class HashFcn = hash<Value>, class EqualKey = equal_to<Value>, class Alloc = alloc>
+    class unordered_set {
+    private:
+        typedef hashtable<Value, Value, HashFcn, identity<Value>, EqualKey, Alloc> ht;
+        ht rep;
+
+    public:
+        typedef typename ht::key_type key_type;
+        typedef typename ht::value_type value_type;
+        typedef typename ht::hasher hasher;
+        typedef typename ht::key_equal key_equal;
+        typedef typename ht::size_type size_type;
+        typedef typename ht::difference_type difference_type;
+        typedef typename ht::const_pointer pointer;
+        typedef typename ht::const_pointer const_pointer;
+        typedef typename ht::const_reference reference;
+        typedef typename ht::const_reference const_reference;
+        typedef typename ht::const_iterator iterator;
+        typedef typename ht::const_iterator const_iterator;
+
+        unordered_set() : rep(0, hasher(), key_equal()) { }
+        explicit unordered_set(size_type n, const hasher& hf = hasher(), const key_equal& eql = key_equal())
+            : rep(n, hf, eql) { }
+        template <class InputIterator>
+        unordered_set(InputIterator first, InputIterator last) : rep(0, hasher(), key_equal()) {
+            rep.insert_unique(first, last);
+        }
+
+        unordered_set(const unordered_set<Value, HashFcn, EqualKey, Alloc>& x) : rep(x.rep) { }
+        unordered_set(unordered_set<Value, HashFcn, EqualKey, Alloc>&& x) : rep(LI::move(x.rep)) { }
+
+        ~unordered_set() { }
+
+        unordered_set<Value, HashFcn, EqualKey, Alloc>& operator=(const unordered_set<Value, HashFcn, EqualKey, Alloc>& x) {
+            rep = x.rep;
+            return *this;
+        }
+        unordered_set<Value, HashFcn, EqualKey, Alloc>& operator=(unordered_set<Value, HashFcn, EqualKey, Alloc>&& x) {
+            rep = LI::move(x.rep);
+            return *this;
+        }
+        void swap(unordered_set<Value, HashFcn, EqualKey, Alloc>& x) { rep.swap(x.rep); }
+
+        hasher hash_function() const { return rep.hash_funct(); }
+        key_equal key_eq() const { return rep.key_eq(); }
+        iterator begin() const { return rep.begin(); }
+        iterator end() const { return rep.end(); }
+        bool empty() const { return rep.empty(); }
+        size_type size() const { return rep.size(); }
+        size_type max_size() const { return rep.max_size(); }
+
+        template <class... Args>
+        pair<iterator, bool> emplace(Args&&... args) {
+            pair<typename ht::iterator, bool> p = rep.emplace_unique(LI::forward<Args>(args)...);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        pair<iterator, bool> insert(const value_type& x) {
+            pair<typename ht::iterator, bool> p = rep.insert_unique(x);
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        pair<iterator, bool> insert(value_type&& x) {
+            pair<typename ht::iterator, bool> p = rep.insert_unique(LI::move(x));
+            return pair<iterator, bool>(p.first, p.second);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) { rep.insert_unique(first, last); }
+
+        iterator erase(const_iterator position) { return rep.erase(position); }
+        size_type erase(const key_type& k) { return rep.erase(k); }
+        void clear() { rep.clear(); }
+
+        iterator find(const key_type& k) const { return rep.find(k); }
+        size_type count(const key_type& k) const { return rep.count(k); }
+        pair<iterator, iterator> equal_range(const key_type& k) const { return rep.equal_range(k); }
+
+        size_type bucket_count() const { return rep.bucket_count(); }
+        float load_factor() const { return rep.load_factor(); }
+        float max_load_factor() const { return rep.max_load_factor(); }
+        void max_load_factor(float f) { rep.max_load_factor(f); }
+        void rehash(size_type n) { rep.rehash(n); }
+        void reserve(size_type n) { rep.reserve(n); }
+    };
+
+    template <class Value, class HashFcn, class EqualKey, class Alloc>
+    inline void swap(unordered_set<Value, HashFcn, EqualKey, Alloc>& x, unordered_set<Value, HashFcn, EqualKey, Alloc>& y) {
+        x.swap(y);
+    }
+
+}
+
+
+#endif
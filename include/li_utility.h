@@ -0,0 +1,55 @@
+#ifndef LI_UTILITY_H_
+#define LI_UTILITY_H_
+
+// 软件预取: 提前把 p 所在的缓存行载入缓存, 不影响程序语义
+#if defined(__GNUC__) || defined(__clang__)
+#define __LI_PREFETCH(p) __builtin_prefetch((const void*)(p))
+#else
+#define __LI_PREFETCH(p) ((void)0)
+#endif
+
+// 通用的小工具: 右值引用相关的 move / forward, 以及 swap
+namespace LI {
+
+    // 去掉型别上的引用
+    template <class T>
+    struct remove_reference {
+        typedef T type;
+    };
+    template <class T>
+    struct remove_reference<T&> {
+        typedef T type;
+    };
+    template <class T>
+    struct remove_reference<T&&> {
+        typedef T type;
+    };
+
+    // 把实参无条件地转换为右值, 使其可以被 "搬走"
+    template <class T>
+    inline typename remove_reference<T>::type&& move(T&& t) {
+        return static_cast<typename remove_reference<T>::type&&>(t);
+    }
+
+    // 完美转发: 实参原本是左值就转发为左值, 原本是右值就转发为右值
+    template <class T>
+    inline T&& forward(typename remove_reference<T>::type& t) {
+        return static_cast<T&&>(t);
+    }
+    template <class T>
+    inline T&& forward(typename remove_reference<T>::type&& t) {
+        return static_cast<T&&>(t);
+    }
+
+    // 交换两个对象的值
+    template <class T>
+    inline void swap(T& a, T& b) {
+        T tmp = LI::move(a);
+        a = LI::move(b);
+        b = LI::move(tmp);
+    }
+
+}
+
+
+#endif
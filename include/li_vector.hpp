@@ -3,6 +3,7 @@
 
 #include "li_alloc.h"
 #include "li_uninitialized.h"
+#include "li_utility.h"
 
 namespace LI {
     // vector 容器的实现
@@ -12,8 +13,11 @@ namespace LI {
         // 嵌套型别定义
         typedef T            value_type;
         typedef value_type*  pointer;
+        typedef const value_type* const_pointer;
         typedef value_type*  iterator;  // 迭代器就是指针
+        typedef const value_type* const_iterator;
         typedef value_type&  reference;
+        typedef const value_type& const_reference;
         typedef size_t       size_type;
         typedef ptrdiff_t    difference_type;
 
@@ -28,7 +32,7 @@ namespace LI {
         // 负责配置空间并填满内容
         iterator allocate_and_fill(size_type n, const T& x) {
             iterator result = data_allocator::allocate(n);
-            uninitialized_fill_n(result, n, x); // 全局函数, 负责在未初始化空间上初始化
+            LI::uninitialized_fill_n(result, n, x); // 全局函数, 负责在未初始化空间上初始化
             return result;
         }
         // 负责释放内存
@@ -43,6 +47,20 @@ namespace LI {
             finish = start + n;
             end_of_storage = finish;
         }
+        // 把 [first, last) 的元素移动构造到 result 开始的未初始化空间, 失败时析构已构造的
+        static iterator uninitialized_move(iterator first, iterator last, iterator result) {
+            iterator cur = result;
+            try {
+                for ( ; first != last; ++first, ++cur) {
+                    construct(cur, LI::move(*first));
+                }
+            }
+            catch(...) {
+                destroy(result, cur);
+                throw;
+            }
+            return cur;
+        }
 
     public:
         // 构造函数
@@ -52,12 +70,48 @@ namespace LI {
         vector(long n, const T& value) { fill_and_initialize(n, value); }
         explicit vector(size_type n) { fill_and_initialize(n, T()); }
 
+        vector(const vector<T, Alloc>& x) : start(0), finish(0), end_of_storage(0) {
+            if (!x.empty()) {
+                start = data_allocator::allocate(x.size());
+                try {
+                    finish = LI::uninitialized_copy(x.begin(), x.end(), start);
+                }
+                catch(...) {
+                    data_allocator::deallocate(start, x.size());
+                    throw;
+                }
+                end_of_storage = finish;
+            }
+        }
+        vector(vector<T, Alloc>&& x) : start(x.start), finish(x.finish), end_of_storage(x.end_of_storage) {
+            x.start = x.finish = x.end_of_storage = 0;
+        }
+
         // 析构函数
         ~vector() {
             destroy(start, finish); // 析构对象
             deallocate(); // 释放空间
         }
-        // 注意这里没有写拷贝构造函数和重载operator= 不要使用这两个函数
+
+        vector<T, Alloc>& operator=(const vector<T, Alloc>& x) {
+            if (this != &x) {
+                vector<T, Alloc> tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+        vector<T, Alloc>& operator=(vector<T, Alloc>&& x) {
+            if (this != &x) {
+                clear();
+                swap(x);
+            }
+            return *this;
+        }
+        void swap(vector<T, Alloc>& x) {
+            LI::swap(start, x.start);
+            LI::swap(finish, x.finish);
+            LI::swap(end_of_storage, x.end_of_storage);
+        }
 
         iterator begin() { 
             return start;
@@ -65,6 +119,12 @@ namespace LI {
         iterator end() {
             return finish;
         }
+        const_iterator begin() const {
+            return start;
+        }
+        const_iterator end() const {
+            return finish;
+        }
         size_type size() const {
             return size_type(finish - start);
         }
@@ -78,6 +138,9 @@ namespace LI {
         reference operator[](size_type n) {
             return *(begin() + n);
         }
+        const_reference operator[](size_type n) const {
+            return *(begin() + n);
+        }
 
         reference front() {
             return *begin(); // 第一个元素
@@ -85,9 +148,32 @@ namespace LI {
         reference back() {
             return *(end() - 1); // 最后一个元素
         }
+        const_reference front() const {
+            return *begin();
+        }
+        const_reference back() const {
+            return *(end() - 1);
+        }
 
         // 在源码文件中实现的函数
         void push_back(const T& value);
+        void push_back(T&& value) {
+            emplace_back(LI::move(value));
+        }
+        // 以 args 在尾端直接构造元素
+        template <class... Args>
+        void emplace_back(Args&&... args) {
+            if (finish != end_of_storage) {
+                construct(finish, LI::forward<Args>(args)...);
+                ++finish;
+            }
+            else {
+                emplace(end(), LI::forward<Args>(args)...);
+            }
+        }
+        // 以 args 在 position 处构造元素, 其后的元素以移动的方式后移
+        template <class... Args>
+        iterator emplace(iterator position, Args&&... args);
         void pop_back();
         iterator erase(iterator first, iterator last);
         iterator erase(iterator position);
@@ -109,7 +195,7 @@ namespace LI {
             construct(finish, *(finish - 1));
             ++finish;
             T x_copy = x;
-            copy_backward(position, finish - 2, finish - 1); // 往后copy
+            LI::copy_backward(position, finish - 2, finish - 1); // 往后copy
             *position = x_copy;
         }
         else {
@@ -122,12 +208,12 @@ namespace LI {
             iterator new_start = data_allocator::allocate(new_size);
             iterator new_finish = new_start;
             try {
-                new_finish = uninitialized_copy(start, position, new_start);
+                new_finish = LI::uninitialized_copy(start, position, new_start);
                 // 新元素设定初值
                 construct(new_finish, x);
                 ++new_finish;
                 // 本函数可以被 insert 函数调用, 所以要 copy 后半段
-                new_finish = uninitialized_copy(position, finish, new_finish);
+                new_finish = LI::uninitialized_copy(position, finish, new_finish);
             }
             catch(...) { 
                 // 捕获所有类型的错误
@@ -169,7 +255,7 @@ namespace LI {
 
     template <class T, class Alloc>
     typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(iterator first, iterator last) {
-        iterator i = copy(last, finish, first);
+        iterator i = LI::copy(last, finish, first);
         destroy(i, finish);
         finish = finish - (last - first); // 更新finish
         return first;
@@ -178,7 +264,7 @@ namespace LI {
     template <class T, class Alloc>
     typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(iterator position) {
         if (position + 1 != end()) {
-            copy(position + 1, finish, position);
+            LI::copy(position + 1, finish, position);
         }
         --finish;
         destroy(finish);
@@ -197,22 +283,22 @@ namespace LI {
                 if (elems_after > n) {
                     // "插入点之后的现有元素个数" 大于 "新增元素个数"
                     // 把现有元素后 n 个元素复制到 未初始化空间
-                    uninitialized_copy(finish - n, finish, finish);
+                    LI::uninitialized_copy(finish - n, finish, finish);
                     // 把 elems_after - n 个元素 后移
-                    copy_backward(position, old_finish - n, old_finish);
+                    LI::copy_backward(position, old_finish - n, old_finish);
                     // 插入
-                    fill_n(position, position + n, x_copy);
+                    LI::fill_n(position, n, x_copy);
                 }
                 else {
                     // "插入点之后的现有元素个数" 小于等于 "新增元素个数"
                     // 在 finish 开始, 在 未初始化空间 构建 n - elems_after 个新增元素
-                    uninitialized_fill_n(finish, n - elems_after, x_copy);
+                    LI::uninitialized_fill_n(finish, n - elems_after, x_copy);
                     finish += n - elems_after;
                     // 把 后 n 个现有元素 复制到 未初始化空间
-                    uninitialized_copy(position, old_finish, finish);
+                    LI::uninitialized_copy(position, old_finish, finish);
                     finish += elems_after;
                     // 填充剩余的新增元素
-                    fill(position, old_finish, x_copy);
+                    LI::fill(position, old_finish, x_copy);
                 }
             }
             else {
@@ -226,11 +312,11 @@ namespace LI {
                 iterator new_finish = new_start;
                 try {
                     // 先复制现有元素的前半段
-                    new_finish = uninitialized_copy(start, position, new_start);
+                    new_finish = LI::uninitialized_copy(start, position, new_start);
                     // 填入要插入的元素
-                    new_finish = uninitialized_fill_n(new_finish, n, x);
+                    new_finish = LI::uninitialized_fill_n(new_finish, n, x);
                     // 复制现有元素后半段
-                    new_finish = uninitialized_copy(position, finish, new_finish);
+                    new_finish = LI::uninitialized_copy(position, finish, new_finish);
                 }
                 catch (...) {
                     destroy(new_start, new_finish); // 析构对象
@@ -275,30 +361,85 @@ namespace LI {
         erase(begin(), end());
     }
 
+    // 容量不足 n 时重新配置, 空的 vector 也会预先配置好空间
     template <class T, class Alloc> 
     void vector<T, Alloc>::reserve(size_type n) {
-        if (n > size()) {
+        if (n > capacity()) {
             iterator new_start = data_allocator::allocate(n);
             iterator new_finish = new_start;
-            if (finish > start) {
+            try {
+                // 移动现有元素
+                new_finish = uninitialized_move(start, finish, new_start);
+            }
+            catch (...) {
+                data_allocator::deallocate(new_start, n); // 释放空间
+                throw; // 重新抛出错误
+            }
+            // 析构原来的vector
+            destroy(start, finish);
+            deallocate();
+            // 调整
+            start = new_start;
+            finish = new_finish;
+            end_of_storage = new_start + n;
+        }
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    typename vector<T, Alloc>::iterator vector<T, Alloc>::emplace(iterator position, Args&&... args) {
+        const size_type index = position - start;
+        if (finish != end_of_storage) {
+            if (position == finish) {
+                construct(finish, LI::forward<Args>(args)...);
+                ++finish;
+            }
+            else {
+                // 先构造好新元素: args 可能引用 vector 中的元素
+                T x_copy(LI::forward<Args>(args)...);
+                construct(finish, LI::move(*(finish - 1)));
+                ++finish;
+                for (iterator i = finish - 2; i != position; --i) {
+                    *i = LI::move(*(i - 1));
+                }
+                *position = LI::move(x_copy);
+            }
+        }
+        else {
+            const size_type old_size = size();
+            const size_type new_size = old_size != 0 ? 2 * old_size : 1;
+            iterator new_start = data_allocator::allocate(new_size);
+            iterator new_finish = new_start;
+            try {
+                // 新元素先构造, 之后再搬动原有元素
+                construct(new_start + index, LI::forward<Args>(args)...);
                 try {
-                    // 复制现有元素
-                    new_finish = uninitialized_copy(start, finish, new_start);
+                    new_finish = uninitialized_move(start, position, new_start);
+                    try {
+                        uninitialized_move(position, finish, new_start + index + 1);
+                    }
+                    catch(...) {
+                        destroy(new_start, new_finish);
+                        throw;
+                    }
                 }
-                catch (...) {
-                    destroy(new_start, new_finish); // 析构对象
-                    data_allocator::deallocate(new_start, n); // 释放空间
-                    throw; // 重新抛出错误
+                catch(...) {
+                    destroy(new_start + index);
+                    throw;
                 }
-                // 析构原来的vector
-                destroy(start, finish);
-                deallocate();
-                // 调整
-                start = new_start;
-                finish = new_finish;
-                end_of_storage = new_start + n;
             }
+            catch(...) {
+                data_allocator::deallocate(new_start, new_size);
+                throw;
+            }
+            new_finish = new_start + old_size + 1;
+            destroy(start, finish);
+            deallocate();
+            start = new_start;
+            finish = new_finish;
+            end_of_storage = new_start + new_size;
         }
+        return start + index;
     }
 }
 
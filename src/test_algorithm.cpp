@@ -0,0 +1,163 @@
+#include "li_algorithm.h"
+#include "li_vector.hpp"
+#include "li_functional.h"
+#include <algorithm> // 与 std 的同名算法同时可见, 检查内部调用都已限定为 LI::
+#include <iostream>
+#include <string>
+#include <stdint.h>
+
+struct is_odd {
+    bool operator()(int x) const { return x % 2 != 0; }
+};
+
+struct longer_than_three {
+    bool operator()(const std::string& s) const { return s.size() > 3; }
+};
+
+int main(int argc, char const *argv[])
+{
+    LI::vector<int> v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(i * 2); // 0 2 4 ... 18
+    }
+    v.push_back(18);
+    for (int i = 0; i < v.size(); ++i) {
+        std::cout << v[i] << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "lower_bound(7): " << *LI::lower_bound(v.begin(), v.end(), 7) << std::endl;
+    std::cout << "lower_bound(8): " << *LI::lower_bound(v.begin(), v.end(), 8) << std::endl;
+    std::cout << "upper_bound(8): " << *LI::upper_bound(v.begin(), v.end(), 8) << std::endl;
+    std::cout << "lower_bound(8, less): " << *LI::lower_bound(v.begin(), v.end(), 8, LI::less<int>()) << std::endl;
+
+    LI::pair<int*, int*> r = LI::equal_range(v.begin(), v.end(), 18);
+    std::cout << "equal_range(18): [" << r.first - v.begin() << ", " << r.second - v.begin() << ")" << std::endl;
+
+    std::cout << "binary_search(6): " << LI::binary_search(v.begin(), v.end(), 6) << std::endl;
+    std::cout << "binary_search(7): " << LI::binary_search(v.begin(), v.end(), 7) << std::endl;
+
+    std::cout << "interpolation_search(12): " << LI::interpolation_search(v.begin(), v.end(), 12) - v.begin() << std::endl;
+    std::cout << "interpolation_search(100): " << LI::interpolation_search(v.begin(), v.end(), 100) - v.begin() << std::endl;
+    // 相邻的 64 位键值转换为 double 后相等, 不能插值
+    LI::vector<uint64_t> big;
+    for (int i = 0; i < 100; ++i) {
+        big.push_back((uint64_t(1) << 60) + i);
+    }
+    std::cout << "interpolation_search(2^60 + 50): " << LI::interpolation_search(big.begin(), big.end(), (uint64_t(1) << 60) + 50) - big.begin() << std::endl;
+
+    // std 中的元素型别: 内部调用的 distance / advance / lower_bound 不能与 std 中的同名函数混淆
+    std::string words[] = { "apple", "kiwi", "kiwi", "melon", "pear" };
+    LI::pair<std::string*, std::string*> wr = LI::equal_range(words, words + 5, std::string("kiwi"));
+    std::cout << "equal_range(kiwi): [" << wr.first - words << ", " << wr.second - words << ")"
+              << " binary_search(lime): " << LI::binary_search(words, words + 5, std::string("lime"))
+              << " binary_search(pear, less): " << LI::binary_search(words, words + 5, std::string("pear"), LI::less<std::string>()) << std::endl;
+
+    std::cout << "find(10): " << LI::find(v.begin(), v.end(), 10) - v.begin() << std::endl;
+    std::cout << "find(11): " << LI::find(v.begin(), v.end(), 11) - v.begin() << std::endl;
+    std::cout << "count(18): " << LI::count(v.begin(), v.end(), 18) << std::endl;
+
+    v.push_back(-3);
+    v.push_back(25);
+    std::cout << "min_element: " << *LI::min_element(v.begin(), v.end()) << std::endl;
+    std::cout << "max_element: " << *LI::max_element(v.begin(), v.end()) << std::endl;
+    LI::pair<int*, int*> mm = LI::minmax_element(v.begin(), v.end());
+    std::cout << "minmax_element: " << *mm.first << " " << *mm.second << std::endl;
+    std::cout << "accumulate: " << LI::accumulate(v.begin(), v.end(), 0) << std::endl;
+
+    LI::vector<int> w;
+    for (int i = 0; i < 15; ++i) {
+        w.push_back((i * 7) % 15); // 0 7 14 6 13 ...
+    }
+    LI::nth_element(w.begin(), w.begin() + 5, w.end());
+    std::cout << "nth_element(5): " << w[5] << std::endl;
+    LI::partial_sort(w.begin(), w.begin() + 4, w.end());
+    std::cout << "partial_sort(4): ";
+    for (int i = 0; i < 4; ++i) {
+        std::cout << w[i] << " ";
+    }
+    std::cout << std::endl;
+    LI::sort(w.begin(), w.end(), LI::less<int>());
+    std::cout << "sort: ";
+    for (int i = 0; i < w.size(); ++i) {
+        std::cout << w[i] << " ";
+    }
+    std::cout << std::endl;
+    int* mid = LI::stable_partition(w.begin(), w.end(), is_odd());
+    std::cout << "stable_partition(odd): ";
+    for (int i = 0; i < w.size(); ++i) {
+        std::cout << w[i] << " ";
+    }
+    std::cout << "| " << mid - w.begin() << std::endl;
+    std::string fruits[] = { "fig", "apple", "kiwi", "yam", "melon" };
+    std::string* long_end = LI::stable_partition(fruits, fruits + 5, longer_than_three());
+    std::cout << "stable_partition(string): ";
+    for (int i = 0; i < 5; ++i) {
+        std::cout << fruits[i] << " ";
+    }
+    std::cout << "| " << long_end - fruits << std::endl;
+
+    int a[] = { 1, 3, 5, 7, 9, 11 };
+    int b[] = { 3, 4, 5, 6, 11 };
+    int out[16];
+    int* e = LI::merge(a, a + 6, b, b + 5, out);
+    std::cout << "merge: ";
+    for (int* p = out; p != e; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    e = LI::set_union(a, a + 6, b, b + 5, out);
+    std::cout << "set_union: ";
+    for (int* p = out; p != e; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    e = LI::set_intersection(a, a + 6, b, b + 5, out);
+    std::cout << "set_intersection: ";
+    for (int* p = out; p != e; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    e = LI::set_difference(a, a + 6, b, b + 5, out);
+    std::cout << "set_difference: ";
+    for (int* p = out; p != e; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    std::cout << "includes: " << LI::includes(a, a + 6, b, b + 2) << " " << LI::includes(a, a + 6, a + 1, a + 3) << std::endl;
+
+    unsigned int ids1[] = { 2, 4, 8, 16, 32, 64, 128, 256, 512 };
+    unsigned int ids2[] = { 1, 2, 3, 5, 8, 13, 21, 34, 55, 89, 144, 233, 377 };
+    unsigned int ids[16];
+    unsigned int* ids_end = LI::set_intersection_unique(ids1, ids1 + 9, ids2, ids2 + 13, ids);
+    std::cout << "set_intersection_unique: ";
+    for (unsigned int* p = ids; p != ids_end; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+
+    int c[] = { 1, 4, 6, 9, 2, 3, 5, 10 };
+    LI::inplace_merge(c, c + 4, c + 8);
+    std::cout << "inplace_merge: ";
+    for (int i = 0; i < 8; ++i) std::cout << c[i] << " ";
+    std::cout << std::endl;
+
+    // std::string 元素: 合并与集合算法内部调用的 copy / distance / destroy 以及 __merge 等不能与 std 中的同名函数混淆
+    std::string sa[] = { "ant", "cat", "dog", "eel", "fox" };
+    std::string sb[] = { "bee", "cat", "fox", "gnu" };
+    std::string sout[16];
+    std::string* se = LI::merge(sa, sa + 5, sb, sb + 4, sout);
+    std::cout << "merge(string): ";
+    for (std::string* p = sout; p != se; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    se = LI::set_union(sa, sa + 5, sb, sb + 4, sout);
+    std::cout << "set_union(string): ";
+    for (std::string* p = sout; p != se; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    se = LI::set_difference(sa, sa + 5, sb, sb + 4, sout);
+    std::cout << "set_difference(string): ";
+    for (std::string* p = sout; p != se; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    se = LI::set_intersection(sa, sa + 5, sb, sb + 4, sout);
+    std::cout << "set_intersection(string): ";
+    for (std::string* p = sout; p != se; ++p) std::cout << *p << " ";
+    std::cout << std::endl;
+    std::string sc[] = { "b", "d", "f", "h", "a", "c", "e", "g" };
+    LI::inplace_merge(sc, sc + 4, sc + 8);
+    std::cout << "inplace_merge(string): ";
+    for (int i = 0; i < 8; ++i) std::cout << sc[i] << " ";
+    std::cout << std::endl;
+    std::cout << "includes(string): " << LI::includes(sa, sa + 5, sa + 1, sa + 3) << " " << LI::includes(sa, sa + 5, sb, sb + 4) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "li_btree_map.hpp"
+#include "li_map.hpp"
+#include <iostream>
+#include <string>
+
+int main(int argc, char const *argv[])
+{
+    // 基本用法与 map 相同
+    LI::btree_map<std::string, int> bm;
+    bm["jjhou"] = 1;
+    bm["jerry"] = 2;
+    bm["jason"] = 3;
+    bm.insert(LI::pair<const std::string, int>("jimmy", 4));
+    bm.emplace("david", 5);
+    bm.insert_or_assign("jerry", 20);
+    std::cout << "btree_map: ";
+    for (auto x = bm.begin(); x != bm.end(); ++x) {
+        std::cout << x->first << "=" << x->second << " ";
+    }
+    std::cout << " size: " << bm.size() << std::endl;
+    std::cout << "find(jason): " << bm.find("jason")->second << " count(tom): " << bm.count("tom") << std::endl;
+
+    // 大量元素: 与 map 逐个比较
+    LI::btree_map<int, int> b;
+    LI::map<int, int> m;
+    unsigned int seed = 1;
+    for (int i = 0; i < 100000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int k = (seed >> 8) % 20000;
+        if (i % 3 == 2) {
+            b.erase(k);
+            m.erase(k);
+        }
+        else {
+            b[k] += i;
+            m[k] += i;
+        }
+    }
+    bool same = b.size() == m.size();
+    auto y = m.begin();
+    for (auto x = b.begin(); same && x != b.end(); ++x, ++y) {
+        same = x->first == y->first && x->second == y->second;
+    }
+    std::cout << "same as map: " << same << " size: " << b.size() << std::endl;
+
+    // 删除后迭代器失效, erase 返回下一个元素
+    auto it = b.lower_bound(5000);
+    while (it != b.end() && it->first < 10000) {
+        it = b.erase(it);
+    }
+    std::cout << "after erase [5000, 10000): lower_bound(5000) = " << b.lower_bound(5000)->first << std::endl;
+
+    // 顺序插入时叶节点几乎都是满的
+    LI::btree_map<int, int> seq;
+    for (int i = 0; i < 100000; ++i) {
+        seq.insert(seq.end(), LI::pair<const int, int>(i, i));
+    }
+    std::cout << "sequential: " << double(seq.memory_usage()) / seq.size() << " bytes per element" << std::endl;
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "li_concurrent_map.hpp"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef LI::pair<const int, int> value_type;
+
+// 按次序打印元素
+struct print {
+    void operator()(const value_type& x) const { std::cout << x.first << "=" << x.second << " "; }
+};
+
+int main(int argc, char const *argv[])
+{
+    // 基本用法: 查找时复制出实值, 或在锁内调用函数对象
+    LI::concurrent_map<int, int, 4> cm;
+    cm.insert(value_type(3, 30));
+    cm.insert(value_type(1, 10));
+    cm.try_emplace(2, 20);
+    cm.insert_or_assign(3, 33);
+    int v = 0;
+    std::cout << "find(3): " << cm.find(3, v) << " value " << v << " count(4): " << cm.count(4) << std::endl;
+    cm.update(1, [](int& x) { x += 5; });
+    cm.visit(1, [](const value_type& x) { std::cout << "visit(1): " << x.second << std::endl; });
+    std::cout << "for_each_consistent: ";
+    cm.for_each_consistent(print());
+    std::cout << std::endl;
+
+    // 多个线程同时读写: 每个写线程负责一部分键值, 读线程只会看到 value == key * 2
+    const int writers = 4, readers = 8, keys = 20000;
+    LI::concurrent_map<int, int, 16> shared;
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.push_back(std::thread([&shared, w]() {
+            for (int k = w; k < keys; k += writers) {
+                shared.insert(value_type(k, k * 2));
+            }
+            for (int k = w; k < keys; k += writers * 2) {
+                shared.erase(k);
+            }
+        }));
+    }
+    int bad[readers] = { 0 };
+    for (int r = 0; r < readers; ++r) {
+        threads.push_back(std::thread([&shared, &bad, r]() {
+            int keys_batch[64], values[64];
+            bool found[64];
+            for (int round = 0; round < 200; ++round) {
+                for (int i = 0; i < 64; ++i) keys_batch[i] = (round * 64 + i * 7 + r) % keys;
+                shared.find_batch(keys_batch, 64, values, found);
+                for (int i = 0; i < 64; ++i) {
+                    if (found[i] && values[i] != keys_batch[i] * 2) ++bad[r];
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    int bad_total = 0;
+    for (int r = 0; r < readers; ++r) bad_total += bad[r];
+    std::cout << "after threads: size " << shared.size() << " (expect " << keys / 2 << "), bad reads " << bad_total << std::endl;
+
+    // 批量操作与一致的快照
+    int erase_keys[] = { 1, 3, 5, 7, 9 };
+    std::cout << "erase_batch: " << shared.erase_batch(erase_keys, 5) << std::endl;
+    LI::concurrent_map<int, int, 16>::snapshot_type snap = shared.snapshot();
+    std::cout << "snapshot: size " << snap.size() << " first " << snap.begin()->first << std::endl;
+
+    // 按区间分片: 区间遍历只锁住涉及的分片
+    std::string bounds[] = { "g", "n", "t" };
+    LI::concurrent_map<std::string, int, 4, LI::range_partition<std::string> > names(
+        LI::range_partition<std::string>(bounds, bounds + 3));
+    const char* words[] = { "apple", "kiwi", "melon", "pear", "zucchini", "banana", "orange" };
+    for (int i = 0; i < 7; ++i) names.insert(LI::pair<const std::string, int>(words[i], i));
+    std::cout << "range [b, p): ";
+    names.for_each_range("b", "p", [](const LI::pair<const std::string, int>& x) { std::cout << x.first << " "; });
+    std::cout << std::endl;
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include "li_deque.hpp"
 #include <iostream>
+#include <string>
 
 
 int main(int argc, char const *argv[])
@@ -59,6 +60,25 @@ int main(int argc, char const *argv[])
     d.clear();
     std::cout << "size: " << d.size() << std::endl;
 
+    // 非平凡的元素型别: 插入删除要调用 LI::copy 和 LI::destroy, 不能与 std 中的同名函数混淆
+    LI::deque<std::string> ds;
+    for (int i = 0; i < 10; ++i) {
+        ds.push_back(std::string(1, char('a' + i)));
+    }
+    ds.push_front("front");
+    ds.insert(ds.begin() + 3, "mid");
+    ds.insert(ds.end() - 2, "tail");
+    ds.erase(ds.begin() + 1);
+    ds.erase(ds.end() - 3);
+    ds.erase(ds.begin() + 2, ds.begin() + 5);
+    for (int i = 0; i < ds.size(); ++i) {
+        std::cout << ds[i] << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "size: " << ds.size() << std::endl;
+    ds.clear();
+    std::cout << "size: " << ds.size() << std::endl;
+
 
     return 0;
 }
@@ -0,0 +1,76 @@
+#include "li_flat_map.hpp"
+#include "li_map.hpp"
+#include <iostream>
+#include <string>
+
+int main(int argc, char const *argv[])
+{
+    // 基本用法与 map 相同
+    LI::flat_map<std::string, int> fm;
+    fm.reserve(8);
+    fm["jjhou"] = 1;
+    fm["jerry"] = 2;
+    fm["jason"] = 3;
+    fm.insert(LI::pair<const std::string, int>("jimmy", 4));
+    fm.emplace("david", 5);
+    fm.insert_or_assign("jerry", 20);
+    std::cout << "flat_map: ";
+    for (auto x = fm.begin(); x != fm.end(); ++x) {
+        std::cout << x->first << "=" << x->second << " ";
+    }
+    std::cout << " size: " << fm.size() << " capacity: " << fm.capacity() << std::endl;
+    std::cout << "find(jason): " << fm.find("jason")->second << " count(tom): " << fm.count("tom") << std::endl;
+
+    // 区间插入: 先追加再一次合并, 重复的键值保留先出现的
+    LI::pair<const std::string, int> more[] = {
+        LI::pair<const std::string, int>("bob", 6),
+        LI::pair<const std::string, int>("alice", 7),
+        LI::pair<const std::string, int>("jason", 30),
+        LI::pair<const std::string, int>("bob", 60)
+    };
+    fm.insert(more, more + 4);
+    std::cout << "after insert range: ";
+    for (auto x = fm.begin(); x != fm.end(); ++x) {
+        std::cout << x->first << "=" << x->second << " ";
+    }
+    std::cout << std::endl;
+    auto r = fm.equal_range("jerry");
+    std::cout << "equal_range(jerry): " << (r.second - r.first) << " element(s), lower_bound(c): " << fm.lower_bound("c")->first << std::endl;
+    fm.erase(fm.find("jjhou"));
+    fm.erase("alice");
+    std::cout << "after erase: size " << fm.size() << " first " << fm.begin()->first << std::endl;
+
+    // 与 map 逐个比较
+    LI::flat_map<int, int> f;
+    LI::map<int, int> m;
+    unsigned int seed = 1;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int k = (seed >> 8) % 2000;
+        if (i % 3 == 2) {
+            f.erase(k);
+            m.erase(k);
+        }
+        else {
+            f[k] += i;
+            m[k] += i;
+        }
+    }
+    bool same = f.size() == m.size();
+    auto y = m.begin();
+    for (auto x = f.begin(); same && x != f.end(); ++x, ++y) {
+        same = x->first == y->first && x->second == y->second;
+    }
+    std::cout << "same as map: " << same << " size: " << f.size() << std::endl;
+
+    // flat_set
+    int ia[] = {5, 1, 3, 3, 9, 1, 7};
+    LI::flat_set<int> s(ia, ia + 7);
+    s.insert(4);
+    std::cout << "flat_set: ";
+    for (auto x = s.begin(); x != s.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << " s[2]: " << s[2] << " count(9): " << s.count(9) << std::endl;
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "li_functional.h"
+#include "li_pair.h"
+#include "li_simd.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+
+// 哈希函数的质量与速度
+// 雪崩: 翻转输入的一位, 每个输出位改变的概率应接近 0.5, 打印所有 (输入位, 输出位) 中最大的偏差
+// 分布: 把有规律的键值 (连续整数, 步长为 2 的幂的整数, 相似的字符串) 放入 2^k 个桶,
+//       打印 卡方 / 桶数, 理想的随机分布约为 1; 哈希表以低 7 位作为 h2, 其余位选桶, 两者分别检查
+
+static unsigned long long rng_state = 88172645463325252ull;
+static unsigned long long next_random() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+template <class F>
+double avalanche_u64(F f, int samples) {
+    static int flips[64][64];
+    for (int i = 0; i < 64; ++i) for (int j = 0; j < 64; ++j) flips[i][j] = 0;
+    for (int s = 0; s < samples; ++s) {
+        unsigned long long x = next_random();
+        unsigned long long h = (unsigned long long) f(x);
+        for (int i = 0; i < 64; ++i) {
+            unsigned long long d = h ^ (unsigned long long) f(x ^ (1ull << i));
+            for (int j = 0; j < 64; ++j) flips[i][j] += (d >> j) & 1;
+        }
+    }
+    double worst = 0;
+    for (int i = 0; i < 64; ++i) for (int j = 0; j < 64; ++j) {
+        double bias = flips[i][j] / double(samples) - 0.5;
+        if (bias < 0) bias = -bias;
+        if (bias > worst) worst = bias;
+    }
+    return worst;
+}
+
+double avalanche_bytes(size_t len, int samples) {
+    static int flips[64];
+    std::vector<unsigned char> buf(len);
+    double worst = 0;
+    // 检查开头、中间、末尾的各 8 个字节
+    size_t starts[3] = { 0, len / 2 - 4, len - 8 };
+    for (int part = 0; part < 3; ++part) {
+        for (int b = 0; b < 64; ++b) {
+            for (int j = 0; j < 64; ++j) flips[j] = 0;
+            for (int s = 0; s < samples; ++s) {
+                for (size_t i = 0; i < len; ++i) buf[i] = (unsigned char) next_random();
+                unsigned long long h = LI::__hash_bytes(buf.data(), len);
+                buf[starts[part] + b / 8] ^= (unsigned char) (1 << (b % 8));
+                unsigned long long d = h ^ (unsigned long long) LI::__hash_bytes(buf.data(), len);
+                for (int j = 0; j < 64; ++j) flips[j] += (d >> j) & 1;
+            }
+            for (int j = 0; j < 64; ++j) {
+                double bias = flips[j] / double(samples) - 0.5;
+                if (bias < 0) bias = -bias;
+                if (bias > worst) worst = bias;
+            }
+        }
+    }
+    return worst;
+}
+
+// 卡方 / 桶数; 取哈希值的 [shift, shift + bits) 位作为桶号
+double chi2(const std::vector<size_t>& hashes, int shift, int bits) {
+    std::vector<double> count(size_t(1) << bits, 0.0);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        count[(hashes[i] >> shift) & ((size_t(1) << bits) - 1)] += 1;
+    }
+    double expect = double(hashes.size()) / count.size(), sum = 0;
+    for (size_t i = 0; i < count.size(); ++i) {
+        sum += (count[i] - expect) * (count[i] - expect) / expect;
+    }
+    return sum / count.size();
+}
+
+template <class F>
+void distribution(const char* name, F f, int n) {
+    std::vector<size_t> seq, stride;
+    for (int i = 0; i < n; ++i) {
+        seq.push_back(f((unsigned long long) i));
+        stride.push_back(f((unsigned long long) i << 12));
+    }
+    std::cout << name << ": sequential h2 " << chi2(seq, 0, 7) << " bucket " << chi2(seq, 7, 12)
+              << ", stride 4096 h2 " << chi2(stride, 0, 7) << " bucket " << chi2(stride, 7, 12) << std::endl;
+}
+
+template <class F>
+double ns_per_call(F f, int n) {
+    size_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) sink += f((unsigned long long) i);
+    auto t1 = std::chrono::steady_clock::now();
+    volatile size_t keep = sink;
+    (void) keep;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+double bytes_gbps(size_t len, int rounds) {
+    std::vector<unsigned char> buf(len + 1);
+    for (size_t i = 0; i < buf.size(); ++i) buf[i] = (unsigned char) next_random();
+    size_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) sink += LI::__hash_bytes(buf.data() + (r & 1), len, sink);
+    auto t1 = std::chrono::steady_clock::now();
+    volatile size_t keep = sink;
+    (void) keep;
+    return double(len) * rounds / std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+int main(int argc, char const *argv[])
+{
+    LI::hash<unsigned long long> h_default;
+    LI::fibonacci_hash<unsigned long long> h_fib;
+
+    // 雪崩 (64 位整数)
+    // 偏差的统计误差: 2000 个样本约 0.045, 500 个约 0.09, 200 个约 0.14
+    std::cout << "avalanche worst bias (0 is ideal): default " << avalanche_u64(h_default, 2000)
+              << " fibonacci " << avalanche_u64(h_fib, 2000) << std::endl;
+    std::cout << "avalanche worst bias bytes: 16B " << avalanche_bytes(16, 500)
+              << " 100B " << avalanche_bytes(100, 500)
+              << " 1000B " << avalanche_bytes(1000, 200) << std::endl;
+
+    LI::hash<LI::pair<unsigned long long, unsigned long long> > h_pair2;
+    std::cout << "avalanche worst bias pair<u64, u64> (first / second): "
+              << avalanche_u64([&](unsigned long long x) { return h_pair2(LI::pair<unsigned long long, unsigned long long>(x, 7)); }, 2000) << " / "
+              << avalanche_u64([&](unsigned long long x) { return h_pair2(LI::pair<unsigned long long, unsigned long long>(7, x)); }, 2000) << std::endl;
+
+    // 分布
+    distribution("default", h_default, 1 << 17);
+    distribution("fibonacci", h_fib, 1 << 17);
+    std::vector<size_t> strings;
+    for (int i = 0; i < (1 << 17); ++i) {
+        std::string s = "user_" + std::to_string(i);
+        strings.push_back(LI::__hash_bytes(s.data(), s.size()));
+    }
+    std::cout << "strings user_N: h2 " << chi2(strings, 0, 7) << " bucket " << chi2(strings, 7, 12) << std::endl;
+    std::vector<size_t> pairs;
+    LI::hash<LI::pair<const int, int> > h_pair;
+    for (int i = 0; i < 256; ++i) for (int j = 0; j < 512; ++j) {
+        pairs.push_back(h_pair(LI::pair<const int, int>(i, j)));
+    }
+    std::cout << "pair<int, int> grid: h2 " << chi2(pairs, 0, 7) << " bucket " << chi2(pairs, 7, 12)
+              << ", (1, 2) != (2, 1): " << (h_pair(LI::pair<const int, int>(1, 2)) != h_pair(LI::pair<const int, int>(2, 1))) << std::endl;
+
+    // 32 位截断后的碰撞数, 2^17 个随机键值约为 2
+    std::vector<unsigned int> low(strings.begin(), strings.end());
+    std::vector<unsigned char> seen(size_t(1) << 29, 0);
+    int collisions = 0;
+    for (size_t i = 0; i < low.size(); ++i) {
+        unsigned int v = low[i];
+        if (seen[v >> 3] & (1 << (v & 7))) ++collisions;
+        seen[v >> 3] |= (unsigned char) (1 << (v & 7));
+    }
+    std::cout << "32-bit collisions among strings: " << collisions << std::endl;
+
+    // SIMD 累加与普通循环结果相同 (含非对齐的输入)
+    bool same = true;
+    std::vector<unsigned char> buf(64 * 40 + 1);
+    for (size_t i = 0; i < buf.size(); ++i) buf[i] = (unsigned char) next_random();
+    for (size_t n = 0; n <= 40 && same; n += 3) {
+        unsigned long long a[8], b[8];
+        for (int i = 0; i < 8; ++i) a[i] = b[i] = next_random();
+        LI::__simd_hash_stripes((uint64_t*) a, buf.data() + 1, n);
+        LI::__hash_stripes_scalar((uint64_t*) b, buf.data() + 1, n);
+        for (int i = 0; i < 8; ++i) same = same && a[i] == b[i];
+    }
+    std::cout << "simd stripes == scalar: " << same << std::endl;
+
+    // 速度
+    std::cout << "ns per integer hash: default " << ns_per_call(h_default, 1 << 24)
+              << " fibonacci " << ns_per_call(h_fib, 1 << 24) << std::endl;
+    std::cout << "bytes hash GB/s: 8B " << bytes_gbps(8, 1 << 22) << " 32B " << bytes_gbps(32, 1 << 22)
+              << " 200B " << bytes_gbps(200, 1 << 20) << " 4KB " << bytes_gbps(4096, 1 << 16)
+              << " 1MB " << bytes_gbps(1 << 20, 256) << std::endl;
+    return 0;
+}
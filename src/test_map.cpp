@@ -1,5 +1,6 @@
 #include "li_map.hpp"
 #include <iostream>
+#include <string>
 #include "li_pair.h"
 
 int main(int argc, char const *argv[])
@@ -38,6 +39,148 @@ int main(int argc, char const *argv[])
         std::cout << "find "<< it->first << ": " << it->second << std::endl;
     }
 
+    // 区间查找
+    for (int i = 10; i < 20; ++i) {
+        m[i] = 'a' + i - 10;
+    }
+    std::cout << "[12, 16): ";
+    for (it = m.lower_bound(12); it != m.lower_bound(16); ++it) {
+        std::cout << "(" << it->first << ")" << it->second << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "upper_bound(4): " << m.upper_bound(4)->first << std::endl;
+    std::cout << "count(3): " << m.count(3) << " count(5): " << m.count(5) << std::endl;
+    LI::pair<LI::map<int, char>::iterator, LI::map<int, char>::iterator> r = m.equal_range(15);
+    std::cout << "equal_range(15): " << r.first->first << " " << r.second->first << std::endl;
+
+    m.erase(m.lower_bound(12), m.upper_bound(17));
+    for (auto x = m.begin(); x != m.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "size: " << m.size() << std::endl;
+
+    // 带提示的插入, 递增的键值每次都挂在最右侧
+    LI::map<int, char> m2;
+    for (int i = 0; i < 8; ++i) {
+        m2.insert(m2.end(), LI::pair<const int, char>(i, 'a' + i));
+    }
+    m2.insert(m2.find(4), LI::pair<const int, char>(4, 'z')); // 已存在, 不插入
+    m2.insert(m.begin(), m.end());
+    for (auto x = m2.begin(); x != m2.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "size: " << m2.size() << std::endl;
+
+    // 以已排序的区间直接建树
+    LI::pair<const int, char> sorted[] = {
+        LI::pair<const int, char>(1, 'a'), LI::pair<const int, char>(2, 'b'), LI::pair<const int, char>(3, 'c'),
+        LI::pair<const int, char>(5, 'e'), LI::pair<const int, char>(8, 'h')
+    };
+    LI::map<int, char> m3(sorted, sorted + 5, LI::sorted_unique_tag());
+    m3[4] = 'd';
+    for (auto x = m3.begin(); x != m3.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "size: " << m3.size() << std::endl;
+    LI::pair<const int, char> sorted_equal[] = {
+        LI::pair<const int, char>(1, 'a'), LI::pair<const int, char>(1, 'b'), LI::pair<const int, char>(3, 'c'),
+        LI::pair<const int, char>(3, 'd'), LI::pair<const int, char>(3, 'e')
+    };
+    LI::multimap<int, char> mm(sorted_equal, sorted_equal + 5, LI::sorted_equivalent_t());
+    for (auto x = mm.begin(); x != mm.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << "count(3): " << mm.count(3) << std::endl;
+
+    // 拷贝与移动
+    LI::map<int, char> m4(m3);
+    m4[6] = 'f';
+    LI::map<int, char> m5;
+    m5 = m4;
+    LI::map<int, char> m6(LI::move(m4));
+    std::cout << "copy: " << m3.size() << " " << m5.size() << " moved: " << m4.size() << " " << m6.size() << std::endl;
+    m6.swap(m3);
+    for (auto x = m3.begin(); x != m3.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+
+    // 节点把手: 在两个 map 之间搬动元素, 不重新申请节点
+    LI::map<int, char> hot, cold;
+    for (int i = 0; i < 6; ++i) {
+        hot[i] = 'a' + i;
+    }
+    cold[2] = 'x';
+    LI::map<int, char>::node_type nh = hot.extract(4);
+    LI::map<int, char>::insert_return_type ret = cold.insert(LI::move(nh));
+    std::cout << "extract(4) -> cold: inserted " << ret.inserted << " " << ret.position->first << std::endl;
+    ret = cold.insert(hot.extract(2)); // cold 中已有 2, 节点留在 ret.node 中
+    std::cout << "extract(2) -> cold: inserted " << ret.inserted << " node " << ret.node.value().first << std::endl;
+    hot.insert(LI::move(ret.node)); // 放回原处
+    cold.merge(hot); // 2 已存在, 留在 hot 中
+    std::cout << "after merge hot: ";
+    for (auto x = hot.begin(); x != hot.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << " cold: ";
+    for (auto x = cold.begin(); x != cold.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+
+    // 原地构造: 键值不存在时才构造元素
+    LI::map<int, std::string> names;
+    names.try_emplace(1, 3, 'a'); // second 以 string(3, 'a') 构造
+    names.try_emplace(1, 3, 'b'); // 已存在, 什么都不做
+    names.emplace(2, "two");
+    names.insert_or_assign(2, "TWO"); // 已存在, 赋值
+    names.insert_or_assign(3, "three");
+    names[4] += "four";
+    for (auto x = names.begin(); x != names.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+
+    // 透明比较器: 以 const char* 查找 string 键值, 不构造临时的 string
+    LI::map<std::string, int, LI::less<> > ages;
+    ages["alice"] = 30;
+    ages["bob"] = 25;
+    std::cout << "find(\"bob\"): " << ages.find("bob")->second
+              << " count(\"carol\"): " << ages.count("carol")
+              << " erase(\"alice\"): " << ages.erase("alice")
+              << " size: " << ages.size() << std::endl;
+
+    // 批量查找: 多个键值的树下降交替进行
+    LI::map<int, int> squares;
+    for (int i = 0; i < 100; ++i) {
+        squares[i] = i * i;
+    }
+    int probes[] = { 42, 7, 150, 99, -1, 7 };
+    LI::map<int, int>::iterator found[6];
+    squares.find_batch(probes, 6, found);
+    std::cout << "find_batch: ";
+    for (int i = 0; i < 6; ++i) {
+        if (found[i] != squares.end()) std::cout << found[i]->second << " ";
+        else std::cout << "- ";
+    }
+    squares.find_batch_sorted(probes, 6, found); // 结果仍按 probes 原来的次序
+    std::cout << " sorted: ";
+    for (int i = 0; i < 6; ++i) {
+        if (found[i] != squares.end()) std::cout << found[i]->second << " ";
+        else std::cout << "- ";
+    }
+    std::cout << std::endl;
+
+    // 只读快照: 之后对 map 的修改不影响快照
+    LI::frozen_map<int, int> snapshot = squares.freeze();
+    squares[1000] = 0;
+    std::cout << "frozen size: " << snapshot.size() << " map size: " << squares.size()
+              << " find(12): " << snapshot.find(12)->second
+              << " lower_bound(-5): " << snapshot.lower_bound(-5)->first
+              << " find(1000): " << (snapshot.find(1000) == snapshot.end() ? "end" : "found") << std::endl;
 
     return 0;
 }
@@ -0,0 +1,46 @@
+// 顺序统计需要在包含头文件之前打开
+#define LI_RB_TREE_ORDER_STATISTIC
+#include "li_map.hpp"
+#include <iostream>
+
+int main(int argc, char const *argv[])
+{
+    // 分数 -> 选手编号
+    LI::map<int, int> scores;
+    for (int i = 0; i < 100; ++i) {
+        scores[(i * 37) % 100 * 10] = i;
+    }
+    std::cout << "size: " << scores.size() << std::endl;
+
+    // 排名: 分数低于 355 的人数
+    std::cout << "rank(355): " << scores.rank(355) << std::endl;
+    // 第 k 小的分数
+    std::cout << "select(0): " << scores.select(0)->first
+              << " select(50): " << scores.select(50)->first
+              << " select(99): " << scores.select(99)->first << std::endl;
+    std::cout << "select(100) == end(): " << (scores.select(100) == scores.end()) << std::endl;
+
+    // 百分位数
+    for (int p = 10; p <= 90; p += 40) {
+        LI::map<int, int>::size_type k = scores.size() * p / 100;
+        std::cout << "p" << p << ": " << scores.select(k)->first << std::endl;
+    }
+
+    // 迭代器跳跃与距离, O(log n)
+    LI::map<int, int>::iterator it = scores.begin() + 10;
+    std::cout << "begin() + 10: " << it->first << std::endl;
+    std::cout << "end() - 1: " << (scores.end() - 1)->first << std::endl;
+    std::cout << "find(500) - begin(): " << (scores.find(500) - scores.begin()) << std::endl;
+    std::cout << "end() - begin(): " << (scores.end() - scores.begin()) << std::endl;
+
+    // 删除后排名随之更新
+    scores.erase(scores.begin(), scores.begin() + 20);
+    std::cout << "after erase 20, size: " << scores.size() << " rank(355): " << scores.rank(355)
+              << " select(0): " << scores.select(0)->first << std::endl;
+
+    // 复制的树带着子树大小
+    LI::map<int, int> copy(scores);
+    std::cout << "copy select(5): " << copy.select(5)->first << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "li_persistent_map.hpp"
+#include "li_map.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef LI::persistent_map<std::string, int> config_map;
+typedef LI::pair<const std::string, int> config_entry;
+
+void print(const char* name, const config_map& m) {
+    std::cout << name << " (size " << m.size() << "): ";
+    for (config_map::const_iterator it = m.begin(); it != m.end(); ++it) {
+        std::cout << it->first << "=" << it->second << " ";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char const *argv[])
+{
+    // 每次修改返回新版本, 旧版本不变
+    config_map v1 = config_map().insert(config_entry("timeout", 30)).insert(config_entry("retries", 3));
+    config_map v2 = v1.insert_or_assign("timeout", 60).insert(config_entry("port", 8080));
+    config_map v3 = v2.erase("retries");
+    print("v1", v1);
+    print("v2", v2);
+    print("v3", v3);
+    std::cout << "v3.find(\"port\"): " << v3.find("port")->second << " v3.count(\"retries\"): " << v3.count("retries")
+              << " v1.erase(\"none\") same version: " << v1.erase("none").same_version(v1) << std::endl;
+
+    // 一个写者不断发布新版本, 读者取得某一时刻的版本后不再需要同步
+    typedef LI::persistent_map<int, int> int_map;
+    LI::version_cell<int_map> cell;
+    const int keys = 1000, updates = 20000, readers = 4;
+    std::vector<std::thread> threads;
+    threads.push_back(std::thread([&cell]() {
+        int_map m;
+        for (int i = 0; i < updates; ++i) {
+            m = m.insert_or_assign(i % keys, i);
+            if (i % 3 == 0) m = m.erase((i * 7) % keys);
+            cell.store(m);
+        }
+    }));
+    int bad[readers] = { 0 };
+    for (int r = 0; r < readers; ++r) {
+        threads.push_back(std::thread([&cell, &bad, r]() {
+            for (int round = 0; round < 500; ++round) {
+                int_map snapshot = cell.load();
+                size_t n = 0;
+                int prev = -1;
+                for (int_map::const_iterator it = snapshot.begin(); it != snapshot.end(); ++it, ++n) {
+                    if (it->first <= prev || it->second % keys != it->first) ++bad[r];
+                    prev = it->first;
+                }
+                if (n != snapshot.size()) ++bad[r];
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    int bad_total = 0;
+    for (int r = 0; r < readers; ++r) bad_total += bad[r];
+    std::cout << "after threads: size " << cell.load().size() << ", bad snapshots " << bad_total << std::endl;
+
+    // 取快照: LI::map 复制整棵树 O(n), persistent_map 只增加引用计数 O(1)
+    const int n = 100000, snapshots = 100;
+    LI::map<int, int> m;
+    int_map pm;
+    for (int i = 0; i < n; ++i) {
+        m.insert(LI::pair<const int, int>(i, i));
+        pm = pm.insert(LI::pair<const int, int>(i, i));
+    }
+    size_t total = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < snapshots; ++i) {
+        LI::map<int, int> copy(m);
+        total += copy.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < snapshots; ++i) {
+        int_map copy(pm);
+        pm = pm.insert_or_assign(i, -i); // 每次快照之后写者改一个键值
+        total += copy.size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << snapshots << " snapshots of " << n << " elements: map copy "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, persistent_map "
+              << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms (total " << total << ")" << std::endl;
+    return 0;
+}
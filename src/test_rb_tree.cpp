@@ -1,6 +1,47 @@
 #include "li_rbtree.hpp"
 #include "li_functional.h"
 #include <iostream>
+#include <set>
+#include <stdlib.h>
+
+// 记录存活对象的个数, 检查 clear 和析构是否析构了每个元素
+struct counted {
+    static long live;
+    int key;
+    counted(int k) : key(k) { ++live; }
+    counted(const counted& x) : key(x.key) { ++live; }
+    ~counted() { --live; }
+    bool operator<(const counted& x) const { return key < x.key; }
+};
+long counted::live = 0;
+typedef LI::rb_tree<counted, counted, LI::identity<counted>, LI::less<counted> > counted_tree;
+
+// 大树的拆除: 节点要全部析构, 并整串交还内存池, 之后新建的节点应当重用这些节点
+// order: 0 随机键值, 1 递增键值 (右链最长), 2 递减键值
+bool teardown_reuses_nodes(int n, int order, bool by_destructor) {
+    std::set<void*> freed;
+    {
+        counted_tree t;
+        for (int i = 0; i < n; ++i) {
+            int k = order == 0 ? rand() : (order == 1 ? i : n - i);
+            t.insert_equal(counted(k));
+        }
+        for (counted_tree::iterator x = t.begin(); x != t.end(); ++x) {
+            freed.insert(x.node);
+        }
+        if (!by_destructor) {
+            t.clear();
+            if (t.size() != 0 || t.begin() != t.end()) return false;
+        }
+    }
+    if (counted::live != 0) return false;
+    counted_tree t;
+    int reused = 0;
+    for (int i = 0; i < n; ++i) {
+        reused += freed.count(t.insert_equal(counted(i)).node);
+    }
+    return reused == n;
+}
 
 int main(int argc, char const *argv[])
 {
@@ -13,7 +54,7 @@ int main(int argc, char const *argv[])
 
     std::cout << itree.size() << std::endl;
     for (auto x = itree.begin(); x != itree.end(); ++x) {
-        std::cout << *x << "(" << x.node->color << ")" << " ";
+        std::cout << *x << "(" << x.node->get_color() << ")" << " ";
     }
     std::cout << std::endl;
 
@@ -26,17 +67,22 @@ int main(int argc, char const *argv[])
 
     std::cout << itree.size() << std::endl;
     for (auto x = itree.begin(); x != itree.end(); ++x) {
-        std::cout << *x << "(" << x.node->color << ")" << " ";
+        std::cout << *x << "(" << x.node->get_color() << ")" << " ";
     }
     std::cout << std::endl;
 
     itree.erase(10);
     std::cout << itree.size() << std::endl;
     for (auto x = itree.begin(); x != itree.end(); ++x) {
-        std::cout << *x << "(" << x.node->color << ")" << " ";
+        std::cout << *x << "(" << x.node->get_color() << ")" << " ";
     }
     std::cout << std::endl;
     
 
+
+    std::cout << "teardown reuses nodes (random, ascending, descending, destructor): "
+              << teardown_reuses_nodes(200000, 0, false) << " " << teardown_reuses_nodes(200000, 1, false) << " "
+              << teardown_reuses_nodes(200000, 2, false) << " " << teardown_reuses_nodes(200000, 0, true) << std::endl;
+
     return 0;
 }
@@ -0,0 +1,93 @@
+#include "li_set.hpp"
+#include "li_map.hpp"
+#include <iostream>
+
+int main(int argc, char const *argv[])
+{
+    int ia[] = {5, 1, 3, 3, 9, 1, 7};
+
+    // set: 重复的元素只保留一个
+    LI::set<int> s(ia, ia + 7);
+    std::cout << "set: ";
+    for (auto x = s.begin(); x != s.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << " size: " << s.size() << std::endl;
+    std::cout << "insert(3): " << s.insert(3).second << " insert(4): " << s.insert(4).second << std::endl;
+    std::cout << "lower_bound(6): " << *s.lower_bound(6) << " upper_bound(7): " << *s.upper_bound(7) << std::endl;
+    s.erase(s.find(1));
+    s.erase(9);
+    std::cout << "after erase: ";
+    for (auto x = s.begin(); x != s.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << std::endl;
+
+    // multiset: 允许重复
+    LI::multiset<int> ms(ia, ia + 7);
+    ms.insert(3);
+    std::cout << "multiset: ";
+    for (auto x = ms.begin(); x != ms.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << " count(3): " << ms.count(3) << std::endl;
+    auto r = ms.equal_range(1);
+    std::cout << "equal_range(1): ";
+    for (; r.first != r.second; ++r.first) {
+        std::cout << *r.first << " ";
+    }
+    std::cout << " erase(3): " << ms.erase(3) << " size: " << ms.size() << std::endl;
+
+    // 以已排序且含重复键值的区间直接建树
+    int sorted[] = { 1, 2, 2, 2, 5, 7, 7 };
+    LI::multiset<int> ms2(sorted, sorted + 7, LI::sorted_equivalent_t());
+    std::cout << "sorted multiset: ";
+    for (auto x = ms2.begin(); x != ms2.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << " count(2): " << ms2.count(2) << " count(7): " << ms2.count(7) << std::endl;
+
+    // 节点把手: 改掉键值再插回去
+    LI::multiset<int>::node_type nh = ms.extract(7);
+    nh.value() = 2;
+    ms.insert(LI::move(nh));
+    ms.merge(s); // set 中的元素全部搬到 multiset
+    std::cout << "after merge: ";
+    for (auto x = ms.begin(); x != ms.end(); ++x) {
+        std::cout << *x << " ";
+    }
+    std::cout << " set size: " << s.size() << std::endl;
+
+    // multimap: 同一个键值可以对应多个实值
+    LI::multimap<int, char> mm;
+    mm.insert(LI::pair<const int, char>(1, 'a'));
+    mm.emplace(2, 'b');
+    mm.emplace(1, 'c');
+    mm.emplace(2, 'd');
+    mm.emplace(1, 'e');
+    std::cout << "multimap: ";
+    for (auto x = mm.begin(); x != mm.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << " count(1): " << mm.count(1) << std::endl;
+    mm.erase(mm.find(1));
+    std::cout << "erase first 1: ";
+    for (auto x = mm.begin(); x != mm.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+
+    // 带提示插入相等的键值: 与 std::multimap 相同, 插在离提示位置最近的地方
+    mm.insert(mm.begin(), LI::pair<const int, char>(2, 'x')); // 提示之后的元素都小于 2, 插在所有的 2 之前
+    mm.insert(mm.end(), LI::pair<const int, char>(1, 'y')); // 插在所有的 1 之后
+    LI::multimap<int, char>::iterator d = mm.end();
+    --d;
+    mm.insert(d, LI::pair<const int, char>(2, 'z')); // 插在提示位置之前
+    std::cout << "hinted insert: ";
+    for (auto x = mm.begin(); x != mm.end(); ++x) {
+        std::cout << "(" << x->first << ")" << x->second << " ";
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "li_skiplist.hpp"
+#include "li_map.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef LI::pair<const int, int> value_type;
+
+// 记录存活的对象数, 检查键值已存在时 emplace 构造的元素是否被析构
+struct counted {
+    static int live;
+    int v;
+    counted(int x) : v(x) { ++live; }
+    counted(const counted& other) : v(other.v) { ++live; }
+    ~counted() { --live; }
+};
+int counted::live = 0;
+
+int main(int argc, char const *argv[])
+{
+    // 基本用法: 查找接口与 LI::map 相同, 持有 epoch_guard 时迭代器有效
+    LI::skiplist_map<int, std::string> sl;
+    sl.insert(LI::pair<const int, std::string>(3, "three"));
+    sl.insert(LI::pair<const int, std::string>(1, "one"));
+    sl.try_emplace(2, "two");
+    sl.emplace(5, "five");
+    std::cout << "insert existing: " << sl.insert(LI::pair<const int, std::string>(3, "x")).second
+              << " erase(5): " << sl.erase(5) << " erase(5): " << sl.erase(5) << std::endl;
+    {
+        LI::epoch_guard guard;
+        std::cout << "size " << sl.size() << ": ";
+        for (LI::skiplist_map<int, std::string>::const_iterator it = sl.begin(); it != sl.end(); ++it) {
+            std::cout << it->first << "=" << it->second << " ";
+        }
+        std::cout << std::endl;
+        std::cout << "find(2): " << sl.find(2)->second << " lower_bound(4) == end: " << (sl.lower_bound(4) == sl.end())
+                  << " upper_bound(1): " << sl.upper_bound(1)->first << " count(3): " << sl.count(3) << std::endl;
+    }
+    std::string s;
+    std::cout << "find(1, value): " << sl.find(1, s) << " " << s << std::endl;
+    {
+        LI::skiplist_map<int, counted> cm;
+        for (int i = 0; i < 100; ++i) cm.emplace(i % 10, i);
+        std::cout << "emplace existing: size " << cm.size() << " live " << counted::live;
+    }
+    std::cout << " after destroy " << counted::live << std::endl;
+
+    // 多个线程同时插入删除, 读线程同时查找和遍历: 只会看到 value == key * 2, 遍历总是递增
+    const int writers = 4, readers = 4, keys = 40000;
+    LI::skiplist_map<int, int> shared;
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.push_back(std::thread([&shared, w]() {
+            for (int k = w; k < keys; k += writers) {
+                shared.insert(value_type(k, k * 2));
+            }
+            for (int k = w; k < keys; k += writers * 2) {
+                shared.erase(k);
+            }
+        }));
+    }
+    int bad[readers] = { 0 };
+    for (int r = 0; r < readers; ++r) {
+        threads.push_back(std::thread([&shared, &bad, r]() {
+            for (int round = 0; round < 20; ++round) {
+                for (int k = r; k < keys; k += 97) {
+                    int v;
+                    if (shared.find(k, v) && v != k * 2) ++bad[r];
+                }
+                LI::epoch_guard guard;
+                int prev = -1;
+                for (LI::skiplist_map<int, int>::const_iterator it = shared.begin(); it != shared.end(); ++it) {
+                    if (it->first <= prev || it->second != it->first * 2) ++bad[r];
+                    prev = it->first;
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i) threads[i].join();
+    int bad_total = 0;
+    for (int r = 0; r < readers; ++r) bad_total += bad[r];
+    std::cout << "after threads: size " << shared.size() << " (expect " << keys / 2 << "), bad reads " << bad_total << std::endl;
+
+    // 单线程时与 LI::map 对比 (多线程的伸缩性取决于核数)
+    const int n = 200000;
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = (int) ((i * 2654435761u) % n);
+    auto t0 = std::chrono::steady_clock::now();
+    LI::map<int, int> m;
+    for (int i = 0; i < n; ++i) m.insert(value_type(order[i], i));
+    long hits = 0;
+    for (int i = 0; i < n; ++i) hits += m.count(order[i]);
+    auto t1 = std::chrono::steady_clock::now();
+    LI::skiplist_map<int, int> sm;
+    for (int i = 0; i < n; ++i) sm.insert(value_type(order[i], i));
+    for (int i = 0; i < n; ++i) hits += sm.count(order[i]);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "insert + count " << n << ": map " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms, skiplist_map " << std::chrono::duration<double, std::milli>(t2 - t1).count()
+              << " ms (hits " << hits << ")" << std::endl;
+    return 0;
+}
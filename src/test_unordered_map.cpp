@@ -0,0 +1,72 @@
+#include "li_unordered_map.hpp"
+#include "li_unordered_set.hpp"
+#include "li_map.hpp"
+#include <iostream>
+#include <string>
+
+// 自定义的字符串哈希函数; 哈希值已充分打散, 以 is_avalanching 告诉哈希表不必再打散
+struct string_hash {
+    typedef void is_avalanching;
+    size_t operator()(const std::string& s) const { return LI::__hash_bytes(s.data(), s.size()); }
+};
+
+int main(int argc, char const *argv[])
+{
+    // 基本用法与 map 相同, 但不保持次序
+    LI::unordered_map<std::string, int, string_hash> um;
+    um["jjhou"] = 1;
+    um["jerry"] = 2;
+    um["jason"] = 3;
+    um.insert(LI::pair<const std::string, int>("jimmy", 4));
+    um.emplace("david", 5);
+    um.insert_or_assign("jerry", 20);
+    std::cout << "size: " << um.size() << " bucket_count: " << um.bucket_count()
+              << " load_factor: " << um.load_factor() << std::endl;
+    std::cout << "jerry: " << um.find("jerry")->second << " count(tom): " << um.count("tom") << std::endl;
+
+    // 与 map 逐个比较, 中途边遍历边删除
+    LI::unordered_map<int, int> u;
+    LI::map<int, int> m;
+    unsigned int seed = 1;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int k = (seed >> 8) % 2000;
+        if (i % 3 == 2) {
+            u.erase(k);
+            m.erase(k);
+        }
+        else {
+            u[k] += i;
+            m[k] += i;
+        }
+    }
+    for (auto x = u.begin(); x != u.end(); ) {
+        if (x->first % 5 == 0) {
+            m.erase(x->first);
+            x = u.erase(x);
+        }
+        else {
+            ++x;
+        }
+    }
+    bool same = u.size() == m.size();
+    for (auto y = m.begin(); same && y != m.end(); ++y) {
+        auto x = u.find(y->first);
+        same = x != u.end() && x->second == y->second;
+    }
+    std::cout << "same as map: " << same << " size: " << u.size() << std::endl;
+
+    // 负载因子与预留空间
+    u.max_load_factor(0.5f);
+    std::cout << "max_load_factor 0.5: bucket_count " << u.bucket_count() << " load_factor " << u.load_factor() << std::endl;
+    u.reserve(10000);
+    std::cout << "reserve(10000): bucket_count " << u.bucket_count() << " size " << u.size() << std::endl;
+
+    // unordered_set
+    int ia[] = {5, 1, 3, 3, 9, 1, 7};
+    LI::unordered_set<int> s(ia, ia + 7);
+    s.insert(4);
+    s.erase(9);
+    std::cout << "unordered_set size: " << s.size() << " count(3): " << s.count(3) << " count(9): " << s.count(9) << std::endl;
+    return 0;
+}